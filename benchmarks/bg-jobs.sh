@@ -0,0 +1,100 @@
+#!/usr/bin/env bash
+#
+# How fast is it to start and wait for many background jobs?
+#
+# Usage:
+#   benchmarks/bg-jobs.sh <function name>
+#
+# Example:
+#   benchmarks/bg-jobs.sh compare 1000
+
+set -o nounset
+set -o pipefail
+set -o errexit
+
+# Each function is run by the shell under test, so it only uses POSIX
+# features, plus wait -n.
+
+wait_all() {
+  local n=${1:-1000}
+
+  local i=0
+  while test $i -lt $n; do
+    true &
+    i=$(( i + 1 ))
+  done
+  wait
+}
+
+wait_next() {
+  local n=${1:-1000}
+
+  local i=0
+  while test $i -lt $n; do
+    true &
+    i=$(( i + 1 ))
+  done
+
+  i=0
+  while test $i -lt $n; do
+    wait -n || true
+    i=$(( i + 1 ))
+  done
+}
+
+wait_pids() {
+  local n=${1:-1000}
+
+  local pids=''
+  local i=0
+  while test $i -lt $n; do
+    true &
+    pids="$pids $!"
+    i=$(( i + 1 ))
+  done
+  wait $pids
+}
+
+# Each pipeline is done when its first part exits, which isn't the PID in $!
+wait_next_pipelines() {
+  local n=${1:-1000}
+
+  local i=0
+  while test $i -lt $n; do
+    sleep 0.01 | true &
+    i=$(( i + 1 ))
+  done
+
+  i=0
+  while test $i -lt $n; do
+    wait -n || true
+    i=$(( i + 1 ))
+  done
+  jobs
+}
+
+my_time() {
+  command time -f 'elapsed=%e user=%U sys=%S max_rss_KiB=%M' "$@"
+}
+
+compare() {
+  local n=${1:-1000}
+
+  for sh in bash dash osh; do
+    for func in wait_all wait_next wait_pids wait_next_pipelines; do
+      # dash doesn't have wait -n
+      case $sh:$func in
+        dash:wait_next*)
+          continue
+          ;;
+      esac
+      echo "=== $sh $func $n"
+      my_time $sh $0 $func $n
+    done
+    echo
+  done
+}
+
+. build/dev-shell.sh
+
+"$@"
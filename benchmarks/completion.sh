@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+#
+# How long does file completion take in a big directory?
+#
+# Usage:
+#   benchmarks/completion.sh <function name>
+#
+# Example:
+#   benchmarks/completion.sh compare
+
+set -o nounset
+set -o pipefail
+set -o errexit
+
+readonly BASE_DIR=_tmp/completion
+
+make-dir() {
+  local n=${1:-100000}
+
+  mkdir -p $BASE_DIR/big
+  python3 -c '
+import os, sys
+d, n = sys.argv[1], int(sys.argv[2])
+for i in range(n):
+    open(os.path.join(d, "f%d" % i), "w").close()
+' $BASE_DIR/big $n
+
+  # So the listing can be reused on the first TAB
+  touch -d '2020-01-01' $BASE_DIR/big
+}
+
+# Run by the shell under test.  Each compgen is like hitting TAB again, with
+# one more character typed.
+complete_big_dir() {
+  cd $BASE_DIR/big
+
+  local prefix
+  for prefix in f f1 f12 f123 f1234; do
+    local start end
+    start=$(date +%s%N)
+    compgen -f $prefix > /dev/null
+    end=$(date +%s%N)
+    echo "compgen -f $prefix: $(( (end - start) / 1000000 )) ms"
+  done
+}
+
+compare() {
+  local osh=${1:-_bin/cxx-opt/osh}
+
+  make-dir
+
+  for sh in bash $osh; do
+    echo "=== $sh"
+    $sh $0 complete_big_dir
+    echo
+  done
+}
+
+. build/dev-shell.sh
+
+"$@"
@@ -0,0 +1,58 @@
+#!/usr/bin/env bash
+#
+# How long does it take to start a pipeline, when the shell's heap is big?
+#
+# A fork() of the shell copies the page tables of the whole heap, so pipeline
+# latency grows with heap size.  OSH starts external commands with literal
+# words, like the stages below, with posix_spawn() instead.  Compare it with
+# bash, which forks every stage.
+#
+# Usage:
+#   benchmarks/pipeline-fork.sh <function name>
+#
+# Example:
+#   benchmarks/pipeline-fork.sh compare _bin/cxx-opt/osh
+
+set -o nounset
+set -o pipefail
+set -o errexit
+
+# Run by the shell under test.  Grow the heap with an array of $heap_size
+# strings, then time $n pipelines of 8 external commands.
+
+many_pipelines() {
+  local heap_size=${1:-0}
+  local n=${2:-200}
+
+  local -a big=( $(seq $heap_size) )
+
+  local start end
+  start=$(date +%s%N)
+
+  local i=0
+  while test $i -lt $n; do
+    /bin/true | /bin/true | /bin/true | /bin/true |
+      /bin/true | /bin/true | /bin/true | /bin/true
+    i=$(( i + 1 ))
+  done
+
+  end=$(date +%s%N)
+  echo "${#big[@]} strings: $(( (end - start) / n / 1000 )) us per pipeline"
+}
+
+compare() {
+  local osh=${1:-_bin/cxx-opt/osh}
+  local n=${2:-200}
+
+  for sh in bash $osh; do
+    for heap_size in 0 100000 1000000; do
+      echo -n "$sh: "
+      $sh $0 many_pipelines $heap_size $n
+    done
+    echo
+  done
+}
+
+. build/dev-shell.sh
+
+"$@"
@@ -116,6 +116,48 @@ compare-time() {
   compare time-callback
 }
 
+osh-c-loop() {
+  local osh=$1
+  local n=$2
+
+  for i in $(seq $n); do
+    $osh -c 'echo hi' > /dev/null
+  done
+}
+
+# Start osh -c many times, cold, and then from a zygote started with
+# osh --zygote.  The zygote forks an initialized shell, so it skips option
+# tables, builtins, and default completions.
+#
+# Usage:
+#   benchmarks/startup.sh compare-zygote _bin/cxx-opt/osh 1000
+
+compare-zygote() {
+  local osh=${1:-_bin/cxx-opt/osh}
+  local n=${2:-1000}
+  local sock=_tmp/startup-zygote.sock
+
+  mkdir -p _tmp
+  rm -f $sock
+
+  echo "cold: $n x $osh -c"
+  time osh-c-loop $osh $n
+
+  # The zygote gets its environment from each request
+  env -i $osh --zygote $sock &
+  local zygote_pid=$!
+  for i in $(seq 100); do
+    test -S $sock && break
+    sleep 0.01
+  done
+
+  echo "zygote: $n x $osh -c"
+  time ( export OILS_ZYGOTE_SOCKET=$sock; osh-c-loop $osh $n )
+
+  kill $zygote_pid
+  rm -f $sock
+}
+
 import-stats() {
   # 152 sys calls!  More than bash needs to start up.
   echo json
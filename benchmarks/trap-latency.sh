@@ -0,0 +1,90 @@
+#!/usr/bin/env bash
+#
+# How long is a trap delayed while a builtin is busy with a big file?
+#
+# Usage:
+#   benchmarks/trap-latency.sh <function name>
+#
+# Example:
+#   benchmarks/trap-latency.sh compare
+
+set -o nounset
+set -o pipefail
+set -o errexit
+
+readonly BASE_DIR=_tmp/trap-latency
+
+make-input() {
+  mkdir -p $BASE_DIR
+
+  # 1 MB with no newline or NUL, so read and mapfile see one line
+  head -c 1000000 /dev/zero | tr '\0' x > $BASE_DIR/big.txt
+
+  python3 -c 'import json; print(json.dumps(list(range(200000))))' \
+    > $BASE_DIR/big.json
+}
+
+# Each busy_* function is run by the shell under test.  A background job
+# records when it sends SIGUSR1, and the trap records when it runs.  A regular
+# file never blocks, so the builtin isn't interrupted by EINTR.
+
+send_usr1() {
+  local pid=$1
+
+  sleep 0.1
+  date +%s%N > $BASE_DIR/sent
+  kill -USR1 $pid
+}
+
+busy_read() {
+  trap 'date +%s%N > $BASE_DIR/got' USR1
+  send_usr1 $$ &
+  read -r -d '' line < $BASE_DIR/big.txt || true
+  wait || true  # interrupted by the trap
+}
+
+busy_mapfile() {
+  trap 'date +%s%N > $BASE_DIR/got' USR1
+  send_usr1 $$ &
+  mapfile lines < $BASE_DIR/big.txt
+  wait || true  # interrupted by the trap
+}
+
+busy_json_read() {
+  trap 'date +%s%N > $BASE_DIR/got' USR1
+  send_usr1 $$ &
+  json read < $BASE_DIR/big.json
+  wait || true  # interrupted by the trap
+}
+
+latency() {
+  local sh=$1
+  local func=$2
+
+  rm -f $BASE_DIR/sent $BASE_DIR/got
+  $sh $0 $func
+
+  local sent got
+  sent=$(cat $BASE_DIR/sent)
+  got=$(cat $BASE_DIR/got)
+  echo "$sh $func: trap delayed $(( (got - sent) / 1000000 )) ms"
+}
+
+compare() {
+  make-input
+
+  # If the builtin finishes before the signal is sent, the trap runs in
+  # 'wait', and the delay is small.
+  for sh in bash osh; do
+    for func in busy_read busy_mapfile; do
+      latency $sh $func
+    done
+  done
+
+  # Traps also run while the document is parsed
+  latency osh busy_json_read
+}
+
+. build/dev-shell.sh
+
+"$@"
@@ -144,6 +144,82 @@ with-jq() {
 }
 
 
+readonly STR_FILE=_tmp/compute/strings.json
+
+gen-strings() {
+  ### Write a JSON file that's dominated by strings, like API dumps
+
+  local n=${1:-200000}
+
+  mkdir -p $(dirname $STR_FILE)
+  python3 -c '
+import json, sys
+n = int(sys.argv[1])
+rows = [
+  {"id": i, "name": "user-%d" % i, "email": "user%d@example.com" % i,
+   "bio": "Some text about user %d, with UTF-8 μ and an escape\n" % i}
+  for i in range(n)
+]
+json.dump(rows, sys.stdout, indent=2)
+' $n > $STR_FILE
+
+  ls -l -h $STR_FILE
+}
+
+read-throughput() {
+  ### Print MB/s for 'json read' of the strings file
+
+  # Compare parsers by passing a binary built from another commit
+  local ysh=${1:-$YSH}
+
+  if ! test -f $STR_FILE; then
+    gen-strings
+  fi
+
+  local bytes
+  bytes=$(wc -c < $STR_FILE)
+
+  local start end
+  start=$(date +%s%N)
+  $ysh -c 'json read < $1' dummy $STR_FILE
+  end=$(date +%s%N)
+
+  local elapsed_ms=$(( (end - start) / 1000000 ))
+  echo "$ysh: $bytes bytes in $elapsed_ms ms"
+  python3 -c 'import sys; print("%.1f MB/s" % (int(sys.argv[1]) / 1e3 / max(int(sys.argv[2]), 1)))' \
+    $bytes $elapsed_ms
+}
+
+binary-vs-json() {
+  ### Compare size and round trip time of json8 and json8 --binary
+
+  local ysh=${1:-$YSH}
+
+  if ! test -f $STR_FILE; then
+    gen-strings
+  fi
+
+  local bin_file=_tmp/compute/strings.bin
+
+  # Convert once, and check that it round trips
+  $ysh -c '
+  json read (&x) < $1
+  json8 write --binary (x) > $2
+  json8 read --binary (&y) < $2
+  assert [x === y]
+  ' dummy $STR_FILE $bin_file
+
+  ls -l $STR_FILE $bin_file
+
+  echo '  json8 text'
+  time $ysh -c 'json8 read (&x) < $1; json8 write (x, space=0) > /dev/null' \
+    dummy $STR_FILE
+
+  echo '  json8 --binary'
+  time $ysh -c 'json8 read --binary (&x) < $1; json8 write --binary (x) > /dev/null' \
+    dummy $bin_file
+}
+
 compare() {
   local n=${1:-100}
   local OILS_GC_STATS=${2:-}
@@ -158,7 +158,7 @@ def NinjaGraph(ru):
                  matrix=ninja_lib.COMPILERS_VARIANTS)
 
     oils_matrix = (ninja_lib.COMPILERS_VARIANTS + ninja_lib.GC_PERF_VARIANTS +
-                   ninja_lib.OTHER_VARIANTS)
+                   ninja_lib.OTHER_VARIANTS + ninja_lib.PGO_VARIANTS)
 
     oils_py_inputs = ninja_lib.TryDynamicDeps('bin/oils_for_unix.py')
 
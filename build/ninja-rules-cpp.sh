@@ -171,6 +171,16 @@ setglobal_compile_flags() {
     *+nopool)
       flags="$flags -D NO_POOL_ALLOC"
       ;;
+
+    # Profile-guided optimization with Clang - see build/pgo.sh
+    *+pgogen)
+      flags="$flags -fprofile-generate=$REPO_ROOT/_tmp/pgo/raw"
+      ;;
+    *+pgo)
+      flags="$flags -fprofile-use=$REPO_ROOT/_tmp/pgo/oils.profdata"
+      # Code that the training didn't run, e.g. in other binaries
+      flags="$flags -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date"
+      ;;
   esac
 
   # HAVE_READLINE is from ./configure
@@ -228,6 +238,14 @@ setglobal_link_flags() {
     coverage*)
       variant_flags='-fprofile-instr-generate -fcoverage-mapping'
       ;;
+
+    *+pgogen)
+      variant_flags='-fprofile-generate'
+      ;;
+    *+pgo)
+      # Keep relocations, so llvm-bolt can reorder functions
+      variant_flags='-Wl,--emit-relocs'
+      ;;
   esac
 
   if test -n "$variant_flags"; then
@@ -121,6 +121,13 @@ GC_PERF_VARIANTS = [
     ('cxx', 'opt32'),
 ]
 
+# Built in two steps by build/pgo.sh, so they aren't in the default matrix of
+# other binaries
+PGO_VARIANTS = [
+    ('clang', 'opt+pgogen'),  # instrumented, writes _tmp/pgo/raw
+    ('clang', 'opt+pgo'),  # needs _tmp/pgo/oils.profdata
+]
+
 OTHER_VARIANTS = [
     # Affects mycpp/gc_mops.cc - we can do overflow checking
     ('cxx', 'opt+bigint'),
@@ -0,0 +1,136 @@
+#!/usr/bin/env bash
+#
+# Build oils-for-unix with profile-guided optimization.
+#
+# Usage:
+#   build/pgo.sh <function name>
+#
+# Example:
+#   build/pgo.sh all      # instrument, train, rebuild, compare
+#
+# Steps:
+#   1. _bin/clang-opt+pgogen/oils-for-unix writes raw profiles
+#   2. train runs it on the parser corpus, compute benchmarks, and spec tests
+#   3. _bin/clang-opt+pgo/oils-for-unix is compiled with -fprofile-use
+#   4. (optional) bolt relinks it with llvm-bolt, if that's installed
+#
+# We use Clang because its profile is a single .profdata file.  GCC writes a
+# .gcda file per object, named after the object's path, and the instrumented
+# and optimized objects are in different dirs.
+
+set -o nounset
+set -o pipefail
+set -o errexit
+
+REPO_ROOT=$(cd "$(dirname $0)/.."; pwd)
+
+source build/dev-shell.sh  # llvm-profdata may be in a wedge
+source test/spec-common.sh  # sh-spec
+
+readonly BASE_DIR=_tmp/pgo  # must match build/ninja-rules-cpp.sh
+
+readonly GEN_DIR=_bin/clang-opt+pgogen
+readonly PGO_DIR=_bin/clang-opt+pgo
+
+# Shell-heavy spec tests, so the profile isn't only parsing
+readonly SPEC_SUBSET=(
+  append arith assign builtin-printf command-sub dbracket for-expr
+  here-doc loop redirect var-op-strip word-split ysh-func ysh-json
+)
+
+instrumented() {
+  # train runs the osh and ysh symlinks
+  ninja $GEN_DIR/oils-for-unix $GEN_DIR/osh $GEN_DIR/ysh
+}
+
+train() {
+  local osh=$GEN_DIR/osh
+  local ysh=$GEN_DIR/ysh
+
+  rm -r -f $BASE_DIR/raw
+  mkdir -p $BASE_DIR/raw
+
+  echo '--- parser corpus'
+  for file in $(cat benchmarks/osh-parser-files.txt); do
+    $osh --ast-format none -n $file
+  done
+
+  echo '--- compute benchmarks'
+  $osh benchmarks/compute/fib.sh 200 44 > /dev/null
+  $osh benchmarks/compute/for_loop.sh 50000 > /dev/null
+  $osh benchmarks/compute/control_flow.sh do_return 200 > /dev/null
+  $osh benchmarks/compute/word_freq.sh 10 < configure > /dev/null
+  seq 200 | shuf | $osh benchmarks/compute/bubble_sort.sh int > /dev/null
+  $osh benchmarks/parse-help/pure-excerpt.sh _parse_help - \
+    < benchmarks/parse-help/mypy.txt > /dev/null
+  $ysh benchmarks/compute/fib.ysh 200 44 > /dev/null
+
+  echo '--- spec tests'
+  for name in "${SPEC_SUBSET[@]}"; do
+    # Picks osh or ysh from the file's our_shell.  Failures are OK; we only
+    # want the profile.
+    sh-spec spec/$name.test.sh --oils-bin-dir $PWD/$GEN_DIR > /dev/null ||
+      true
+  done
+
+  # -fprofile-generate=DIR merges the runs of each binary into one .profraw
+  llvm-profdata merge -o $BASE_DIR/oils.profdata $BASE_DIR/raw/*.profraw
+  ls -l $BASE_DIR/oils.profdata
+}
+
+optimized() {
+  # Ninja doesn't know that the objects depend on the profile
+  rm -r -f _build/obj/clang-opt+pgo
+  ninja $PGO_DIR/oils-for-unix
+}
+
+bolt() {
+  ### Optional post-link layout step
+
+  if ! command -v llvm-bolt > /dev/null; then
+    echo 'llvm-bolt not found; skipping'
+    return
+  fi
+
+  local bin=$PGO_DIR/oils-for-unix
+
+  # The binary was linked with --emit-relocs, so BOLT can move functions
+  llvm-bolt $bin -instrument -o $bin.bolt-inst \
+    --instrumentation-file=$PWD/$BASE_DIR/bolt.fdata
+  for file in $(cat benchmarks/osh-parser-files.txt); do
+    $bin.bolt-inst osh --ast-format none -n $file
+  done
+  $bin.bolt-inst osh benchmarks/compute/fib.sh 200 44 > /dev/null
+
+  llvm-bolt $bin -o $bin.bolt -data=$BASE_DIR/bolt.fdata \
+    -reorder-blocks=ext-tsp -reorder-functions=hfsort -split-functions
+  ls -l $bin.bolt
+}
+
+compare() {
+  ### Time the plain and PGO binaries on the same workloads
+
+  ninja _bin/clang-opt/oils-for-unix
+
+  local -a bins=( _bin/clang-opt/oils-for-unix $PGO_DIR/oils-for-unix )
+  if test -f $PGO_DIR/oils-for-unix.bolt; then
+    bins+=( $PGO_DIR/oils-for-unix.bolt )
+  fi
+
+  for bin in "${bins[@]}"; do
+    echo "=== $bin"
+    time $bin osh benchmarks/compute/fib.sh 200 44 > /dev/null
+    time $bin osh --ast-format none -n benchmarks/testdata/configure-coreutils
+    time $bin osh benchmarks/compute/word_freq.sh 10 < configure > /dev/null
+  done
+}
+
+all() {
+  instrumented
+  train
+  optimized
+  bolt
+  compare
+}
+
+"$@"
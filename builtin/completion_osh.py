@@ -22,7 +22,7 @@ _ = log
 from typing import Dict, List, Iterator, cast, TYPE_CHECKING
 if TYPE_CHECKING:
     from _devbuild.gen.runtime_asdl import cmd_value
-    from core.completion import Lookup, OptionState, Api, UserSpec
+    from core.completion import DirCache, Lookup, OptionState, Api, UserSpec
     from frontend.args import _Attributes
     from frontend.parse_lib import ParseContext
     from osh.cmd_eval import CommandEvaluator
@@ -92,6 +92,7 @@ class SpecBuilder(object):
             word_ev,  # type: NormalWordEvaluator
             splitter,  # type: SplitContext
             comp_lookup,  # type: Lookup
+            dir_cache,  # type: DirCache
             help_data,  # type: Dict[str, str]
             errfmt  # type: ui.ErrorFormatter
     ):
@@ -106,6 +107,7 @@ class SpecBuilder(object):
         self.word_ev = word_ev
         self.splitter = splitter
         self.comp_lookup = comp_lookup
+        self.dir_cache = dir_cache  # shared by file and command actions
 
         self.help_data = help_data
         # lazily initialized
@@ -170,19 +172,24 @@ class SpecBuilder(object):
                 actions.append(_DynamicStrDictAction(self.parse_ctx.aliases))
                 actions.append(_DynamicProcDictAction(cmd_ev.procs))
                 actions.append(_FixedWordsAction(consts.OSH_KEYWORD_NAMES))
-                actions.append(completion.FileSystemAction(False, True, False))
+                actions.append(
+                    completion.FileSystemAction(False, True, False,
+                                                self.dir_cache))
 
                 # Look on the file system.
-                a = completion.ExternalCommandAction(cmd_ev.mem)
+                a = completion.ExternalCommandAction(cmd_ev.mem,
+                                                     self.dir_cache)
 
             elif name == 'directory':
-                a = completion.FileSystemAction(True, False, False)
+                a = completion.FileSystemAction(True, False, False,
+                                                self.dir_cache)
 
             elif name == 'export':
                 a = completion.ExportedVarsAction(cmd_ev.mem)
 
             elif name == 'file':
-                a = completion.FileSystemAction(False, False, False)
+                a = completion.FileSystemAction(False, False, False,
+                                                self.dir_cache)
 
             elif name == 'function':
                 a = _DynamicProcDictAction(cmd_ev.procs)
@@ -243,16 +250,19 @@ class SpecBuilder(object):
         extra_actions = []  # type: List[completion.CompletionAction]
         if base_opts.get('plusdirs', False):
             extra_actions.append(
-                completion.FileSystemAction(True, False, False))
+                completion.FileSystemAction(True, False, False,
+                                            self.dir_cache))
 
         # These only happen if there were zero shown.
         else_actions = []  # type: List[completion.CompletionAction]
         if base_opts.get('default', False):
             else_actions.append(
-                completion.FileSystemAction(False, False, False))
+                completion.FileSystemAction(False, False, False,
+                                            self.dir_cache))
         if base_opts.get('dirnames', False):
-            else_actions.append(completion.FileSystemAction(
-                True, False, False))
+            else_actions.append(
+                completion.FileSystemAction(True, False, False,
+                                            self.dir_cache))
 
         if len(actions) == 0 and len(else_actions) == 0:
             raise error.Usage(
@@ -12,6 +12,7 @@ from display import pp_value
 from display import ui
 from core import vm
 from data_lang import j8
+from data_lang import tsv8
 from frontend import match
 from frontend import typed_args
 from mycpp import mops
@@ -163,7 +164,11 @@ class Len(vm._Callable):
                 x = cast(value.Str, UP_x)
                 return num.ToBig(len(x.s))
 
-        raise error.TypeErr(x, 'len() expected Str, List, or Dict',
+            elif case(value_e.Table):
+                x = cast(value.Table, UP_x)
+                return num.ToBig(x.num_rows)
+
+        raise error.TypeErr(x, 'len() expected Str, List, Dict, or Table',
                             rd.BlamePos())
 
 
@@ -624,3 +629,51 @@ class FromJson8(vm._Callable):
                                    rd.LeftParenToken(), props)
 
         return val
+
+
+class ToTsv8(vm._Callable):
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Call(self, rd):
+        # type: (typed_args.Reader) -> value_t
+
+        val = rd.PosValue()
+        rd.Done()
+
+        buf = mylib.BufWriter()
+        try:
+            tsv8.Encode(val, buf)
+        except error.Encode as e:
+            raise error.Structured(_CODEC_STATUS, e.Message(),
+                                   rd.LeftParenToken())
+
+        return value.Str(buf.getvalue())
+
+
+class FromTsv8(vm._Callable):
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Call(self, rd):
+        # type: (typed_args.Reader) -> value_t
+
+        s = rd.PosStr()
+        rd.Done()
+
+        try:
+            val = tsv8.Decode(s)
+        except error.Decode as e:
+            # Like fromJson8()
+            props = {
+                'start_pos': num.ToBig(e.start_pos),
+                'end_pos': num.ToBig(e.end_pos),
+            }  # type: Dict[str, value_t]
+            raise error.Structured(_CODEC_STATUS, e.Message(),
+                                   rd.LeftParenToken(), props)
+
+        return val
@@ -1,34 +1,51 @@
 from __future__ import print_function
 
+from errno import EINTR
+
 from _devbuild.gen import arg_types
 from _devbuild.gen.runtime_asdl import cmd_value
-from _devbuild.gen.syntax_asdl import loc, loc_t
-from _devbuild.gen.value_asdl import value, LeftName
+from _devbuild.gen.syntax_asdl import loc, loc_t, command_t
+from _devbuild.gen.value_asdl import value, value_e, value_t, LeftName
 from builtin import read_osh
 from core import error
 from core.error import e_usage
 from core import pyos
 from core import state
 from core import vm
+from data_lang import bin8
 from data_lang import j8
 from frontend import flag_util
 from frontend import args
 from frontend import typed_args
 from mycpp import mops
 from mycpp import mylib
-from mycpp.mylib import log
+from mycpp.mylib import log, tagswitch
 
 import posix_ as posix
 
-from typing import TYPE_CHECKING
+from typing import cast, List, Optional, TYPE_CHECKING
 if TYPE_CHECKING:
     from display import ui
+    from osh.cmd_eval import CommandEvaluator
 
 _ = log
 
 _JSON_ACTION_ERROR = "builtin expects 'read' or 'write'"
 
 
+class _TrapPoller(j8.Poller):
+    """Run traps while parsing a big document."""
+
+    def __init__(self, cmd_ev):
+        # type: (CommandEvaluator) -> None
+        j8.Poller.__init__(self)
+        self.cmd_ev = cmd_ev
+
+    def Poll(self):
+        # type: () -> None
+        self.cmd_ev.PollSignals()
+
+
 class Json(vm._Builtin):
     """JSON read and write.
 
@@ -36,15 +53,88 @@ class Json(vm._Builtin):
     --indent=2 controls multiline indentation
     """
 
-    def __init__(self, mem, errfmt, is_j8):
-        # type: (state.Mem, ui.ErrorFormatter, bool) -> None
+    def __init__(self, mem, cmd_ev, errfmt, is_j8):
+        # type: (state.Mem, CommandEvaluator, ui.ErrorFormatter, bool) -> None
         self.mem = mem
+        self.cmd_ev = cmd_ev  # for json read --stream { block }
         self.errfmt = errfmt
 
         self.is_j8 = is_j8
         self.name = 'json8' if is_j8 else 'json'  # for error messages
 
         self.stdout_ = mylib.Stdout()
+        self.poller = _TrapPoller(cmd_ev)
+
+    def _ReadStreamLine(self, line, line_num, place, block, blame_loc,
+                        action_loc):
+        # type: (str, int, value.Place, command_t, loc_t, loc_t) -> bool
+        """Returns False if the line can't be decoded."""
+        if len(line.strip()) == 0:  # skip blank lines
+            return True
+
+        p = j8.Parser(line, self.is_j8)
+        try:
+            val = p.ParseValue()
+        except error.Decode as err:
+            err.line_num = line_num  # of the stream, not the value
+            self.errfmt.Print_('%s read: %s' % (self.name, err.Message()),
+                               blame_loc=action_loc)
+            return False
+
+        self.mem.SetPlace(place, val, blame_loc)
+        unused = self.cmd_ev.EvalCommandFrag(block)
+        return True
+
+    def _ReadStream(self, place, block, blame_loc, action_loc):
+        # type: (value.Place, command_t, loc_t, loc_t) -> int
+        """json read --stream (&x) { echo $[x] }
+
+        Parse one value per line, and run the block after each one.  Unlike
+        ReadAll(), memory is bounded by the longest line.
+
+        Like ReadAll(), we read file descriptor 0 directly.  mylib.Stdin() has
+        its own buffer, which may hold the script itself.
+        """
+        chunks = []  # type: List[str]
+        parts = []  # type: List[str]  # of the current line
+        line_num = 0
+        while True:
+            self.cmd_ev.PollSignals()
+            n, err_num = pyos.Read(0, 4096, chunks)
+
+            if n < 0:
+                if err_num == EINTR:
+                    continue  # retry after PollSignals()
+                raise pyos.ReadError(err_num)
+
+            if n == 0:  # EOF, maybe with a last line that has no newline
+                if len(parts):
+                    line_num += 1
+                    if not self._ReadStreamLine(''.join(parts), line_num,
+                                                place, block, blame_loc,
+                                                action_loc):
+                        return 1
+                break
+
+            chunk = chunks.pop()
+            pos = 0
+            while True:
+                nl = chunk.find('\n', pos)
+                if nl == -1:
+                    if pos < len(chunk):
+                        parts.append(chunk[pos:])
+                    break
+
+                parts.append(chunk[pos:nl + 1])
+                line = ''.join(parts)
+                del parts[:]
+                line_num += 1
+                if not self._ReadStreamLine(line, line_num, place, block,
+                                            blame_loc, action_loc):
+                    return 1
+                pos = nl + 1
+
+        return 0
 
     def Run(self, cmd_val):
         # type: (cmd_value.Argv) -> int
@@ -65,6 +155,8 @@ class Json(vm._Builtin):
 
             if not arg_r.AtEnd():
                 e_usage('write got too many args', arg_r.Location())
+            if arg_jw.binary and not self.is_j8:
+                e_usage('write --binary requires json8', action_loc)
 
             rd = typed_args.ReaderForProc(cmd_val)
             val = rd.PosValue()
@@ -79,30 +171,97 @@ class Json(vm._Builtin):
             else:
                 indent = space
 
+            # --compact doesn't build the whole document in memory.  If
+            # there's an error, some output may already be written.
+            stream_out = None  # type: Optional[mylib.Writer]
+            if arg_jw.compact:
+                indent = -1
+                stream_out = self.stdout_
+
             buf = mylib.BufWriter()
             try:
-                if self.is_j8:
-                    j8.PrintMessage(val, buf, indent, type_errors)
+                if arg_jw.binary:
+                    bin8.Encode(val, buf, type_errors)
+                elif self.is_j8:
+                    j8.PrintMessage(val, buf, indent, type_errors,
+                                    stream_out=stream_out)
                 else:
-                    j8.PrintJsonMessage(val, buf, indent, type_errors)
+                    j8.PrintJsonMessage(val, buf, indent, type_errors,
+                                        stream_out=stream_out)
             except error.Encode as e:
                 self.errfmt.PrintMessage(
                     '%s write: %s' % (self.name, e.Message()), action_loc)
                 return 1
 
             self.stdout_.write(buf.getvalue())
-            self.stdout_.write('\n')
+            if not arg_jw.binary:
+                self.stdout_.write('\n')
 
         elif action == 'read':
             attrs = flag_util.Parse('json_read', arg_r)
-            #arg_jr = arg_types.json_read(attrs.attrs)
+            arg_jr = arg_types.json_read(attrs.attrs)
 
+            if arg_jr.binary:
+                if not self.is_j8:
+                    e_usage('read --binary requires json8', action_loc)
+                if arg_jr.stream:
+                    e_usage("read --binary can't be used with --stream",
+                            action_loc)
+
+            if arg_jr.stream:  # json read --stream (&x) { block }
+                if not arg_r.AtEnd():
+                    e_usage('read got too many args', arg_r.Location())
+
+                rd = typed_args.ReaderForProc(cmd_val)
+                opt_place = rd.OptionalPlace()
+                block = rd.RequiredBlockAsFrag()
+                rd.Done()
+
+                if opt_place:
+                    place = opt_place
+                    blame_loc = cmd_val.proc_args.typed_args.left  # type: loc_t
+                else:  # json read --stream { block } sets _reply
+                    blame_loc = cmd_val.arg_locs[0]
+                    place = value.Place(LeftName('_reply', blame_loc),
+                                        self.mem.CurrentFrame())
+                try:
+                    return self._ReadStream(place, block, blame_loc,
+                                            action_loc)
+                except pyos.ReadError as e:
+                    self.errfmt.PrintMessage("read error: %s" %
+                                             posix.strerror(e.err_num))
+                    return 1
+
+            path = None  # type: Optional[List[value_t]]
             if cmd_val.proc_args:  # json read (&x)
                 rd = typed_args.ReaderForProc(cmd_val)
                 place = rd.PosPlace()
+                path = rd.NamedList('path', None)
                 rd.Done()
 
-                blame_loc = cmd_val.proc_args.typed_args.left  # type: loc_t
+                blame_loc = cmd_val.proc_args.typed_args.left
+
+                if path is not None:
+                    if arg_jr.binary:
+                        e_usage("read --binary doesn't accept path=",
+                                action_loc)
+                    for elem in path:
+                        UP_elem = elem
+                        with tagswitch(elem) as case:
+                            if case(value_e.Str):
+                                pass
+                            elif case(value_e.Int):
+                                index = cast(value.Int, UP_elem)
+                                # The input is read in one pass, so we don't
+                                # know where the end of an array is
+                                if mops.Greater(mops.ZERO, index.i):
+                                    raise error.Expr(
+                                        "path indices can't be negative",
+                                        blame_loc)
+                            else:
+                                raise error.TypeErr(
+                                    elem, 'path should contain Str and Int',
+                                    blame_loc)
 
             else:  # json read
                 var_name = '_reply'
@@ -116,7 +275,7 @@ class Json(vm._Builtin):
                 e_usage('read got too many args', arg_r.Location())
 
             try:
-                contents = read_osh.ReadAll()
+                contents = read_osh.ReadAll(self.cmd_ev)
             except pyos.ReadError as e:  # different paths for read -d, etc.
                 # don't quote code since YSH errexit will likely quote
                 self.errfmt.PrintMessage("read error: %s" %
@@ -124,14 +283,27 @@ class Json(vm._Builtin):
                 return 1
 
             p = j8.Parser(contents, self.is_j8)
+            p.poller = self.poller
+            val = None  # type: Optional[value_t]
             try:
-                val = p.ParseValue()
+                if arg_jr.binary:
+                    val = bin8.Decode(contents)
+                elif path is None:
+                    val = p.ParseValue()
+                else:
+                    # Only materialize the selected value
+                    val = p.ParseValueAt(path)
             except error.Decode as err:
                 # TODO: Need to show position info
                 self.errfmt.Print_('%s read: %s' % (self.name, err.Message()),
                                    blame_loc=action_loc)
                 return 1
 
+            if val is None:
+                self.errfmt.Print_('%s read: no value at path' % self.name,
+                                   blame_loc=action_loc)
+                return 1
+
             self.mem.SetPlace(place, val, blame_loc)
 
         else:
@@ -4,16 +4,18 @@ from __future__ import print_function
 
 from _devbuild.gen.syntax_asdl import command_e, BraceGroup, command_t
 from _devbuild.gen.value_asdl import (value, value_t, LiteralBlock, cmd_frag,
-                                      cmd_frag_e)
+                                      cmd_frag_e, Column)
 
+from core import error
 from core import num
 from core import state
 from core import vm
+from data_lang import tsv8
 from display import ui
 from frontend import typed_args
 from mycpp.mylib import log, tagswitch, NewDict
 
-from typing import Dict, Optional, cast
+from typing import Dict, List, Optional, cast
 
 _ = log
 
@@ -118,3 +120,132 @@ class DocComment(vm._Callable):
             return value.Str(doc)
         else:
             return value.Null
+
+
+class TableColumns(vm._Callable):
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Call(self, rd):
+        # type: (typed_args.Reader) -> value_t
+
+        t = rd.PosTable()
+        rd.Done()
+
+        names = []  # type: List[value_t]
+        for col in t.columns:
+            names.append(value.Str(col.name))
+        return value.List(names)
+
+
+def _FindColumn(t, name, rd):
+    # type: (value.Table, str, typed_args.Reader) -> Column
+    col = tsv8.FindColumn(t, name)
+    if col is None:
+        raise error.Expr('Table has no column %r' % name, rd.LeftParenToken())
+    return col
+
+
+class TableColumn(vm._Callable):
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Call(self, rd):
+        # type: (typed_args.Reader) -> value_t
+
+        t = rd.PosTable()
+        name = rd.PosStr()
+        rd.Done()
+
+        col = _FindColumn(t, name, rd)
+        return tsv8.ColumnToList(col, t.num_rows)
+
+
+class TableFilter(vm._Callable):
+    """t => filter('age', '>', 30)"""
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Call(self, rd):
+        # type: (typed_args.Reader) -> value_t
+
+        t = rd.PosTable()
+        name = rd.PosStr()
+        op_str = rd.PosStr()
+        arg = rd.PosValue()
+        rd.Done()
+
+        col = _FindColumn(t, name, rd)
+        op = tsv8.ParseOp(op_str)
+        if op == -1:
+            raise error.Expr(
+                'Expected == != < <= > or >=, got %r' % op_str,
+                rd.LeftParenToken())
+        if not tsv8.CanFilter(col, op, arg):
+            raise error.TypeErr(
+                arg, "Can't compare %s column %r with %s" %
+                (tsv8.ColumnTypeName(col), name, op_str),
+                rd.LeftParenToken())
+
+        return tsv8.Filter(t, col, op, arg)
+
+
+class TableSortBy(vm._Callable):
+    """t => sortBy('age', reverse=true)"""
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Call(self, rd):
+        # type: (typed_args.Reader) -> value_t
+
+        t = rd.PosTable()
+        name = rd.PosStr()
+        reverse = rd.NamedBool('reverse', False)
+        rd.Done()
+
+        col = _FindColumn(t, name, rd)
+        return tsv8.SortBy(t, col, reverse)
+
+
+class TableGroupCount(vm._Callable):
+    """t => groupCount('name')"""
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Call(self, rd):
+        # type: (typed_args.Reader) -> value_t
+
+        t = rd.PosTable()
+        name = rd.PosStr()
+        rd.Done()
+
+        col = _FindColumn(t, name, rd)
+        if name == 'count':
+            raise error.Expr("Can't group by a column named 'count'",
+                             rd.LeftParenToken())
+        return tsv8.GroupCount(t, col)
+
+
+class TableToDict(vm._Callable):
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Call(self, rd):
+        # type: (typed_args.Reader) -> value_t
+
+        t = rd.PosTable()
+        rd.Done()
+
+        return tsv8.TableToDict(t)
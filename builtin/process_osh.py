@@ -15,29 +15,32 @@ from _devbuild.gen import arg_types
 from _devbuild.gen.syntax_asdl import loc, loc_t, CompoundWord
 from _devbuild.gen.runtime_asdl import (cmd_value, job_state_e, wait_status,
                                         wait_status_e)
+from _devbuild.gen.value_asdl import value, value_t
 from core import dev
 from core import error
 from core.error import e_usage, e_die_status
 from core import process  # W1_EXITED, etc.
 from core import pyos
 from core import pyutil
+from core import num
+from core import state
 from core import vm
 from frontend import flag_util
 from frontend import match
 from frontend import signal_def
 from frontend import typed_args
 from frontend import args
+from ysh import val_ops
 from mycpp import mops
 from mycpp import mylib
-from mycpp.mylib import log, tagswitch, print_stderr
+from mycpp.mylib import log, tagswitch, print_stderr, NewDict
 
 import posix_ as posix
 
-from typing import TYPE_CHECKING, List, Tuple, Optional, cast
+from typing import TYPE_CHECKING, Dict, List, Tuple, Optional, cast
 if TYPE_CHECKING:
     from core.process import Waiter, ExternalProgram, FdState
     from core import executor
-    from core import state
     from display import ui
 
 _ = log
@@ -121,6 +124,7 @@ class Fg(vm._Builtin):
         # WaitForOne() -- it's an extension to POSIX that isn't necessary for 'fg'
         job.SetForeground()
         job.state = job_state_e.Running
+        self.job_list.JobStateChanged(job)
 
         status = -1
 
@@ -167,19 +171,89 @@ class Bg(vm._Builtin):
 
 class Fork(vm._Builtin):
 
-    def __init__(self, shell_ex):
-        # type: (vm._Executor) -> None
+    def __init__(self, shell_ex, mem, job_list, waiter):
+        # type: (vm._Executor, state.Mem, process.JobList, Waiter) -> None
         self.shell_ex = shell_ex
+        self.mem = mem
+        self.job_list = job_list
+        self.waiter = waiter
+
+    def _RunPool(self, max_jobs, capture_stdout, cmd_val):
+        # type: (int, bool, cmd_value.Argv) -> int
+        """fork --jobs 4 (items, &results) { echo $1 }"""
+        rd = typed_args.ReaderForProc(cmd_val)
+        items = rd.PosList()
+        place = rd.OptionalPlace()
+        cmd_frag = rd.RequiredBlockAsFrag()
+        rd.Done()
+
+        blame_loc = cmd_val.proc_args.typed_args.left  # type: loc_t
+        if capture_stdout and place is None:
+            e_usage('--capture-stdout expected a place for results',
+                    blame_loc)
+
+        # Stringify them all first, so a bad item doesn't leave jobs running
+        strs = []  # type: List[str]
+        for item in items:
+            strs.append(val_ops.Stringify(item, blame_loc, ''))
+
+        pool = process.JobPool(max_jobs, capture_stdout, self.job_list,
+                               self.waiter)
+        for s in strs:
+            status = pool.WaitUntil(max_jobs - 1)
+            if status != 0:
+                pool.StopReading()
+                return status
+
+            # The child sees $1, like xargs -n 1
+            with state.ctx_Eval(self.mem, None, [s], None):
+                self.shell_ex.RunPoolJob(cmd_frag, pool)
+
+        status = pool.WaitUntil(0)
+        if status != 0:
+            pool.StopReading()
+            return status
+
+        if place is not None:
+            results = []  # type: List[value_t]
+            for i, code in enumerate(pool.statuses):
+                d = NewDict()  # type: Dict[str, value_t]
+                d['status'] = num.ToBig(code)
+                if capture_stdout:
+                    d['stdout'] = value.Str(pool.stdouts[i])
+                results.append(value.Dict(d))
+            self.mem.SetPlace(place, value.List(results), blame_loc)
+
+        # Like wait --all
+        for code in pool.statuses:
+            if code != 0:
+                return 1
+        return 0
 
     def Run(self, cmd_val):
         # type: (cmd_value.Argv) -> int
-        _, arg_r = flag_util.ParseCmdVal('fork',
-                                         cmd_val,
-                                         accept_typed_args=True)
-
-        arg, location = arg_r.Peek2()
-        if arg is not None:
-            e_usage('got unexpected argument %r' % arg, location)
+        attrs, arg_r = flag_util.ParseCmdVal('fork',
+                                             cmd_val,
+                                             accept_typed_args=True)
+        arg = arg_types.fork(attrs.attrs)
+
+        a, location = arg_r.Peek2()
+        if a is not None:
+            e_usage('got unexpected argument %r' % a, location)
+
+        if arg.jobs is not None:
+            max_jobs = 0
+            if match.LooksLikeInteger(arg.jobs):
+                ok, big_int = mops.FromStr2(arg.jobs)
+                if ok and mops.Greater(big_int, mops.ZERO):
+                    max_jobs = mops.BigTruncate(big_int)
+            if max_jobs <= 0:
+                e_usage('--jobs expected a positive number, got %r' % arg.jobs,
+                        loc.Missing)
+            return self._RunPool(max_jobs, arg.capture_stdout, cmd_val)
+
+        if arg.capture_stdout:
+            e_usage('--capture-stdout requires --jobs', loc.Missing)
 
         cmd_frag = typed_args.RequiredBlockAsFrag(cmd_val)
         return self.shell_ex.RunBackgroundJob(cmd_frag)
@@ -372,14 +446,11 @@ class Wait(vm._Builtin):
             target = n - 1
             status = 0
             while self.job_list.NumRunning() > target:
-                result, w1_arg = self.waiter.WaitForOne()
+                result, w1_arg = self.waiter.WaitForOne(interruptible=True)
                 if result == process.W1_EXITED:
                     pid = w1_arg
-                    pr = self.job_list.PopChildProcess(pid)
-                    # TODO: background pipelines don't clean up properly,
-                    # because only the last PID is registered in
-                    # job_list.pid_to_job
                     self.job_list.CleanupWhenProcessExits(pid)
+                    pr = self.job_list.PopChildProcess(pid)
 
                     if pr is None:
                         if self.exec_opts.verbose_warn():
@@ -420,13 +491,11 @@ class Wait(vm._Builtin):
         # Note: NumRunning() makes sure we ignore stopped processes, which
         # cause WaitForOne() to return
         while self.job_list.NumRunning() != 0:
-            result, w1_arg = self.waiter.WaitForOne()
+            result, w1_arg = self.waiter.WaitForOne(interruptible=True)
             if result == process.W1_EXITED:
                 pid = w1_arg
-                pr = self.job_list.PopChildProcess(pid)
-                # TODO: background pipelines don't clean up properly, because
-                # only the last PID is registered in job_list.pid_to_job
                 self.job_list.CleanupWhenProcessExits(pid)
+                pr = self.job_list.PopChildProcess(pid)
 
                 if arg.verbose:
                     self.errfmt.PrintMessage(
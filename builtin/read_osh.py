@@ -117,8 +117,11 @@ def _AppendParts(
 
 
 #
-# Three read() wrappers for 'read' builtin that RunPendingTraps: _ReadN,
-# _ReadPortion, and ReadLineSlowly
+# read() wrappers for the 'read' builtin that RunPendingTraps: _ReadN,
+# _ReadPortion, ReadLineSlowly, and ReadAll.
+#
+# A regular file never blocks, so there's no EINTR.  They also call
+# PollSignals() in their loops, so a big file doesn't delay traps.
 #
 
 
@@ -127,6 +130,7 @@ def _ReadN(fd, num_bytes, cmd_ev):
     chunks = []  # type: List[str]
     bytes_left = num_bytes
     while bytes_left > 0:
+        cmd_ev.PollSignals()
         n, err_num = pyos.Read(fd, bytes_left, chunks)
 
         if n < 0:
@@ -162,6 +166,7 @@ def _ReadPortion(fd, delim_byte, max_chars, allow_escape, cmd_ev):
     while True:
         if max_chars >= 0 and chars_read >= max_chars:
             break
+        cmd_ev.PollSignals()
         ch, err_num = pyos.ReadByte(fd)
         if ch < 0:
             if err_num == EINTR:
@@ -213,6 +218,7 @@ def ReadLineSlowly(cmd_ev, with_eol=True):
     eof = False
     is_first_byte = True
     while True:
+        cmd_ev.PollSignals()
         ch, err_num = pyos.ReadByte(0)
         #log('   ch %d', ch)
 
@@ -241,22 +247,20 @@ def ReadLineSlowly(cmd_ev, with_eol=True):
     return pyutil.ChArrayToString(ch_array), eof
 
 
-def ReadAll():
-    # type: () -> str
+def ReadAll(cmd_ev):
+    # type: (CommandEvaluator) -> str
     """Read all of stdin.
 
     Similar to command sub in core/executor.py.
     """
     chunks = []  # type: List[str]
     while True:
+        cmd_ev.PollSignals()
         n, err_num = pyos.Read(0, 4096, chunks)
 
         if n < 0:
             if err_num == EINTR:
-                # Retry only.  Like read --line (and command sub), read --all
-                # doesn't run traps.  It would be a bit weird to run every 4096
-                # bytes.
-                pass
+                pass  # retry after PollSignals()
             else:
                 raise pyos.ReadError(err_num)
 
@@ -398,7 +402,7 @@ class Read(vm._Builtin):
             status = 1 if eof else 0
 
         elif arg.all:  # read --all
-            contents = ReadAll()
+            contents = ReadAll(self.cmd_ev)
             status = 0
 
         else:
@@ -65,30 +65,8 @@ def ShowDescriptorState(label):
     os.system('ls -l /proc/%d/fd >&2' % pid)
 
 
-def main(argv):
-  p = optparse.OptionParser(__doc__)
-
-  # By default, the server will use the stdin/stdout/stderr of THIS CLIENT
-  # PROCESS.
-  p.add_option(
-      '--stdin-file', dest='stdin_file', default='/dev/stdin',
-      help='Where the server read stdin from')
-  p.add_option(
-      '--stdout-file', dest='stdout_file', default='/dev/stdout',
-      help='Where the server should send child stdout')
-  p.add_option(
-      '--stderr-file', dest='stderr_file', default='/dev/stderr',
-      help='Where the server should send child stdout')
-  p.add_option(
-      '--sh-binary', dest='sh_binary', default='bin/osh',
-      help='Which shell binary to launch')
-
-  # Use a terminal instead
-  p.add_option(
-      '--to-new-pty', dest='to_new_pty', default=False, action='store_true',
-      help='Send the child stdout to a new PTY')
-
-  opts, args = p.parse_args(argv[1:])
+def SpawnServer(opts):
+  """Start osh --headless, and return our end of a socketpair()."""
 
   # left: we read and write from it
   # right: the server we spawn reads and writes.
@@ -126,6 +104,44 @@ def main(argv):
 
     ShowDescriptorState('parent/client AFTER')
 
+  return left
+
+
+def main(argv):
+  p = optparse.OptionParser(__doc__)
+
+  # By default, the server will use the stdin/stdout/stderr of THIS CLIENT
+  # PROCESS.
+  p.add_option(
+      '--stdin-file', dest='stdin_file', default='/dev/stdin',
+      help='Where the server read stdin from')
+  p.add_option(
+      '--stdout-file', dest='stdout_file', default='/dev/stdout',
+      help='Where the server should send child stdout')
+  p.add_option(
+      '--stderr-file', dest='stderr_file', default='/dev/stderr',
+      help='Where the server should send child stdout')
+  p.add_option(
+      '--sh-binary', dest='sh_binary', default='bin/osh',
+      help='Which shell binary to launch')
+
+  p.add_option(
+      '--socket', dest='socket', default=None,
+      help='Connect to a server started with osh --headless --socket PATH')
+
+  # Use a terminal instead
+  p.add_option(
+      '--to-new-pty', dest='to_new_pty', default=False, action='store_true',
+      help='Send the child stdout to a new PTY')
+
+  opts, args = p.parse_args(argv[1:])
+
+  if opts.socket:
+    left = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    left.connect(opts.socket)
+  else:
+    left = SpawnServer(opts)
+
   master_fd, slave_fd = -1, -1
 
   if opts.to_new_pty:
@@ -19,6 +19,23 @@ cpp-demo() {
   echo mystdin | client/headless_demo.py --sh-binary $bin
 }
 
+socket-demo() {
+  local sock=_tmp/oils.sock
+  rm -f $sock
+
+  bin/osh --headless --socket $sock --workers 2 &
+  local server_pid=$!
+  sleep 0.5
+
+  # Two clients, each with its own worker
+  echo mystdin | client/headless_demo.py --socket $sock
+  echo mystdin | client/headless_demo.py --socket $sock
+
+  # The server kills its workers, and removes the socket
+  kill $server_pid
+  wait $server_pid
+}
+
 errors() {
   set +o errexit
 
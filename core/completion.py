@@ -449,14 +449,109 @@ class DynamicWordsAction(CompletionAction):
         f.write('DynamicWordsAction ')
 
 
+def _LowerBound(names, s):
+    # type: (List[str], str) -> int
+    """Return the index of the first name >= s, in a sorted list."""
+    lo = 0
+    hi = len(names)
+    while lo < hi:
+        mid = (lo + hi) // 2
+        if mylib.str_cmp(names[mid], s) < 0:
+            lo = mid + 1
+        else:
+            hi = mid
+    return lo
+
+
+def _WithPrefix(names, prefix):
+    # type: (List[str], str) -> Iterator[str]
+    """Yield the names that start with prefix, in a sorted list."""
+    i = _LowerBound(names, prefix)
+    n = len(names)
+    while i < n:
+        name = names[i]
+        if not name.startswith(prefix):
+            break
+        yield name
+        i += 1
+
+
+class DirCache(object):
+    """Sorted directory listings, shared by completion actions.
+
+    Typing more characters, or hitting TAB again, doesn't list the directory
+    again.  A listing is reused until the directory's mtime changes.
+    """
+
+    def __init__(self, max_dirs=100):
+        # type: (int) -> None
+        self.max_dirs = max_dirs
+
+        # absolute path -> sorted names
+        self.listings = {}  # type: Dict[str, List[str]]
+        # absolute path -> mtime when listed
+        self.mtimes = {}  # type: Dict[str, int]
+
+    def _Forget(self, abs_path):
+        # type: (str) -> None
+        mylib.dict_erase(self.listings, abs_path)
+        mylib.dict_erase(self.mtimes, abs_path)
+
+    def List(self, path):
+        # type: (str) -> Optional[List[str]]
+        """Return the sorted names in a directory, or None if it can't be
+        listed.
+
+        The same List object is returned until the directory changes, so
+        callers can cache what they compute from it.
+        """
+        abs_path = path
+        if not path.startswith('/'):
+            try:
+                abs_path = os_path.join(posix.getcwd(), path)
+            except (IOError, OSError) as e:
+                return None
+
+        try:
+            _, mtime = pyos.MakeDirCacheKey(abs_path)
+        except (IOError, OSError) as e:
+            self._Forget(abs_path)
+            return None
+
+        names = self.listings.get(abs_path)
+        # mtime has a resolution of 1 second.  A listing taken in the same
+        # second the directory changed may miss a later change in that
+        # second, so it isn't reused.
+        if names is not None and self.mtimes[abs_path] == mtime:
+            return names
+
+        try:
+            names = posix.listdir(abs_path)
+        except (IOError, OSError) as e:
+            self._Forget(abs_path)
+            return None
+        names.sort()
+
+        if int(time_.time()) <= mtime:
+            self._Forget(abs_path)  # see above
+            return names
+
+        if len(self.listings) >= self.max_dirs:
+            self.listings.clear()
+            self.mtimes.clear()
+        self.listings[abs_path] = names
+        self.mtimes[abs_path] = mtime
+        return names
+
+
 class FileSystemAction(CompletionAction):
     """Complete paths from the file system.
 
     Directories will have a / suffix.
     """
 
-    def __init__(self, dirs_only, exec_only, add_slash):
-        # type: (bool, bool, bool) -> None
+    def __init__(self, dirs_only, exec_only, add_slash, dir_cache):
+        # type: (bool, bool, bool, DirCache) -> None
         self.dirs_only = dirs_only
         self.exec_only = exec_only
 
@@ -464,6 +559,8 @@ class FileSystemAction(CompletionAction):
         # filenames.
         self.add_slash = add_slash  # for directories
 
+        self.dir_cache = dir_cache
+
     def ActionKind(self):
         # type: () -> comp_action_t
         return comp_action_e.FileSystem
@@ -493,12 +590,11 @@ class FileSystemAction(CompletionAction):
             log('to_list %r' % to_list)
             log('dirname %r' % dirname)
 
-        try:
-            names = posix.listdir(to_list)
-        except (IOError, OSError) as e:
+        names = self.dir_cache.List(to_list)
+        if names is None:
             return  # nothing
 
-        for name in names:
+        for name in _WithPrefix(names, basename):
             path = os_path.join(dirname, name)
 
             if path.startswith(to_complete):
@@ -692,43 +788,60 @@ class ExternalCommandAction(CompletionAction):
     This is PART of compgen -A command.
     """
 
-    def __init__(self, mem):
-        # type: (Mem) -> None
+    def __init__(self, mem, dir_cache):
+        # type: (Mem, DirCache) -> None
         """
         Args:
           mem: for looking up Path
+          dir_cache: listings of the dirs in $PATH, checked for changes on
+            each TAB
         """
         self.mem = mem
-        # Should we list everything executable in $PATH here?  And then whenever
-        # $PATH is changed, regenerated it?
-        # Or we can cache directory listings?  What if the contents of the dir
-        # changed?
-        # Can we look at the dir timestamp?
-        #
-        # (dir, timestamp) -> list of entries perhaps?  And then every time you hit
-        # tab, do you have to check the timestamp?  It should be cached by the
-        # kernel, so yes.
-        # XXX(unused?) self.ext = []
+        self.dir_cache = dir_cache
 
-        # (dir, timestamp) -> list
         # NOTE: This cache assumes that listing a directory is slower than statting
         # it to get the mtime.  That may not be true on all systems?  Either way
         # you are reading blocks of metadata.  But I guess /bin on many systems is
         # huge, and will require lots of sys calls.
-        self.cache = {}  # type: Dict[Tuple[str, int], List[str]]
+
+        # dir -> the listing that self.exes was computed from
+        self.listings = {}  # type: Dict[str, List[str]]
+        # dir -> sorted names of executables
+        self.exes = {}  # type: Dict[str, List[str]]
 
     def Print(self, f):
         # type: (mylib.BufWriter) -> None
 
         f.write('ExternalCommandAction ')
 
+    def _Executables(self, d):
+        # type: (str) -> List[str]
+        """Return the sorted names of executables in a dir."""
+        entries = self.dir_cache.List(d)
+        if entries is None:
+            # There could be a directory that doesn't exist in the $PATH.
+            mylib.dict_erase(self.listings, d)
+            mylib.dict_erase(self.exes, d)
+            return []
+
+        if self.listings.get(d) is entries:  # the dir hasn't changed
+            return self.exes[d]
+
+        dir_exes = []  # type: List[str]
+        for name in entries:
+            path = os_path.join(d, name)
+            # TODO: Handle exception if file gets deleted in between listing and
+            # check?
+            if not posix.access(path, X_OK):
+                continue
+            dir_exes.append(name)  # append the name, not the path
+
+        self.listings[d] = entries
+        self.exes[d] = dir_exes
+        return dir_exes
+
     def Matches(self, comp):
         # type: (Api) -> Iterator[str]
-        """TODO: Cache is never cleared.
-
-        - When we get a newer timestamp, we should clear the old one.
-        - When PATH is changed, we can remove old entries.
-        """
         path_str = self.mem.env_config.Get('PATH')
         if path_str is None:
             # No matches if not a string
@@ -738,34 +851,15 @@ class ExternalCommandAction(CompletionAction):
         path_dirs = path_str.split(':')
         #log('path: %s', path_dirs)
 
-        executables = []  # type: List[str]
-        for d in path_dirs:
-            try:
-                key = pyos.MakeDirCacheKey(d)
-            except (IOError, OSError) as e:
-                # There could be a directory that doesn't exist in the $PATH.
-                continue
-
-            dir_exes = self.cache.get(key)
-            if dir_exes is None:
-                entries = posix.listdir(d)
-                dir_exes = []
-                for name in entries:
-                    path = os_path.join(d, name)
-                    # TODO: Handle exception if file gets deleted in between listing and
-                    # check?
-                    if not posix.access(path, X_OK):
-                        continue
-                    dir_exes.append(name)  # append the name, not the path
-
-                self.cache[key] = dir_exes
-
-            executables.extend(dir_exes)
+        # Forget dirs that were removed from $PATH
+        if len(self.exes) > len(path_dirs):
+            self.listings.clear()
+            self.exes.clear()
 
         # TODO: Shouldn't do the prefix / space thing ourselves.  readline does
         # that at the END of the line.
-        for word in executables:
-            if word.startswith(comp.to_complete):
+        for d in path_dirs:
+            for word in _WithPrefix(self._Executables(d), comp.to_complete):
                 yield word
 
 
@@ -969,6 +1063,7 @@ class RootCompleter(object):
             compopt_state,  # type: OptionState
             comp_ui_state,  # type: State
             parse_ctx,  # type: ParseContext
+            dir_cache,  # type: DirCache
             debug_f,  # type: _DebugFile
     ):
         # type: (...) -> None
@@ -977,6 +1072,7 @@ class RootCompleter(object):
         self.comp_lookup = comp_lookup
         self.compopt_state = compopt_state  # for compopt builtin
         self.comp_ui_state = comp_ui_state
+        self.dir_cache = dir_cache  # for redirect args
 
         self.parse_ctx = parse_ctx
         self.debug_f = debug_f
@@ -1177,7 +1273,8 @@ class RootCompleter(object):
 
                     comp.Update('', val.s, '', 0, [])
                     n = len(val.s)
-                    action = FileSystemAction(False, False, True)
+                    action = FileSystemAction(False, False, True,
+                                              self.dir_cache)
                     for name in action.Matches(comp):
                         yield line_until_tab + ShellQuoteB(name[n:])
                     return
@@ -72,7 +72,8 @@ def _MakeRootCompleter(parse_ctx=None, comp_lookup=None):
 
     ev = test_lib.InitWordEvaluator(exec_opts=exec_opts)
     return completion.RootCompleter(ev, mem, comp_lookup, compopt_state,
-                                    comp_ui_state, parse_ctx, debug_f)
+                                    comp_ui_state, parse_ctx,
+                                    completion.DirCache(), debug_f)
 
 
 class FunctionsTest(unittest.TestCase):
@@ -128,7 +129,7 @@ class CompletionTest(unittest.TestCase):
         parse_opts, exec_opts, mutable_opts = state.MakeOpts(mem, {}, None)
         mem.exec_opts = exec_opts
 
-        a = completion.ExternalCommandAction(mem)
+        a = completion.ExternalCommandAction(mem, completion.DirCache())
         comp = self._CompApi([], 0, 'f')
         print(list(a.Matches(comp)))
 
@@ -142,7 +143,8 @@ class CompletionTest(unittest.TestCase):
             ('opy/doc', ['opy/doc']),
         ]
 
-        a = completion.FileSystemAction(False, False, False)
+        a = completion.FileSystemAction(False, False, False,
+                                        completion.DirCache())
         for prefix, expected in CASES:
             log('')
             log('-- PREFIX %r', prefix)
@@ -173,7 +175,8 @@ class CompletionTest(unittest.TestCase):
             ('./o', ['./oils-version.txt', './opy/', './osh/']),
         ]
 
-        a = completion.FileSystemAction(False, False, True)
+        a = completion.FileSystemAction(False, False, True,
+                                        completion.DirCache())
         for prefix, expected in ADD_SLASH_CASES:
             log('')
             log('-- PREFIX %s', prefix)
@@ -187,13 +190,38 @@ class CompletionTest(unittest.TestCase):
 
         EXEC_ONLY_CASES = [('i', ['install'])]
 
-        a = completion.FileSystemAction(False, True, False)
+        a = completion.FileSystemAction(False, True, False,
+                                        completion.DirCache())
         for prefix, expected in EXEC_ONLY_CASES:
             log('')
             log('-- PREFIX %s', prefix)
             comp = self._CompApi([], 0, prefix)
             self.assertEqual(expected, sorted(a.Matches(comp)))
 
+    def testDirCache(self):
+        d = '/tmp/oil_dir_cache_test'
+        os.system('rm -rf %s; mkdir -p %s' % (d, d))
+        for name in ['b', 'a', 'ab']:
+            open(os.path.join(d, name), 'w').close()
+        # So the listing isn't taken in the same second as the last change
+        os.utime(d, (0, 0))
+
+        cache = completion.DirCache()
+        names = cache.List(d)
+        self.assertEqual(['a', 'ab', 'b'], names)
+        self.assertEqual(['a', 'ab'], list(completion._WithPrefix(names,
+                                                                  'a')))
+        self.assertEqual([], list(completion._WithPrefix(names, 'c')))
+
+        # Reused while the dir is unchanged
+        self.assertTrue(cache.List(d) is names)
+
+        # Listed again after it changes
+        open(os.path.join(d, 'c'), 'w').close()
+        self.assertEqual(['a', 'ab', 'b', 'c'], cache.List(d))
+
+        self.assertEqual(None, cache.List(d + '/nonexistent'))
+
     def testShellFuncExecution(self):
         arena = test_lib.MakeArena('testShellFuncExecution')
         c_parser = test_lib.InitCommandParser("""\
@@ -5,7 +5,7 @@ from errno import EINTR
 
 from _devbuild.gen.id_kind_asdl import Id
 from _devbuild.gen.option_asdl import builtin_i, builtin_t
-from _devbuild.gen.runtime_asdl import RedirValue, trace
+from _devbuild.gen.runtime_asdl import RedirValue, cmd_value, trace
 from _devbuild.gen.syntax_asdl import (
     command,
     command_e,
@@ -13,6 +13,7 @@ from _devbuild.gen.syntax_asdl import (
     CompoundWord,
     loc,
     loc_t,
+    word_e,
     word_t,
 )
 from builtin import hay_ysh
@@ -28,6 +29,7 @@ from frontend import consts
 from frontend import lexer
 from mycpp import mylib
 from mycpp.mylib import str_switch, log, print_stderr
+from osh import word_
 from pylib import os_path
 from pylib import path_stat
 
@@ -36,8 +38,7 @@ from posix_ import X_OK  # translated directly to C macro
 
 from typing import cast, Dict, List, Tuple, Optional, TYPE_CHECKING
 if TYPE_CHECKING:
-    from _devbuild.gen.runtime_asdl import (cmd_value, CommandStatus,
-                                            StatusArray)
+    from _devbuild.gen.runtime_asdl import CommandStatus, StatusArray
     from _devbuild.gen.syntax_asdl import command_t
     from builtin import trap_osh
     from core import optview
@@ -254,6 +255,16 @@ class SearchPath(object):
             self.cache[name] = full_path
         return full_path
 
+    def LookupWithoutCaching(self, name):
+        # type: (str) -> Optional[str]
+        """For a pipeline part resolved in the shell, not a forked child.
+
+        Like bash, running 'ls | wc' doesn't add 'ls' to the hash table.
+        """
+        if name in self.cache:
+            return self.cache[name]
+        return self.LookupOne(name)
+
     def MaybeRemoveEntry(self, name):
         # type: (str) -> None
         """When the file system changes."""
@@ -370,6 +381,13 @@ class PureExecutor(vm._Executor):
             "Background jobs aren't allowed in pure mode (OILS-ERR-204)",
             loc.Command(node))
 
+    def RunPoolJob(self, node, pool):
+        # type: (command_t, process.JobPool) -> int
+        raise error.Structured(
+            _PURITY_STATUS,
+            "Background jobs aren't allowed in pure mode (OILS-ERR-204)",
+            loc.Command(node))
+
     def RunPipeline(self, node, status_out):
         # type: (command.Pipeline, CommandStatus) -> None
         raise error.Structured(
@@ -514,6 +532,68 @@ class ShellExecutor(vm._Executor):
                             self.tracer)
         return p
 
+    def _MaybeMakeExternalProcess(self, node):
+        # type: (command_t) -> Optional[process.Process]
+        """For a pipeline part like 'sort -n' or 'grep foo'.
+
+        If it's an external command with literal words, then evaluate it here,
+        so the process can be started with posix_spawn() rather than fork().
+        Returns None if it must be run in a forked shell.
+        """
+        UP_node = node
+        if node.tag() != command_e.Simple:
+            return None
+
+        # The child would print xtrace, or run traps and hooks
+        if (self.exec_opts.xtrace() or self.exec_opts._running_hay() or
+                self.trap_state.ThisProcessHasTraps()):
+            return None
+
+        node = cast(command.Simple, UP_node)
+        if (len(node.more_env) or node.typed_args or node.block or
+                node.redirects is not None):
+            return None
+
+        argv = []  # type: List[str]
+        arg_locs = []  # type: List[CompoundWord]
+        for UP_w in node.words:
+            if UP_w.tag() != word_e.Compound:
+                return None
+            w = cast(CompoundWord, UP_w)
+            s = word_.LiteralArgStr(w)
+            if s is None:
+                return None
+            argv.append(s)
+            arg_locs.append(w)
+
+        # Same order as _RunSimpleCommand()
+        arg0 = argv[0]
+        if (consts.LookupAssignBuiltin(arg0) != consts.NO_INDEX or
+                consts.LookupSpecialBuiltin(arg0) != consts.NO_INDEX):
+            return None
+        proc_val, self_obj = self.procs.GetInvokable(arg0)
+        if proc_val is not None:
+            return None
+        if self.hay_state.Resolve(arg0):
+            return None
+        if consts.LookupNormalBuiltin(arg0) != consts.NO_INDEX:
+            return None
+        if (self.exec_opts.rewrite_extern() and
+                not self.exec_opts.interactive() and
+                _RewriteExternToBuiltin(argv) != consts.NO_INDEX):
+            return None
+
+        # Errors like 'command not found' are printed by the forked shell
+        argv0_path = self.search_path.LookupWithoutCaching(arg0)
+        if argv0_path is None:
+            return None
+
+        cmd_val = cmd_value.Argv(argv, arg_locs, True, None, None)
+        thunk = process.ExternalThunk(self.ext_prog, argv0_path, cmd_val,
+                                      self.mem.GetEnv())
+        return process.Process(thunk, self.job_control, self.job_list,
+                               self.tracer)
+
     def _RunSimpleCommand(self, arg0, arg0_loc, cmd_val, cmd_st, run_flags):
         # type: (str, loc_t, cmd_value.Argv, CommandStatus, int) -> int
         """Run builtins, functions, external commands.
@@ -702,6 +782,23 @@ class ShellExecutor(vm._Executor):
 
         return 0
 
+    def RunPoolJob(self, node, pool):
+        # type: (command_t, process.JobPool) -> int
+        """For fork --jobs N.  Like RunBackgroundJob(), but the pool owns the
+        job."""
+        p = self._MakeProcess(node, True, self.exec_opts.errtrace())
+        if self.job_control.Enabled():
+            p.AddStateChange(process.SetPgid(process.OWN_LEADER, self.tracer))
+
+        job_id = pool.Start(p)
+        self.mem.last_bg_pid = p.PidForWait()  # for $!
+
+        if self.exec_opts.interactive():
+            print_stderr('[%%%d] PID %d Started' %
+                         (job_id, self.mem.last_bg_pid))
+
+        return 0
+
     def RunPipeline(self, node, status_out):
         # type: (command.Pipeline, CommandStatus) -> None
 
@@ -719,7 +816,9 @@ class ShellExecutor(vm._Executor):
             # TODO: determine these locations at parse time?
             pipe_locs.append(loc.Command(child))
 
-            p = self._MakeProcess(child, True, self.exec_opts.errtrace())
+            p = self._MaybeMakeExternalProcess(child)
+            if p is None:
+                p = self._MakeProcess(child, True, self.exec_opts.errtrace())
             p.Init_ParentPipeline(pi)
             pi.Add(p)
 
@@ -806,35 +905,12 @@ class ShellExecutor(vm._Executor):
         stderr_chunks = []  # type: List[str]
         posix.close(w)  # not going to write
         posix.close(w2)  # not going to write
-        open_fds = [stdout_fd, stderr_fd]
-        while True:
-            fds = pyos.WaitForReading(open_fds)
-
-            # zero outputs mean something went wrong
-            if len(fds) == 0:
-                break
-
-            for fd in fds:
-                if fd == stdout_fd:
-                    n, err_num = pyos.Read(fd, 4096, stdout_chunks)
-                else:
-                    n, err_num = pyos.Read(fd, 4096, stderr_chunks)
-                if n < 0:
-                    if err_num == EINTR:
-                        pass  # retry
-                    else:
-                        # Like the top level IOError handler
-                        e_die_status(
-                            2, 'Oils I/O error (read): %s' %
-                            posix.strerror(err_num))
-                elif n == 0:  # EOF
-                    open_fds.remove(fd)
-
-            if len(open_fds) == 0:
-                break
 
-        posix.close(stdout_fd)
-        posix.close(stderr_fd)
+        reader = process.PipeReader()
+        reader.Add(stdout_fd, stdout_chunks)
+        reader.Add(stderr_fd, stderr_chunks)
+        while reader.NumOpen():
+            reader.ReadReady()  # retry if a signal interrupted it
 
         status = p.Wait(self.waiter)
         stdout_str = ''.join(stdout_chunks)
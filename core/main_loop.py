@@ -6,28 +6,46 @@ Variants:
   main_loop.Headless()       calls Batch() like eval and source.
                                    We want 'echo 1\necho 2\n' to work, so we
                                    don't bother with "the PS2 problem".
+  main_loop.Zygote()         forks a shell that calls Batch(), per request.
   main_loop.ParseWholeFile() calls ParseLogicalLine().  Used by osh -n.
 """
 from __future__ import print_function
 
+from errno import EINTR
+from resource import (RLIMIT_AS, RLIMIT_CORE, RLIMIT_CPU, RLIMIT_DATA,
+                      RLIMIT_FSIZE, RLIMIT_NOFILE, RLIMIT_STACK)
+from signal import (SIG_DFL, SIG_IGN, SIGALRM, SIGCHLD, SIGHUP, SIGINT,
+                    SIGKILL, SIGPIPE, SIGQUIT, SIGTERM, SIGTSTP, SIGTTIN,
+                    SIGTTOU, SIGUSR1, SIGUSR2)
+
 from _devbuild.gen import arg_types
 from _devbuild.gen.syntax_asdl import (command, command_t, parse_result,
                                        parse_result_e, source)
+from _devbuild.gen.value_asdl import value, value_e, value_t
 from core import alloc
 from core import error
 from core import process
+from core import pyos
+from core import pyutil
+from core import sh_init
 from core import state
 from core import util
+from data_lang import j8
 from display import ui
 from frontend import reader
 from osh import cmd_eval
+from mycpp import iolib
+from mycpp import mops
 from mycpp import mylib
-from mycpp.mylib import log, print_stderr, probe, tagswitch
+from mycpp.mylib import NewDict, iteritems, log, print_stderr, probe, tagswitch
 
 import fanos
+import fcntl as fcntl_
 import posix_ as posix
+from posix_ import F_DUPFD_CLOEXEC, WNOHANG
+import time as time_
 
-from typing import cast, Any, List, Tuple, TYPE_CHECKING
+from typing import cast, Any, Dict, List, Optional, Tuple, TYPE_CHECKING
 if TYPE_CHECKING:
     from core.comp_ui import _IDisplay
     from core import process
@@ -99,6 +117,26 @@ def ShowDescriptorState(label):
         time.sleep(0.01)  # prevent interleaving
 
 
+def _ServerShouldStop(signal_safe):
+    # type: (iolib.SignalSafe) -> bool
+    """Did the headless or zygote server get a signal to exit?"""
+    stop = False
+    sig_nums = signal_safe.TakePendingSignals()
+    for sig_num in sig_nums:
+        if sig_num == SIGHUP or sig_num == SIGINT or sig_num == SIGTERM:
+            stop = True
+    del sig_nums[:]
+    signal_safe.ReuseEmptyList(sig_nums)
+    return stop
+
+
+def _ResetServerSignals():
+    # type: () -> None
+    """In a forked worker or monitor, undo Serve()'s handlers."""
+    iolib.sigaction(SIGHUP, SIG_DFL)
+    iolib.sigaction(SIGTERM, SIG_DFL)
+
+
 class Headless(object):
     """Main loop for headless mode."""
 
@@ -108,14 +146,92 @@ class Headless(object):
         self.parse_ctx = parse_ctx
         self.errfmt = errfmt
 
+        # The client is on stdin and stdout, unless we're a socket worker
+        self.in_fd = 0
+        self.out_fd = 1
+
     def Loop(self):
         # type: () -> int
         try:
             return self._Loop()
         except ValueError as e:
-            fanos.send(1, 'ERROR %s' % e)
+            fanos.send(self.out_fd, 'ERROR %s' % e)
             return 1
 
+    def _Worker(self, listen_fd):
+        # type: (int) -> int
+        """Serve one client session, in a forked worker."""
+        _ResetServerSignals()
+        # The server's handler.  Our own 'wait' installs its own.
+        iolib.sigaction(SIGCHLD, SIG_DFL)
+
+        conn_fd = -1
+        while conn_fd < 0:
+            try:
+                conn_fd = fanos.accept(listen_fd)
+            except (IOError, OSError) as e:
+                # e.g. EMFILE.  If we exited, the server would fork us again
+                # right away.
+                print_stderr('headless: accept() failed: %s' %
+                             pyutil.strerror(e))
+                time_.sleep(1.0)
+        posix.close(listen_fd)
+
+        # Descriptors 0-9 are the user's, e.g. for 'exec 3>out'
+        fd = fcntl_.fcntl(conn_fd, F_DUPFD_CLOEXEC, 10)  # type: int
+        posix.close(conn_fd)
+
+        self.in_fd = fd
+        self.out_fd = fd
+        return self.Loop()
+
+    def Serve(self, listen_fd, sock_path, num_workers):
+        # type: (int, str, int) -> int
+        """Serve many clients on a Unix socket, with a pool of workers.
+
+        Each worker is forked after rc files are sourced, and waits in
+        accept().  It serves one client session, then exits, so sessions don't
+        share state.  We fork a new worker to replace it, so a new client gets
+        an initialized shell without waiting for startup.
+
+        On SIGHUP, SIGINT, or SIGTERM, we kill the workers, and remove the
+        socket at sock_path.
+
+        Returns in both the parent and workers, like Loop().
+        """
+        signal_safe = self.cmd_ev.signal_safe
+        iolib.RegisterSignalInterest(SIGHUP)
+        iolib.RegisterSignalInterest(SIGTERM)
+        wakeup_fd = iolib.OpenWakeupFd()
+
+        workers = {}  # type: Dict[int, bool]
+        while True:
+            while len(workers) < num_workers:
+                pid = posix.fork()
+                if pid == 0:  # child
+                    return self._Worker(listen_fd)
+                workers[pid] = True
+
+            iolib.DrainWakeupFd(wakeup_fd)  # before waitpid(), so no race
+            if _ServerShouldStop(signal_safe):
+                break
+
+            num_reaped = 0
+            while True:
+                pid, unused_status = pyos.WaitPid(WNOHANG)
+                if pid <= 0:
+                    break
+                mylib.dict_erase(workers, pid)
+                num_reaped += 1
+            if num_reaped == 0:
+                pyos.WaitForReading([wakeup_fd])
+
+        for pid in workers.keys():
+            posix.kill(pid, SIGTERM)
+        posix.close(listen_fd)
+        pyos.Unlink(sock_path)
+        return 0
+
     def EVAL(self, arg):
         # type: (str) -> str
 
@@ -141,7 +257,7 @@ class Headless(object):
         fd_out = []  # type: List[int]
         while True:
             try:
-                blob = fanos.recv(0, fd_out)
+                blob = fanos.recv(self.in_fd, fd_out)
             except ValueError as e:
                 fanos_log('protocol error: %s' % e)
                 raise  # higher level handles it
@@ -186,12 +302,421 @@ class Headless(object):
                 fanos_log('Invalid command %r' % command)
                 raise ValueError('Invalid command %r' % command)
 
-            fanos.send(1, b'OK %s' % reply)
+            fanos.send(self.out_fd, b'OK %s' % reply)
             del fd_out[:]  # reset for next iteration
 
         return 0
 
 
+# A forked shell would get these from the zygote rather than the client, so
+# they're sent with each request.  The resources are the ones 'ulimit' shows.
+ZYGOTE_RLIMITS = [
+    RLIMIT_CORE, RLIMIT_DATA, RLIMIT_FSIZE, RLIMIT_NOFILE, RLIMIT_STACK,
+    RLIMIT_CPU, RLIMIT_AS
+]
+
+# Signals that a shell inherits as ignored, or not.  osh -c handles SIGINT and
+# SIGWINCH itself.
+ZYGOTE_SIGNALS = [
+    SIGHUP, SIGQUIT, SIGPIPE, SIGTERM, SIGALRM, SIGUSR1, SIGUSR2, SIGTSTP,
+    SIGTTIN, SIGTTOU
+]
+
+# Signals that the client forwards to the shell, unless they're ignored
+ZYGOTE_FORWARDED = [SIGHUP, SIGINT, SIGQUIT, SIGTERM, SIGUSR1, SIGUSR2]
+
+
+class ZygoteRequest(object):
+    """A request to run 'osh -c', which is sent to a zygote as J8.
+
+    The client's stdin, stdout, and stderr are sent along with it.
+    """
+
+    def __init__(
+            self,
+            lang,  # type: str
+            bash_compat,  # type: bool
+            cmd,  # type: str
+            argv0,  # type: str
+            argv,  # type: List[str]
+            environ,  # type: Dict[str, str]
+            cwd,  # type: str
+            ppid,  # type: int
+            umask,  # type: int
+            rlimits,  # type: List[Tuple[int, mops.BigInt, mops.BigInt]]
+            ignored_signals,  # type: List[int]
+    ):
+        # type: (...) -> None
+        self.lang = lang
+        self.bash_compat = bash_compat
+        self.cmd = cmd  # the -c argument
+        self.argv0 = argv0  # $0 if argv is empty
+        self.argv = argv  # [$0, $1, ...] after the -c argument
+        self.environ = environ
+        self.cwd = cwd
+        self.ppid = ppid
+        self.umask = umask
+        self.rlimits = rlimits  # (resource, soft, hard)
+        self.ignored_signals = ignored_signals  # among ZYGOTE_SIGNALS
+
+    def Encode(self):
+        # type: () -> str
+        argv = [value.Str(a) for a in self.argv]  # type: List[value_t]
+        environ = NewDict()  # type: Dict[str, value_t]
+        for name, s in iteritems(self.environ):
+            environ[name] = value.Str(s)
+
+        d = NewDict()  # type: Dict[str, value_t]
+        d['lang'] = value.Str(self.lang)
+        d['bash_compat'] = value.Bool(self.bash_compat)
+        d['cmd'] = value.Str(self.cmd)
+        d['argv0'] = value.Str(self.argv0)
+        d['argv'] = value.List(argv)
+        d['environ'] = value.Dict(environ)
+        d['cwd'] = value.Str(self.cwd)
+        d['ppid'] = value.Int(mops.IntWiden(self.ppid))
+        d['umask'] = value.Int(mops.IntWiden(self.umask))
+
+        rlimits = []  # type: List[value_t]
+        for res, soft, hard in self.rlimits:
+            triple = [value.Int(mops.IntWiden(res)),
+                      value.Int(soft),
+                      value.Int(hard)]  # type: List[value_t]
+            rlimits.append(value.List(triple))
+        d['rlimits'] = value.List(rlimits)
+
+        ignored = []  # type: List[value_t]
+        for sig_num in self.ignored_signals:
+            ignored.append(value.Int(mops.IntWiden(sig_num)))
+        d['ignored_signals'] = value.List(ignored)
+
+        buf = mylib.BufWriter()
+        j8.PrintMessage(value.Dict(d), buf, -1, True)
+        return buf.getvalue()
+
+
+def _ReqField(d, name, tag):
+    # type: (Dict[str, value_t], str, int) -> value_t
+    val = d.get(name)
+    if val is None or val.tag() != tag:
+        raise ValueError('Invalid zygote request field %r' % name)
+    return val
+
+
+def _ReqStr(d, name):
+    # type: (Dict[str, value_t], str) -> str
+    return cast(value.Str, _ReqField(d, name, value_e.Str)).s
+
+
+def _StrList(val):
+    # type: (value_t) -> List[str]
+    items = cast(value.List, val).items
+    result = []  # type: List[str]
+    for item in items:
+        if item.tag() != value_e.Str:
+            raise ValueError('Expected list of strings in zygote request')
+        result.append(cast(value.Str, item).s)
+    return result
+
+
+def _IntList(val):
+    # type: (value_t) -> List[mops.BigInt]
+    if val.tag() != value_e.List:
+        raise ValueError('Expected list of integers in zygote request')
+    result = []  # type: List[mops.BigInt]
+    for item in cast(value.List, val).items:
+        if item.tag() != value_e.Int:
+            raise ValueError('Expected list of integers in zygote request')
+        result.append(cast(value.Int, item).i)
+    return result
+
+
+def _ReqInt(d, name):
+    # type: (Dict[str, value_t], str) -> int
+    return mops.BigTruncate(
+        cast(value.Int, _ReqField(d, name, value_e.Int)).i)
+
+
+def DecodeZygoteRequest(blob):
+    # type: (str) -> ZygoteRequest
+    """Raises ValueError or error.Decode."""
+    val = j8.Parser(blob, True).ParseValue()
+    if val.tag() != value_e.Dict:
+        raise ValueError('Expected zygote request to be a Dict')
+    d = cast(value.Dict, val).d
+
+    environ = NewDict()  # type: Dict[str, str]
+    env_val = cast(value.Dict, _ReqField(d, 'environ', value_e.Dict))
+    for name, v in iteritems(env_val.d):
+        if v.tag() != value_e.Str:
+            raise ValueError('Expected environ to contain strings')
+        environ[name] = cast(value.Str, v).s
+
+    rlimits = []  # type: List[Tuple[int, mops.BigInt, mops.BigInt]]
+    rlimits_val = cast(value.List, _ReqField(d, 'rlimits', value_e.List))
+    for item in rlimits_val.items:
+        nums = _IntList(item)
+        if len(nums) != 3:
+            raise ValueError('Expected [resource, soft, hard] in rlimits')
+        rlimits.append((mops.BigTruncate(nums[0]), nums[1], nums[2]))
+
+    ignored_signals = []  # type: List[int]
+    for n in _IntList(_ReqField(d, 'ignored_signals', value_e.List)):
+        ignored_signals.append(mops.BigTruncate(n))
+
+    return ZygoteRequest(
+        _ReqStr(d, 'lang'),
+        cast(value.Bool, _ReqField(d, 'bash_compat', value_e.Bool)).b,
+        _ReqStr(d, 'cmd'), _ReqStr(d, 'argv0'),
+        _StrList(_ReqField(d, 'argv', value_e.List)), environ,
+        _ReqStr(d, 'cwd'), _ReqInt(d, 'ppid'), _ReqInt(d, 'umask'), rlimits,
+        ignored_signals)
+
+
+class Zygote(object):
+    """Serve 'osh -c' requests by forking an initialized shell.
+
+    Startup builds option tables, builtins, and default completions.  A
+    zygote does that once, then forks a shell for each request, which only has
+    to set up argv, the environment, and the working directory.
+    """
+
+    def __init__(
+            self,
+            lang,  # type: str
+            bash_compat,  # type: bool
+            cmd_ev,  # type: cmd_eval.CommandEvaluator
+            parse_ctx,  # type: parse_lib.ParseContext
+            errfmt,  # type: ui.ErrorFormatter
+            mem,  # type: state.Mem
+            mutable_opts,  # type: state.MutableOpts
+    ):
+        # type: (...) -> None
+        self.lang = lang
+        self.bash_compat = bash_compat
+        self.cmd_ev = cmd_ev
+        self.parse_ctx = parse_ctx
+        self.errfmt = errfmt
+        self.mem = mem
+        self.mutable_opts = mutable_opts
+
+    def Serve(self, listen_fd, sock_path):
+        # type: (int, str) -> int
+        """Accept connections until there's an error, or a signal.
+
+        Each connection is handled by a forked monitor process, which forks
+        the shell that runs the request, waits for it, and replies with
+        'OK <status>'.  The shell may exec, or be killed, so it can't reply
+        itself.
+
+        While the shell runs, the client sends 'SIG <number>' for each signal
+        it receives, which the monitor sends to the shell.  If the client goes
+        away, the monitor kills the shell, as if it had been killed along with
+        the client.
+
+        On SIGHUP, SIGINT, or SIGTERM, we remove the socket at sock_path.
+        Running monitors and shells finish their requests.
+
+        Returns in the server, the monitors, and the shells, like
+        Headless.Serve().
+        """
+        signal_safe = self.cmd_ev.signal_safe
+        iolib.RegisterSignalInterest(SIGHUP)
+        iolib.RegisterSignalInterest(SIGTERM)
+        wakeup_fd = iolib.OpenWakeupFd()
+
+        status = 0
+        while True:
+            iolib.DrainWakeupFd(wakeup_fd)  # before polling, so no race
+            if _ServerShouldStop(signal_safe):
+                break
+
+            # Reap monitors that have finished
+            while True:
+                pid, unused_status = pyos.WaitPid(WNOHANG)
+                if pid <= 0:
+                    break
+
+            # accept() would block signals, since it retries on EINTR
+            ready = pyos.WaitForReading([listen_fd, wakeup_fd])
+            if listen_fd not in ready:
+                continue
+
+            try:
+                conn_fd = fanos.accept(listen_fd)
+            except (IOError, OSError) as e:
+                print_stderr('%s: zygote accept() failed: %s' %
+                             (self.lang, pyutil.strerror(e)))
+                status = 1
+                break
+
+            pid = posix.fork()
+            if pid == 0:  # monitor
+                posix.close(listen_fd)
+                _ResetServerSignals()
+                return self._Monitor(conn_fd)
+            posix.close(conn_fd)
+
+        posix.close(listen_fd)
+        pyos.Unlink(sock_path)
+        return status
+
+    def _Monitor(self, conn_fd):
+        # type: (int) -> int
+        fd_out = []  # type: List[int]
+        try:
+            blob = fanos.recv(conn_fd, fd_out)
+            if blob is None:
+                return 1  # client went away
+            if len(fd_out) != 3 or fd_out[0] == -1:
+                raise ValueError('Expected 3 file descriptors')
+            req = DecodeZygoteRequest(blob)
+            if req.lang != self.lang or req.bash_compat != self.bash_compat:
+                raise ValueError('Zygote is running %s' % self.lang)
+        except ValueError as e:
+            fanos.send(conn_fd, 'ERROR %s' % e)
+            return 1
+        except error.Decode as e:
+            fanos.send(conn_fd, 'ERROR %s' % e.Message())
+            return 1
+
+        # Open it before the limits, which may lower RLIMIT_NOFILE
+        wakeup_fd = iolib.OpenWakeupFd()
+
+        # Inherited by the shell.  If a hard limit can't be raised, then the
+        # client starts normally.
+        try:
+            posix.umask(req.umask)
+            for res, soft, hard in req.rlimits:
+                pyos.SetRLimit(res, soft, hard)
+        except (IOError, OSError) as e:
+            fanos.send(conn_fd,
+                       'ERROR Could not set limits: %s' % pyutil.strerror(e))
+            return 1
+
+        pid = posix.fork()
+        if pid == 0:  # shell
+            posix.close(conn_fd)
+            return self._Run(req, fd_out)
+
+        for fd in fd_out:
+            posix.close(fd)
+
+        wait_status = self._WaitForShell(pid, conn_fd, wakeup_fd)
+        if wait_status == -1:
+            fanos.send(conn_fd, 'ERROR waitpid() failed')
+            return 1
+
+        if posix.WIFSIGNALED(wait_status):
+            status = 128 + posix.WTERMSIG(wait_status)
+        else:
+            status = posix.WEXITSTATUS(wait_status)
+        try:
+            fanos.send(conn_fd, 'OK %d' % status)
+        except (IOError, OSError):
+            pass  # the client went away
+        return 0
+
+    def _WaitForShell(self, pid, conn_fd, wakeup_fd):
+        # type: (int, int, int) -> int
+        """Wait for the shell to exit, and return its wait status, or -1.
+
+        Meanwhile, send it the signals the client forwards, and kill it if the
+        client goes away.
+        """
+        poll_fds = [conn_fd, wakeup_fd]
+        while True:
+            iolib.DrainWakeupFd(wakeup_fd)  # before waitpid(), so no race
+
+            wait_pid, wait_status = pyos.WaitPid(WNOHANG)
+            if wait_pid == pid:
+                return wait_status
+            if wait_pid < 0 and wait_status != EINTR:
+                return -1
+
+            ready = pyos.WaitForReading(poll_fds)
+            if conn_fd not in ready:
+                continue  # SIGCHLD or another signal
+
+            msg = None  # type: Optional[str]
+            try:
+                msg = fanos.recv(conn_fd, [])
+            except (IOError, OSError, ValueError):
+                pass
+
+            if msg is None:
+                # The client went away, so the shell goes away too.  The
+                # shell isn't reaped yet, so its PID can't be reused.
+                posix.kill(pid, SIGKILL)
+                poll_fds = [wakeup_fd]
+            elif msg.startswith('SIG '):
+                try:
+                    sig_num = int(msg[4:])
+                except ValueError:
+                    sig_num = 0
+                if sig_num > 0:
+                    posix.kill(pid, sig_num)
+
+    def _Run(self, req, fds):
+        # type: (ZygoteRequest, List[int]) -> int
+        """Become the client's shell, and run its command."""
+        for i, fd in enumerate(fds):
+            if fd != i:
+                posix.dup2(fd, i)
+                posix.close(fd)
+
+        # The monitor's handler.  Our own 'wait' installs its own.
+        iolib.sigaction(SIGCHLD, SIG_DFL)
+
+        # Like the client, which may have been started with 'nohup', or in
+        # the background
+        for sig_num in ZYGOTE_SIGNALS:
+            if sig_num in req.ignored_signals:
+                iolib.sigaction(sig_num, SIG_IGN)
+            else:
+                iolib.sigaction(sig_num, SIG_DFL)
+
+        try:
+            posix.chdir(req.cwd)
+        except (IOError, OSError) as e:
+            print_stderr('%s: Could not change to %r: %s' %
+                         (self.lang, req.cwd, pyutil.strerror(e)))
+            return 1
+
+        # The zygote deferred these until it knew the environment
+        mem = self.mem
+        sh_init.CopyVarsFromEnv(mem.exec_opts, req.environ, mem)
+        sh_init.InitVarsAfterEnv(mem, self.mutable_opts)
+
+        mem.root_pid = posix.getpid()  # for $$
+        state.SetGlobalString(mem, 'PPID', str(req.ppid))
+
+        # Like osh -c 'cmd' [$0 [$1 ...]]
+        script_name = None  # type: Optional[str]
+        argv = []  # type: List[str]
+        if len(req.argv):
+            script_name = req.argv[0]
+            mem.dollar0 = req.argv[0]
+            argv = req.argv[1:]
+        else:
+            mem.dollar0 = req.argv0
+        mem.SetMainArgv(argv)
+
+        line_reader = reader.StringLineReader(req.cmd, self.parse_ctx.arena)
+        c_parser = self.parse_ctx.MakeOshParser(line_reader)
+        with state.ctx_ThisDir(mem, script_name):
+            try:
+                status = Batch(self.cmd_ev,
+                               c_parser,
+                               self.errfmt,
+                               cmd_flags=cmd_eval.IsMainProgram)
+            except util.HardExit as e:
+                status = e.status
+            except KeyboardInterrupt:
+                status = 130  # 128 + 2
+        return status
+
+
 def Interactive(
         flag,  # type: arg_types.main
         cmd_ev,  # type: cmd_eval.CommandEvaluator 
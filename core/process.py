@@ -28,7 +28,7 @@ from _devbuild.gen.syntax_asdl import (
 from _devbuild.gen.value_asdl import (value, value_e)
 from core import dev
 from core import error
-from core.error import e_die
+from core.error import e_die, e_die_status
 from core import pyutil
 from core import pyos
 from core import state
@@ -627,6 +627,14 @@ class ChildStateChange(object):
         """Noop for all state changes other than SetPgid for mycpp."""
         pass
 
+    def AddSpawnActions(self, actions):
+        # type: (SpawnActions) -> bool
+        """Describe Apply() for posix_spawn().
+
+        Returns False if the change can only be applied after fork().
+        """
+        return False
+
 
 class StdinFromPipe(ChildStateChange):
 
@@ -647,6 +655,13 @@ class StdinFromPipe(ChildStateChange):
         posix.close(self.w)  # we're reading from the pipe, not writing
         #log('child CLOSE w %d pid=%d', self.w, posix.getpid())
 
+    def AddSpawnActions(self, actions):
+        # type: (SpawnActions) -> bool
+        actions.Dup2(self.r, 0)
+        actions.Close(self.r)
+        actions.Close(self.w)
+        return True
+
 
 class StdoutToPipe(ChildStateChange):
 
@@ -667,6 +682,13 @@ class StdoutToPipe(ChildStateChange):
         posix.close(self.r)  # we're writing to the pipe, not reading
         #log('child CLOSE r %d pid=%d', self.r, posix.getpid())
 
+    def AddSpawnActions(self, actions):
+        # type: (SpawnActions) -> bool
+        actions.Dup2(self.w, 1)
+        actions.Close(self.w)
+        actions.Close(self.r)
+        return True
+
 
 class StderrToPipe(ChildStateChange):
 
@@ -687,6 +709,13 @@ class StderrToPipe(ChildStateChange):
         posix.close(self.r)  # we're writing to the pipe, not reading
         #log('child CLOSE r %d pid=%d', self.r, posix.getpid())
 
+    def AddSpawnActions(self, actions):
+        # type: (SpawnActions) -> bool
+        actions.Dup2(self.w, 2)
+        actions.Close(self.w)
+        actions.Close(self.r)
+        return True
+
 
 INVALID_PGID = -1
 # argument to setpgid() that means the process is its own leader
@@ -718,6 +747,35 @@ class SetPgid(ChildStateChange):
                 'osh: parent failed to set process group for PID %d to %d: %s'
                 % (proc.pid, self.pgid, pyutil.strerror(e)))
 
+    def AddSpawnActions(self, actions):
+        # type: (SpawnActions) -> bool
+        actions.pgid = self.pgid
+        return True
+
+
+class SpawnActions(object):
+    """What a child does before exec(), when it's started with posix_spawn().
+
+    Built from ChildStateChange instances.
+    """
+
+    def __init__(self):
+        # type: () -> None
+        self.fds = []  # type: List[int]
+        self.new_fds = []  # type: List[int]  # -1 means close()
+        self.pgid = INVALID_PGID
+        self.default_sigs = []  # type: List[int]
+
+    def Dup2(self, fd, new_fd):
+        # type: (int, int) -> None
+        self.fds.append(fd)
+        self.new_fds.append(new_fd)
+
+    def Close(self, fd):
+        # type: (int) -> None
+        self.fds.append(fd)
+        self.new_fds.append(-1)
+
 
 class ExternalProgram(object):
     """The capability to execute an external program like 'ls'."""
@@ -751,6 +809,22 @@ class ExternalProgram(object):
                    True)
         assert False, "This line should never execute"  # NO RETURN
 
+    def Spawn(self, argv0_path, cmd_val, environ, actions):
+        # type: (str, cmd_value.Argv, Dict[str, str], SpawnActions) -> int
+        """Start a program with posix_spawn(), and return its PID.
+
+        Returns -1 on failure, so the caller can fork() and Exec(), which
+        handles scripts without a shebang line, and prints errors.
+        """
+        probe('process', 'ExternalProgram_Spawn', argv0_path)
+        try:
+            pid = posix.posix_spawn(argv0_path, cmd_val.argv, environ,
+                                    actions.fds, actions.new_fds,
+                                    actions.pgid, actions.default_sigs)
+        except (IOError, OSError) as e:
+            return -1
+        return pid
+
     def _Exec(self, argv0_path, argv, argv0_loc, environ, should_retry):
         # type: (str, List[str], loc_t, Dict[str, str], bool) -> None
         if len(self.hijack_shebang):
@@ -833,6 +907,16 @@ class Thunk(object):
         """Display for the 'jobs' list."""
         raise NotImplementedError()
 
+    def CanSpawn(self):
+        # type: () -> bool
+        """Can this thunk be started with Spawn(), instead of fork()?"""
+        return False
+
+    def Spawn(self, actions):
+        # type: (SpawnActions) -> int
+        """Returns a PID, or -1 if the caller should fork()."""
+        raise NotImplementedError()
+
     def __repr__(self):
         # type: () -> str
         return self.UserString()
@@ -863,6 +947,16 @@ class ExternalThunk(Thunk):
         """An ExternalThunk is run in parent for the exec builtin."""
         self.ext_prog.Exec(self.argv0_path, self.cmd_val, self.environ)
 
+    def CanSpawn(self):
+        # type: () -> bool
+        # Hijacking reads the shebang line in the child
+        return len(self.ext_prog.hijack_shebang) == 0
+
+    def Spawn(self, actions):
+        # type: (SpawnActions) -> int
+        return self.ext_prog.Spawn(self.argv0_path, self.cmd_val,
+                                   self.environ, actions)
+
 
 class BuiltinThunk(Thunk):
     """Builtin thunk - for running builtins in a forked subprocess"""
@@ -1146,10 +1240,38 @@ class Process(Job):
             posix.close(self.close_r)
             posix.close(self.close_w)
 
+    def _MaybeSpawn(self):
+        # type: () -> int
+        """Start an external program with posix_spawn().
+
+        It uses vfork(), so it doesn't copy the page tables of the shell's
+        heap, and the shell is still the parent.  Returns -1 if we need to
+        fork().
+        """
+        if not self.thunk.CanSpawn():
+            return -1
+
+        actions = SpawnActions()
+        for st in self.state_changes:
+            if not st.AddSpawnActions(actions):
+                return -1
+
+        # Same signals as the fork() case below
+        actions.default_sigs = [SIGPIPE, SIGQUIT, SIGTTOU, SIGTTIN]
+        if actions.pgid == OWN_LEADER and self.parent_pipeline is None:
+            actions.default_sigs.append(SIGTSTP)
+
+        return self.thunk.Spawn(actions)
+
     def StartProcess(self, why):
         # type: (trace_t) -> int
-        """Start this process with fork(), handling redirects."""
-        pid = posix.fork()
+        """Start this process with posix_spawn() or fork(), handling
+        redirects."""
+        pid = self._MaybeSpawn()
+        spawned = pid != -1
+        if not spawned:
+            pid = posix.fork()
+
         if pid < 0:
             # When does this happen?
             e_die('Fatal error in posix.fork()')
@@ -1197,8 +1319,10 @@ class Process(Job):
 
         # SetPgid needs to be applied from the child and the parent to avoid
         # racing in calls to tcsetpgrp() in the parent. See APUE sec. 9.2.
-        for st in self.state_changes:
-            st.ApplyFromParent(self)
+        # posix_spawn() returns after the child set its group.
+        if not spawned:
+            for st in self.state_changes:
+                st.ApplyFromParent(self)
 
         # Program invariant: We keep track of every child process!
         # Waiter::WaitForOne() needs it to update state
@@ -1234,7 +1358,8 @@ class Process(Job):
         """Process::JobWait, called by wait builtin"""
         # wait builtin can be interrupted
         while self.state == job_state_e.Running:
-            result, w1_arg = waiter.WaitForOne()  # mutates self.state
+            # mutates self.state
+            result, w1_arg = waiter.WaitForOne(interruptible=True)
 
             if result == W1_CALL_INTR:
                 return wait_status.Cancelled(w1_arg)
@@ -1481,6 +1606,12 @@ class Pipeline(Job):
         if self.job_control.Enabled():
             self.pgid = OWN_LEADER  # first process in pipeline is the leader
 
+        # Parts that are external commands with literal words are started
+        # with posix_spawn(), which doesn't copy the page tables of the heap.
+        # Other parts need the shell's state to evaluate words, redirects, and
+        # functions, so they're a fork() of the shell.  Either way, the shell
+        # is the parent, which waitpid(), PIPESTATUS, and job control depend
+        # on.  See benchmarks/pipeline-fork.sh.
         for i, proc in enumerate(self.procs):
             if self.pgid != INVALID_PGID:
                 proc.AddStateChange(SetPgid(self.pgid, self.tracer))
@@ -1517,6 +1648,11 @@ class Pipeline(Job):
             if result == W1_NO_CHILDREN:
                 break
 
+        # Like Process::Wait()
+        for proc in self.procs:
+            if proc.state == job_state_e.Exited:
+                self.job_list.PopChildProcess(proc.pid)
+
         return self.pipe_status
 
     def JobWait(self, waiter):
@@ -1525,7 +1661,7 @@ class Pipeline(Job):
         # wait builtin can be interrupted
         assert self.procs, "no procs for Wait()"
         while self.state == job_state_e.Running:
-            result, w1_arg = waiter.WaitForOne()
+            result, w1_arg = waiter.WaitForOne(interruptible=True)
 
             if result == W1_CALL_INTR:  # signal
                 return wait_status.Cancelled(w1_arg)
@@ -1778,16 +1914,15 @@ class JobList(object):
         # job_id -> Job
         self.jobs = {}  # type: Dict[int, Job]
 
-        # self.pid_to_job is used by 'wait -n' and 'wait' - to call
-        # CleanupWhenProcessExits().  They Dict key is job.PidForWait()
+        # self.pid_to_job is used by 'wait $pid'.  The Dict key is
+        # job.PidForWait()
         self.pid_to_job = {}  # type: Dict[int, Job]
 
-        # TODO: consider linear search through JobList
-        # - by job ID
-        # - by PID
-        # - then you don't have to bother as much with the dicts
-        #   - you still need the child process dict to set the status and
-        #   state?
+        # The subset of self.jobs that's Running, so that 'wait' and 'wait -n'
+        # don't scan every job after each process exits.  job_id -> Job
+        #
+        # Updated by JobStateChanged()
+        self.running_jobs = {}  # type: Dict[int, Job]
 
         self.debug_pipelines = []  # type: List[Pipeline]
 
@@ -1822,8 +1957,25 @@ class JobList(object):
         # Mutate the job itself
         job.job_id = job_id
 
+        self.JobStateChanged(job)
         return job_id
 
+    def _IsRegistered(self, job):
+        # type: (Job) -> bool
+        """Is this job in the list?
+
+        A job that was removed keeps its ID, and the ID may be reused.
+        """
+        return job.job_id != -1 and self.jobs.get(job.job_id) is job
+
+    def JobStateChanged(self, job):
+        # type: (Job) -> None
+        """Called when a job is added, removed, or changes state."""
+        if self._IsRegistered(job) and job.state == job_state_e.Running:
+            self.running_jobs[job.job_id] = job
+        elif self.running_jobs.get(job.job_id) is job:
+            mylib.dict_erase(self.running_jobs, job.job_id)
+
     def JobFromPid(self, pid):
         # type: (int) -> Optional[Job]
         return self.pid_to_job.get(pid)
@@ -1833,40 +1985,40 @@ class JobList(object):
         if len(self.jobs) == 0:
             self.next_job_id = 1
 
-    def CleanupWhenJobExits(self, job):
+    def _RemoveJob(self, job):
         # type: (Job) -> None
-        """Called when say 'fg %2' exits, and when 'wait %2' exits"""
-        mylib.dict_erase(self.jobs, job.job_id)
+        if not self._IsRegistered(job):
+            return  # already removed, e.g. by 'wait' and then JobPool
 
+        mylib.dict_erase(self.jobs, job.job_id)
         mylib.dict_erase(self.pid_to_job, job.PidForWait())
+        self.JobStateChanged(job)
 
         self._MaybeResetCounter()
 
+    def CleanupWhenJobExits(self, job):
+        # type: (Job) -> None
+        """Called when say 'fg %2' exits, and when 'wait %2' exits"""
+        self._RemoveJob(job)
+
     def CleanupWhenProcessExits(self, pid):
         # type: (int) -> None
-        """Given a PID, remove the job if it has Exited."""
-
-        job = self.pid_to_job.get(pid)
-        if 0:
-            # TODO: background pipelines don't clean up properly, because only
-            # the last PID is registered in job_list.pid_to_job
+        """Given a PID, remove its job if it has Exited.
 
-            # Should we switch to a linear search of a background job array?
-            # Foreground jobs are stored in self.child_procs, and we migrate
-            # between them?
+        Must be called before PopChildProcess(pid).
+        """
+        job = None  # type: Optional[Job]
 
-            log('*** CleanupWhenProcessExits %d', pid)
-            log('job %s', job)
-            #log('STATE %s', _JobStateStr(job.state))
+        # A pipeline is done when its LAST part exits, which isn't always its
+        # PidForWait()
+        proc = self.child_procs.get(pid)
+        if proc and proc.parent_pipeline:
+            job = proc.parent_pipeline
+        else:
+            job = self.pid_to_job.get(pid)
 
         if job and job.state == job_state_e.Exited:
-            # Note: only the LAST PID in a pipeline will ever be here, but it's
-            # OK to try to delete it.
-            mylib.dict_erase(self.pid_to_job, pid)
-
-            mylib.dict_erase(self.jobs, job.job_id)
-
-        self._MaybeResetCounter()
+            self._RemoveJob(job)
 
     def AddChildProcess(self, pid, proc):
         # type: (int, Process) -> None
@@ -1911,19 +2063,21 @@ class JobList(object):
         make this a non-issue, but if bugs related to this appear this note may
         be helpful...
         """
-        # Split all active jobs by state and sort each group by decreasing job
-        # ID to approximate newness.
+        # Visit jobs by decreasing job ID, to approximate newness.  Stop when
+        # we have the 2 newest stopped jobs.
         stopped_jobs = []  # type: List[Job]
         running_jobs = []  # type: List[Job]
-        for i in xrange(0, self.next_job_id):
+        i = self.next_job_id - 1
+        while i > 0 and len(stopped_jobs) < 2:
             job = self.jobs.get(i, None)
+            i -= 1
             if not job:
                 continue
 
             if job.state == job_state_e.Stopped:
                 stopped_jobs.append(job)
 
-            elif job.state == job_state_e.Running:
+            elif job.state == job_state_e.Running and len(running_jobs) < 2:
                 running_jobs.append(job)
 
         current = None  # type: Optional[Job]
@@ -1935,16 +2089,19 @@ class JobList(object):
         # So, we will only return running jobs from here if there are no recent
         # stopped jobs.
         if len(stopped_jobs) > 0:
-            current = stopped_jobs.pop()
+            current = stopped_jobs[0]
 
-        if len(stopped_jobs) > 0:
-            previous = stopped_jobs.pop()
+        if len(stopped_jobs) > 1:
+            previous = stopped_jobs[1]
 
-        if len(running_jobs) > 0 and not current:
-            current = running_jobs.pop()
+        # The newest running jobs fill in the rest
+        j = 0
+        if not current and j < len(running_jobs):
+            current = running_jobs[j]
+            j += 1
 
-        if len(running_jobs) > 0 and not previous:
-            previous = running_jobs.pop()
+        if not previous and j < len(running_jobs):
+            previous = running_jobs[j]
 
         if not previous:
             previous = current
@@ -2047,11 +2204,7 @@ class JobList(object):
 
         Used by 'wait' and 'wait -n'.
         """
-        count = 0
-        for _, job in iteritems(self.jobs):  # mycpp rewrite: from itervalues()
-            if job.State() == job_state_e.Running:
-                count += 1
-        return count
+        return len(self.running_jobs)
 
 
 # Some WaitForOne() return values, which are negative.  The numbers are
@@ -2105,10 +2258,14 @@ class Waiter(object):
         """Returns exit code for wait -n"""
         return self.last_status
 
-    def WaitForOne(self, waitpid_options=0):
-        # type: (int) -> Tuple[int, int]
+    def WaitForOne(self, waitpid_options=0, interruptible=False):
+        # type: (int, bool) -> Tuple[int, int]
         """Wait until the next process returns (or maybe Ctrl-C).
 
+        If interruptible is true, as it is for the 'wait' builtin, then a
+        trapped signal returns W1_CALL_INTR, even if it arrived just before we
+        would block.
+
         Returns:
           One of these negative numbers:
             W1_NO_CHILDREN      Nothing to wait for
@@ -2150,8 +2307,30 @@ class Waiter(object):
 
         | NoChange                   -- for WNOHANG - is this a different API?
         """
-        #waitpid_options |= WCONTINUED
-        pid, status = pyos.WaitPid(waitpid_options)
+        if interruptible:
+            # A signal may arrive after the interpreter last ran traps, but
+            # before a blocking waitpid().  Then waitpid() isn't interrupted,
+            # and the trap would be delayed until some child exits.  So poll a
+            # pipe that signal handlers and SIGCHLD write to, and don't block
+            # in waitpid().
+            wakeup_fd = iolib.OpenWakeupFd()
+            while True:
+                iolib.DrainWakeupFd(wakeup_fd)
+
+                sig_num = self.signal_safe.PendingSignalForWait()
+                if sig_num != 0:
+                    return W1_CALL_INTR, sig_num
+                if self.signal_safe.PollUntrappedSigInt():
+                    raise KeyboardInterrupt()
+
+                pid, status = pyos.WaitPid(waitpid_options | WNOHANG)
+                if pid != 0 or (waitpid_options & WNOHANG) != 0:
+                    break
+
+                pyos.WaitForReading([wakeup_fd])
+        else:
+            #waitpid_options |= WCONTINUED
+            pid, status = pyos.WaitPid(waitpid_options)
         if pid == 0:
             return W1_NO_CHANGE, NO_ARG  # WNOHANG passed, and no state changes
 
@@ -2217,6 +2396,11 @@ class Waiter(object):
         else:
             raise AssertionError(status)
 
+        if proc:
+            self.job_list.JobStateChanged(proc)
+            if proc.parent_pipeline:
+                self.job_list.JobStateChanged(proc.parent_pipeline)
+
         self.last_status = status  # for wait -n
         self.tracer.OnProcessEnd(pid, status)
 
@@ -2240,3 +2424,247 @@ class Waiter(object):
             assert result in (W1_EXITED, W1_STOPPED), result
             # W1_CALL_INTR and iolib.UNTRAPPED_SIGWINCH should not happen,
             # because WNOHANG is a non-blocking call
+
+
+class PipeReader(object):
+    """Reads from many pipes in one process, as they become readable.
+
+    So a child process never blocks on a full pipe while we read another one.
+    Used for the stdout and stderr of Capture3(), and the stdout of each
+    'fork --jobs' job.
+    """
+
+    def __init__(self):
+        # type: () -> None
+        self.fds = []  # type: List[int]
+        self.chunks = {}  # type: Dict[int, List[str]]
+
+    def Add(self, fd, chunks):
+        # type: (int, List[str]) -> None
+        """Read from fd until EOF, and append what's read to chunks."""
+        self.fds.append(fd)
+        self.chunks[fd] = chunks
+
+    def NumOpen(self):
+        # type: () -> int
+        return len(self.fds)
+
+    def IsOpen(self, fd):
+        # type: (int) -> bool
+        return fd in self.chunks
+
+    def ReadReady(self, wakeup_fd=-1):
+        # type: (int) -> bool
+        """Wait until some pipes are readable, and read once from each.
+
+        Pipes at EOF are closed.  Returns False if a signal interrupted the
+        wait.
+
+        If wakeup_fd isn't -1, also return when it's readable.  It's not read.
+        """
+        fds = []  # type: List[int]
+        fds.extend(self.fds)
+        if wakeup_fd != -1:
+            fds.append(wakeup_fd)
+
+        ready = pyos.WaitForReading(fds)
+        if len(ready) == 0:
+            return False
+
+        for fd in ready:
+            if fd == wakeup_fd:
+                continue
+
+            n, err_num = pyos.Read(fd, 4096, self.chunks[fd])
+            if n < 0:
+                if err_num == EINTR:
+                    pass  # retry
+                else:
+                    # Like the top level IOError handler
+                    e_die_status(
+                        2,
+                        'Oils I/O error (read): %s' % posix.strerror(err_num))
+
+            elif n == 0:  # EOF
+                posix.close(fd)
+                self.fds.remove(fd)
+                mylib.dict_erase(self.chunks, fd)
+
+        return True
+
+    def CloseAll(self):
+        # type: () -> None
+        """Stop reading, and close the pipes that aren't at EOF."""
+        for fd in self.fds:
+            posix.close(fd)
+        del self.fds[:]
+        self.chunks.clear()
+
+
+class _PoolSlot(object):
+    """A job started by JobPool, which hasn't been reaped."""
+
+    def __init__(self, index, proc, read_fd):
+        # type: (int, Process, int) -> None
+        self.index = index  # in the order jobs were started
+        self.proc = proc
+        self.read_fd = read_fd  # -1 if stdout isn't captured, or at EOF
+        self.chunks = []  # type: List[str]
+
+
+class JobPool(object):
+    """Runs at most N background jobs at once, for 'fork --jobs N'.
+
+    A new job can be started as soon as any job exits, not when a whole batch
+    is done.  Statuses are recorded in the order jobs were started.
+
+    If capture_stdout is true, the stdout of each job goes to a pipe.  The
+    pipes are read while the jobs run, so a job never blocks on a full pipe.
+    """
+
+    def __init__(self, max_jobs, capture_stdout, job_list, waiter):
+        # type: (int, bool, JobList, Waiter) -> None
+        assert max_jobs > 0, max_jobs
+        self.max_jobs = max_jobs
+        self.capture_stdout = capture_stdout
+        self.job_list = job_list
+        self.waiter = waiter
+
+        self.slots = []  # type: List[_PoolSlot]
+        self.reader = PipeReader()
+
+        # Indexed by the order jobs were started
+        self.statuses = []  # type: List[int]
+        self.stdouts = []  # type: List[str]
+
+    def Start(self, p):
+        # type: (Process) -> int
+        """Start a background job, which must fit in the pool.
+
+        Returns the job ID.
+        """
+        assert len(self.slots) < self.max_jobs
+
+        read_fd = -1
+        if self.capture_stdout:
+            read_fd, w = posix.pipe()
+            p.AddStateChange(StdoutToPipe(read_fd, w))
+
+        p.SetBackground()
+        p.StartProcess(trace.Fork)
+
+        if self.capture_stdout:
+            posix.close(w)  # not going to write
+
+        index = len(self.statuses)
+        self.statuses.append(-1)
+        self.stdouts.append('')
+        slot = _PoolSlot(index, p, read_fd)
+        self.slots.append(slot)
+
+        if self.capture_stdout:
+            self.reader.Add(read_fd, slot.chunks)
+
+        return self.job_list.RegisterJob(p)  # show in 'jobs' list
+
+    def NumRunning(self):
+        # type: () -> int
+        return len(self.slots)
+
+    def _WaitForEvents(self):
+        # type: () -> int
+        """Reap jobs that exited, or wait until a pipe or the wakeup pipe is
+        readable.
+
+        Like the 'wait' builtin, any job that exits is removed from the job
+        list, not just the jobs in the pool.
+
+        Returns 128 + signal number if a trapped signal interrupted the wait,
+        127 if there's nothing to wait for, or 0.
+        """
+        # Like WaitForOne(interruptible=True).  SIGCHLD writes to the wakeup
+        # pipe, so we never block in waitpid(), and a job that exits after
+        # we poll it still wakes us up.
+        wakeup_fd = iolib.OpenWakeupFd()
+        iolib.DrainWakeupFd(wakeup_fd)
+
+        sig_num = self.waiter.signal_safe.PendingSignalForWait()
+        if sig_num != 0:
+            return 128 + sig_num
+        if self.waiter.signal_safe.PollUntrappedSigInt():
+            raise KeyboardInterrupt()
+
+        reaped = False
+        while True:
+            result, w1_arg = self.waiter.WaitForOne(waitpid_options=WNOHANG)
+            if result == W1_EXITED:
+                pid = w1_arg
+                self.job_list.CleanupWhenProcessExits(pid)
+                self.job_list.PopChildProcess(pid)
+                reaped = True
+
+            elif result == W1_STOPPED:
+                pass
+
+            else:
+                if (result == W1_NO_CHILDREN and not reaped and
+                        self.reader.NumOpen() == 0):
+                    return 127  # shouldn't happen
+                break
+
+        if reaped:
+            return 0
+
+        self.reader.ReadReady(wakeup_fd)  # retry if a signal interrupted it
+
+        for slot in self.slots:
+            if slot.read_fd != -1 and not self.reader.IsOpen(slot.read_fd):
+                slot.read_fd = -1  # closed at EOF
+
+        return 0
+
+    def StopReading(self):
+        # type: () -> None
+        """Close the stdout pipes, when we return before the jobs exit.
+
+        A job that writes more to its stdout gets SIGPIPE.
+        """
+        self.reader.CloseAll()
+        for slot in self.slots:
+            slot.read_fd = -1
+
+    def _Reap(self):
+        # type: () -> None
+        """Record the jobs that exited, and forget them."""
+        remaining = []  # type: List[_PoolSlot]
+        for slot in self.slots:
+            p = slot.proc
+            if slot.read_fd != -1 or p.state != job_state_e.Exited:
+                remaining.append(slot)
+                continue
+
+            # _WaitForEvents() already removed it from the job list
+            self.statuses[slot.index] = p.status
+            if self.capture_stdout:
+                self.stdouts[slot.index] = ''.join(slot.chunks)
+        self.slots = remaining
+
+    def WaitUntil(self, max_running):
+        # type: (int) -> int
+        """Wait until at most max_running jobs are running.
+
+        Pass max_jobs - 1 to make room for the next job, or 0 to wait for all
+        of them.
+
+        Returns 0, or 128 + signal number if a trapped signal interrupted the
+        wait.  Then the running jobs are left in the job list, for 'wait', and
+        the caller should call StopReading().
+        """
+        while len(self.slots) > max_running:
+            status = self._WaitForEvents()
+            if status != 0:
+                return status
+
+            self._Reap()
+
+        return 0
@@ -1,6 +1,9 @@
 #!/usr/bin/env python2
 
+import errno
 import os
+import signal
+import time
 import unittest
 
 from _devbuild.gen.id_kind_asdl import Id
@@ -47,12 +50,18 @@ class _FakeJobControl(object):
     def Enabled(self):
         return self.enabled
 
+    def MaybeTakeTerminal(self):
+        pass
+
 
 class _FakeCommandEvaluator(object):
 
     def RunPendingTraps(self):
         pass
 
+    def PollSignals(self):
+        pass
+
 
 def _SetupTest(self):
     self.arena = test_lib.MakeArena('process_test.py')
@@ -75,7 +84,8 @@ def _SetupTest(self):
     self.multi_trace = dev.MultiTracer(posix.getpid(), '', '', '', fd_state)
     self.tracer = dev.Tracer(None, exec_opts, mutable_opts, self.mem,
                              mylib.Stderr(), self.multi_trace)
-    self.waiter = process.Waiter(self.job_list, exec_opts, self.trap_state,
+    self.signal_safe = signal_safe
+    self.waiter = process.Waiter(self.job_list, exec_opts, signal_safe,
                                  self.tracer)
     self.errfmt = ui.ErrorFormatter()
     self.fd_state = process.FdState(self.errfmt, self.job_control,
@@ -300,6 +310,62 @@ class ProcessTest(_Common):
         # first process is the process group leader
         self.assertEqual(pi.pids[0], pi.ProcessGroupId())
 
+    def testSpawnActions(self):
+        pi = process.Pipeline(False, self.job_control, self.job_list,
+                              self.tracer)
+        procs = [self._ExtProc(['ls']), self._ExtProc(['sort'])]
+        pi.Add(procs[0])
+        pi.Add(procs[1])
+        pi.AddLast((self.cmd_ev, _CommandNode('wc -l', self.arena)))
+
+        r1, w1 = pi.procs[1].close_r, pi.procs[1].close_w
+        r2, w2 = pi.last_pipe
+
+        actions = process.SpawnActions()
+        for st in procs[1].state_changes:
+            self.assertEqual(True, st.AddSpawnActions(actions))
+
+        # Same order as Apply(): dup2(), then close both ends
+        self.assertEqual([r1, r1, w1, w2, w2, r2], actions.fds)
+        self.assertEqual([0, -1, -1, 1, -1, -1], actions.new_fds)
+        self.assertEqual(process.INVALID_PGID, actions.pgid)
+
+        for fd in (r1, w1, r2, w2):
+            posix.close(fd)
+
+    def testSpawnPipelinePgid(self):
+        jc = _FakeJobControl(True)
+        pi = process.Pipeline(False, jc, self.job_list, self.tracer)
+        for argv in [['sleep', '0.1'], ['sleep', '0.1']]:
+            thunk = _MakeThunk(argv, self.ext_prog)
+            p = Process(thunk, jc, self.job_list, self.tracer)
+            p.Init_ParentPipeline(pi)
+            pi.Add(p)
+
+        pi.StartPipeline(self.waiter)
+        self.assertEqual(pi.pids[0], pi.ProcessGroupId())
+        # posix_spawn() set the group before returning
+        for pid in pi.pids:
+            self.assertEqual(pi.pids[0], posix.getpgid(pid))
+
+        self.assertEqual([0, 0], pi.Wait(self.waiter))
+
+    def testSpawnFallsBackToFork(self):
+        # posix_spawn() fails, and the forked child prints the error
+        p = self._ExtProc(['does-not-exist'])
+        self.assertEqual(127, p.RunProcess(self.waiter, trace.Fork))
+
+        # No shebang line, so the forked child retries with /bin/sh
+        path = '_tmp/no-shebang.sh'
+        with open(path, 'w') as f:
+            f.write('exit 42\n')
+        os.chmod(path, 0o755)
+
+        arg_vec = cmd_value.Argv([path], [loc.Missing], False, None, None)
+        thunk = ExternalThunk(self.ext_prog, path, arg_vec, {})
+        p = Process(thunk, self.job_control, self.job_list, self.tracer)
+        self.assertEqual(42, p.RunProcess(self.waiter, trace.Fork))
+
     def testOpen(self):
         # Disabled because mycpp translation can't handle it.  We do this at a
         # higher layer.
@@ -423,6 +489,76 @@ class JobListTest(_Common):
         # Still zero
         self.assertJobListLength(0)
 
+    def testWaitBackgroundPipeline(self):
+        """ sleep 0.05 | true & wait """
+        self.assertJobListLength(0)
+
+        # The last part exits first, so the pipeline is done when a part that
+        # isn't its PidForWait() exits
+        pi = self._MakeBackgroundPipeline('sleep 0.05 | true')
+        pi.StartPipeline(self.waiter)
+        pi.SetBackground()
+        self.job_list.RegisterJob(pi)
+        self.assertEqual(1, self.job_list.NumRunning())
+
+        cmd_val = test_lib.MakeBuiltinArgv(['wait'])
+        status = self.wait_builtin.Run(cmd_val)
+        self.assertEqual(0, status)
+
+        self.assertEqual(0, self.job_list.NumRunning())
+        self.assertJobListLength(0)
+
+    def testWaitWithPendingSignal(self):
+        """ trap ... USR1; sleep 5 & ... wait """
+        pid, _ = self._RunBackgroundJob(['sleep', '5'])
+
+        # The signal arrived after traps were run, but before 'wait' blocked.
+        # It interrupts 'wait' right away, rather than after 5 seconds.
+        self.signal_safe.UpdateFromSignalHandler(signal.SIGUSR1, None)
+
+        for argv in [['wait'], ['wait', '-n'], ['wait', str(pid)]]:
+            cmd_val = test_lib.MakeBuiltinArgv(argv)
+            status = self.wait_builtin.Run(cmd_val)
+            self.assertEqual(128 + signal.SIGUSR1, status)
+
+        # Untrapped SIGWINCH doesn't interrupt
+        self.signal_safe.TakePendingSignals()
+        self.signal_safe.UpdateFromSignalHandler(signal.SIGWINCH, None)
+        self.assertEqual(0, self.signal_safe.PendingSignalForWait())
+        self.signal_safe.TakePendingSignals()
+
+        posix.kill(pid, signal.SIGTERM)
+        cmd_val = test_lib.MakeBuiltinArgv(['wait'])
+        status = self.wait_builtin.Run(cmd_val)
+        self.assertEqual(0, status)
+        self.assertJobListLength(0)
+
+    def testWaitWakesOnSignal(self):
+        """ trap ... USR1; sleep 5 & ... wait $! """
+        # Like iolib.RegisterSignalInterest(), but test_lib replaced
+        # iolib.gSignalSafe
+        signal.signal(signal.SIGUSR1, self.signal_safe.UpdateFromSignalHandler)
+        try:
+            pid, _ = self._RunBackgroundJob(['sleep', '5'])
+            self._RunBackgroundJob(
+                ['sh', '-c', 'sleep 0.2; kill -USR1 %d' % posix.getpid()])
+
+            # The signal arrives while 'wait' is waiting
+            start = time.time()
+            cmd_val = test_lib.MakeBuiltinArgv(['wait', str(pid)])
+            status = self.wait_builtin.Run(cmd_val)
+            self.assertEqual(128 + signal.SIGUSR1, status)
+            self.assertLess(time.time() - start, 3.0)
+        finally:
+            iolib.sigaction(signal.SIGUSR1, signal.SIG_DFL)
+            self.signal_safe.TakePendingSignals()
+
+        posix.kill(pid, signal.SIGTERM)
+        cmd_val = test_lib.MakeBuiltinArgv(['wait'])
+        status = self.wait_builtin.Run(cmd_val)
+        self.assertEqual(0, status)
+        self.assertJobListLength(0)
+
     def testWaitPid(self):
         """ wait $pid2 """
         # Jobs list starts out empty
@@ -713,6 +849,92 @@ class PipelineJobListTest(_Common):
         self.assertJobListLength(0)
 
 
+class PipeReaderTest(unittest.TestCase):
+
+    def testReadUntilEof(self):
+        reader = process.PipeReader()
+
+        out_chunks = []
+        err_chunks = []
+        r1, w1 = posix.pipe()
+        r2, w2 = posix.pipe()
+        reader.Add(r1, out_chunks)
+        reader.Add(r2, err_chunks)
+
+        posix.write(w1, 'out')
+        posix.write(w2, 'err')
+        posix.close(w2)
+
+        self.assertEqual(True, reader.ReadReady())
+        self.assertEqual(['out'], out_chunks)
+        self.assertEqual(['err'], err_chunks)
+
+        # r2 is closed at EOF
+        while reader.IsOpen(r2):
+            reader.ReadReady()
+        self.assertEqual(1, reader.NumOpen())
+
+        posix.close(w1)
+        while reader.NumOpen():
+            reader.ReadReady()
+        self.assertEqual(False, reader.IsOpen(r1))
+        self.assertEqual(['out'], out_chunks)
+
+    def testWakeupFd(self):
+        reader = process.PipeReader()
+
+        chunks = []
+        r, w = posix.pipe()
+        reader.Add(r, chunks)
+
+        # Returns when the wakeup pipe is readable, without reading it
+        wake_r, wake_w = posix.pipe()
+        posix.write(wake_w, 'x')
+        self.assertEqual(True, reader.ReadReady(wake_r))
+        self.assertEqual([], chunks)
+        self.assertEqual('x', posix.read(wake_r, 1))
+
+        posix.close(w)
+        while reader.NumOpen():
+            reader.ReadReady(wake_r)
+
+        posix.close(wake_r)
+        posix.close(wake_w)
+
+    def testCloseAll(self):
+        reader = process.PipeReader()
+
+        r, w = posix.pipe()
+        reader.Add(r, [])
+        reader.CloseAll()
+        self.assertEqual(0, reader.NumOpen())
+        self.assertEqual(False, reader.IsOpen(r))
+
+        # The writer sees the read end closed
+        try:
+            posix.write(w, 'x')
+        except OSError as e:
+            self.assertEqual(errno.EPIPE, e.errno)
+        else:
+            self.fail('Expected EPIPE')
+        posix.close(w)
+
+    def testWaitForReadingHighFd(self):
+        # select() can't wait on descriptors above FD_SETSIZE
+        r, w = posix.pipe()
+        high = 1500
+        try:
+            posix.dup2(r, high)
+        except OSError:
+            return  # RLIMIT_NOFILE is too low
+        posix.close(r)
+
+        posix.write(w, 'x')
+        self.assertEqual([high], pyos.WaitForReading([high]))
+        posix.close(high)
+        posix.close(w)
+
+
 if __name__ == '__main__':
     unittest.main()
 
@@ -283,9 +283,23 @@ def InputAvailable(fd):
 
 def WaitForReading(fd_list):
     # type: (List[int]) -> List[int]
-    # read, write, except
-    r, _, _ = select.select(fd_list, [], [])
-    return r
+    """Wait until some descriptors are readable, or at EOF, and return them.
+
+    Returns an empty list if a signal interrupted the wait.
+    """
+    # Unlike select(), poll() works with descriptors above FD_SETSIZE, and its
+    # cost doesn't depend on the highest descriptor.  The shell's own
+    # descriptors start at 100.
+    poller = select.poll()
+    for fd in fd_list:
+        poller.register(fd, select.POLLIN)
+    try:
+        events = poller.poll()
+    except select.error as e:
+        if e.args[0] == EINTR:
+            return []
+        raise
+    return [fd for fd, _ in events]
 
 
 def MakeDirCacheKey(path):
@@ -2,6 +2,7 @@
 from __future__ import print_function
 
 from errno import ENOENT
+from signal import SIG_DFL, SIGINT
 import time as time_
 
 from _devbuild.gen import arg_types
@@ -18,6 +19,7 @@ from core import completion
 from core import main_loop
 from core import optview
 from core import process
+from core import pyos
 from core import pyutil
 from core import sh_init
 from core import state
@@ -87,10 +89,11 @@ from ysh import expr_eval
 
 unused2 = log
 
+import fanos
 import libc
 import posix_ as posix
 
-from typing import List, Dict, Optional, TYPE_CHECKING
+from typing import List, Dict, Optional, Tuple, TYPE_CHECKING
 if TYPE_CHECKING:
     from frontend.py_readline import Readline
 
@@ -229,6 +232,123 @@ def InitAssignmentBuiltins(
     return assign_b
 
 
+def _Listen(lang, path):
+    # type: (str, str) -> int
+    """Returns a listening socket, or -1 after printing an error."""
+    try:
+        return fanos.listen(path)
+    except (IOError, OSError) as e:
+        print_stderr('%s: Could not listen on %r: %s' %
+                     (lang, path, pyutil.strerror(e)))
+    except ValueError as e:  # path too long
+        print_stderr('%s: Could not listen on %r: %s' % (lang, path, e))
+    return -1
+
+
+def _RunInZygote(
+        sock_path,  # type: str
+        lang,  # type: str
+        bash_compat,  # type: bool
+        cmd,  # type: str
+        argv0,  # type: str
+        argv,  # type: List[str]
+        environ,  # type: Dict[str, str]
+):
+    # type: (...) -> int
+    """Send osh -c to a zygote started with osh --zygote.
+
+    Returns the status, or -1 if the zygote didn't run the command, so we
+    should start normally.
+    """
+    # The shell gets these from us, not from the zygote
+    umask = posix.umask(0)
+    posix.umask(umask)
+
+    rlimits = []  # type: List[Tuple[int, mops.BigInt, mops.BigInt]]
+    ignored_signals = []  # type: List[int]
+    try:
+        for res in main_loop.ZYGOTE_RLIMITS:
+            soft, hard = pyos.GetRLimit(res)
+            rlimits.append((res, soft, hard))
+        cwd = posix.getcwd()
+    except (IOError, OSError):
+        return -1
+    for sig_num in main_loop.ZYGOTE_SIGNALS:
+        if iolib.SignalIsIgnored(sig_num):
+            ignored_signals.append(sig_num)
+
+    try:
+        sock_fd = fanos.connect(sock_path)
+    except (IOError, OSError, ValueError):
+        return -1  # no zygote is listening
+
+    req = main_loop.ZygoteRequest(lang, bash_compat, cmd, argv0, argv,
+                                  environ, cwd, posix.getppid(), umask,
+                                  rlimits, ignored_signals)
+    try:
+        fanos.send(sock_fd, req.Encode(), 0, 1, 2)
+    except (IOError, OSError, ValueError):
+        posix.close(sock_fd)
+        return -1
+
+    # While the shell runs, forward the signals we receive to it.  Ignored
+    # signals stay ignored, like they are in the shell.
+    signal_safe = iolib.InitSignalSafe()  # registers SIGINT
+    forwarded = []  # type: List[int]
+    for sig_num in main_loop.ZYGOTE_FORWARDED:
+        if sig_num == SIGINT:
+            continue
+        if not iolib.SignalIsIgnored(sig_num):
+            iolib.RegisterSignalInterest(sig_num)
+            forwarded.append(sig_num)
+    wakeup_fd = iolib.OpenWakeupFd()
+
+    reply = None  # type: Optional[str]
+    while True:
+        iolib.DrainWakeupFd(wakeup_fd)  # before taking signals, so no race
+
+        sig_nums = signal_safe.TakePendingSignals()
+        for sig_num in sig_nums:
+            try:
+                fanos.send(sock_fd, 'SIG %d' % sig_num)
+            except (IOError, OSError):
+                pass  # the zygote went away; recv() will notice
+        del sig_nums[:]
+        signal_safe.ReuseEmptyList(sig_nums)
+
+        ready = pyos.WaitForReading([sock_fd, wakeup_fd])
+        if sock_fd in ready:
+            fd_out = []  # type: List[int]
+            try:
+                reply = fanos.recv(sock_fd, fd_out)
+            except (IOError, OSError, ValueError):
+                pass
+            break
+    posix.close(sock_fd)
+
+    # In case we start normally
+    for sig_num in forwarded:
+        iolib.sigaction(sig_num, SIG_DFL)
+
+    if reply is None:
+        # The command may have run, so don't run it again
+        print_stderr('%s: zygote at %r closed the connection' %
+                     (lang, sock_path))
+        return 1
+
+    if reply.startswith('OK '):
+        try:
+            status = int(reply[3:])
+        except ValueError:
+            status = -1
+        if 0 <= status and status <= 255:
+            return status
+        print_stderr('%s: zygote at %r sent an invalid reply %r' %
+                     (lang, sock_path, reply))
+
+    return -1  # ERROR: e.g. the zygote is running a different lang
+
+
 def Main(
         lang,  # type: str
         arg_r,  # type: args.Reader
@@ -259,6 +379,7 @@ def Main(
 
     assert lang in ('osh', 'ysh'), lang
 
+    flags_start = arg_r.i
     try:
         attrs = flag_util.ParseMore('main', arg_r)
     except error.Usage as e:
@@ -266,6 +387,16 @@ def Main(
         return 2
     flag = arg_types.main(attrs.attrs)
 
+    # osh -c 'cmd' can be run by a zygote, skipping initialization.  Other
+    # flags change the initial state, so they aren't forwarded.
+    zygote_path = environ.get('OILS_ZYGOTE_SOCKET')
+    if (zygote_path is not None and flag.c is not None and
+            arg_r.i == flags_start + 2 and not login_shell):
+        status = _RunInZygote(zygote_path, lang, bash_compat, flag.c, argv0,
+                              arg_r.Rest(), environ)
+        if status != -1:
+            return status
+
     arena = alloc.Arena()
     errfmt = ui.ErrorFormatter()
 
@@ -336,11 +467,13 @@ def Main(
         state.SetGlobalArray(mem, 'BASH_VERSINFO',
                              ['5', '3', '0', '0', 'release', 'unknown'])
 
-    sh_init.CopyVarsFromEnv(exec_opts, environ, mem)
+    # A zygote does this for each request, with the client's environment
+    if flag.zygote is None:
+        sh_init.CopyVarsFromEnv(exec_opts, environ, mem)
 
-    # PATH PWD, etc. must be set after CopyVarsFromEnv()
-    # Also mutate options from SHELLOPTS, if set
-    sh_init.InitVarsAfterEnv(mem, mutable_opts)
+        # PATH PWD, etc. must be set after CopyVarsFromEnv()
+        # Also mutate options from SHELLOPTS, if set
+        sh_init.InitVarsAfterEnv(mem, mutable_opts)
 
     if attrs.show_options:  # special case: sh -o
         pure_osh.ShowOptions(mutable_opts, [])
@@ -470,6 +603,7 @@ def Main(
     cmd_deps.dumper = dev.CrashDumper(crash_dump_dir, fd_state)
 
     comp_lookup = completion.Lookup()
+    dir_cache = completion.DirCache()
 
     # Various Global State objects to work around readline interfaces
     compopt_state = completion.OptionState()
@@ -762,8 +896,8 @@ def Main(
 
     b[builtin_i.times] = misc_osh.Times()
 
-    b[builtin_i.json] = json_ysh.Json(mem, errfmt, False)
-    b[builtin_i.json8] = json_ysh.Json(mem, errfmt, True)
+    b[builtin_i.json] = json_ysh.Json(mem, cmd_ev, errfmt, False)
+    b[builtin_i.json8] = json_ysh.Json(mem, cmd_ev, errfmt, True)
 
     ### Process builtins
     b[builtin_i.exec_] = process_osh.Exec(mem, ext_prog, fd_state, search_path,
@@ -778,7 +912,7 @@ def Main(
     b[builtin_i.bg] = process_osh.Bg(job_list)
 
     # Could be in process_ysh
-    b[builtin_i.fork] = process_osh.Fork(shell_ex)
+    b[builtin_i.fork] = process_osh.Fork(shell_ex, mem, job_list, waiter)
     b[builtin_i.forkwait] = process_osh.ForkWait(shell_ex)
 
     # Interactive builtins depend on readline
@@ -790,8 +924,8 @@ def Main(
 
     # Completion
     spec_builder = completion_osh.SpecBuilder(cmd_ev, parse_ctx, word_ev,
-                                              splitter, comp_lookup, help_data,
-                                              errfmt)
+                                              splitter, comp_lookup, dir_cache,
+                                              help_data, errfmt)
     complete_builtin = completion_osh.Complete(spec_builder, comp_lookup)
     b[builtin_i.complete] = complete_builtin
     b[builtin_i.compgen] = completion_osh.CompGen(spec_builder)
@@ -808,7 +942,7 @@ def Main(
 
     root_comp = completion.RootCompleter(comp_ev, mem, comp_lookup,
                                          compopt_state, comp_ui_state,
-                                         comp_ctx, debug_f)
+                                         comp_ctx, dir_cache, debug_f)
     b[builtin_i.compexport] = completion_ysh.CompExport(root_comp)
 
     #
@@ -889,6 +1023,16 @@ def Main(
         'end': func_eggex.MatchMethod(func_eggex.E, None),
     }
 
+    methods[value_e.Table] = {
+        'columns': method_other.TableColumns(),
+        'column': method_other.TableColumn(),  # boxes the cells in a List
+        'toDict': method_other.TableToDict(),
+        # These don't box the cells, and return a new Table
+        'filter': method_other.TableFilter(),
+        'sortBy': method_other.TableSortBy(),
+        'groupCount': method_other.TableGroupCount(),
+    }
+
     methods[value_e.Place] = {
         # __mut_setValue()
 
@@ -1006,6 +1150,9 @@ def Main(
     _AddBuiltinFunc(mem, 'fromJson8', func_misc.FromJson8(True))
     _AddBuiltinFunc(mem, 'fromJson', func_misc.FromJson8(False))
 
+    _AddBuiltinFunc(mem, 'toTsv8', func_misc.ToTsv8())
+    _AddBuiltinFunc(mem, 'fromTsv8', func_misc.FromTsv8())
+
     mem.AddBuiltin('io', io_obj)
     mem.AddBuiltin('vm', vm_obj)
 
@@ -1062,6 +1209,9 @@ def Main(
                 src = source.Headless
                 line_reader = None  # unused!
                 # Not setting '-i' flag for now.  Some people's bashrc may want it?
+            elif flag.zygote is not None:
+                src = source.CFlag
+                line_reader = None  # each request makes its own
             else:
                 stdin_ = mylib.Stdin()
                 # --tool never starts a prompt
@@ -1147,7 +1297,17 @@ def Main(
         loop = main_loop.Headless(cmd_ev, parse_ctx, errfmt)
         try:
             # TODO: What other exceptions happen here?
-            status = loop.Loop()
+            if flag.socket is not None:
+                num_workers = mops.BigTruncate(flag.workers)
+                if num_workers <= 0:
+                    print_stderr('%s: --workers should be positive' % lang)
+                    return 2
+                listen_fd = _Listen(lang, flag.socket)
+                if listen_fd < 0:
+                    return 1
+                status = loop.Serve(listen_fd, flag.socket, num_workers)
+            else:
+                status = loop.Loop()
         except util.HardExit as e:
             status = e.status
 
@@ -1158,7 +1318,22 @@ def Main(
 
         return status
 
-    # Note: headless mode above doesn't use c_parser
+    if flag.zygote is not None:
+        listen_fd = _Listen(lang, flag.zygote)
+        if listen_fd < 0:
+            return 1
+        zygote = main_loop.Zygote(lang, bash_compat, cmd_ev, parse_ctx, errfmt,
+                                  mem, mutable_opts)
+        try:
+            status = zygote.Serve(listen_fd, flag.zygote)
+        except util.HardExit as e:
+            status = e.status
+
+        mut_status = IntParamBox(status)
+        cmd_ev.RunTrapsOnExit(mut_status)
+        return mut_status.i
+
+    # Note: headless and zygote modes above don't use c_parser
     assert line_reader is not None
     c_parser = parse_ctx.MakeOshParser(line_reader)
 
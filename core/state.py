@@ -1734,6 +1734,16 @@ class Mem(object):
         # from set -- 1 2 3
         self.argv_stack[-1].SetArgv(argv)
 
+    def SetMainArgv(self, argv):
+        # type: (List[str]) -> None
+        """Replace the argv of the main program, e.g. for a Zygote request.
+
+        Sets $@, and the global ARGV if YSH globals are initialized.
+        """
+        self.SetArgv(argv)
+        if self.exec_opts.init_ysh_globals():
+            self.var_stack[0]['ARGV'] = _MakeArgvCell(argv)
+
     #
     # Special Vars
     #
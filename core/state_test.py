@@ -348,6 +348,24 @@ class MemTest(unittest.TestCase):
         mem.SetArgv(['i', 'j', 'k'])
         self.assertEqual(['i', 'j', 'k'], mem.GetArgv())
 
+    def testSetMainArgv(self):
+        mem = state.Mem('', ['x', 'y'], {}, None, [], {})
+        parse_opts, exec_opts, mutable_opts = state.MakeOpts(mem, {}, None)
+        mem.exec_opts = exec_opts
+
+        mem.Shift(1)
+        mem.SetMainArgv(['a', 'b'])
+        self.assertEqual(['a', 'b'], mem.GetArgv())
+        self.assertEqual(None, mem.var_stack[0].get('ARGV'))
+
+        # YSH also has ARGV
+        mutable_opts.SetAnyOption('init_ysh_globals', True)
+        mem.SetMainArgv(['c'])
+        self.assertEqual(['c'], mem.GetArgv())
+        argv = mem.var_stack[0]['ARGV'].val
+        self.assertEqual(value_e.List, argv.tag())
+        self.assertEqual(['c'], [item.s for item in argv.items])
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -36,6 +36,7 @@ from core import state
 from display import ui
 from core import util
 from core import vm
+from data_lang import j8
 from frontend import lexer
 from frontend import location
 from frontend import parse_lib
@@ -67,6 +68,18 @@ def FakeTok(id_, val):
     return Token(id_, len(val), 0, line, None)
 
 
+def Encoded(encode, val, *args):
+    """Call an encoder like encode(val, buf, ...), and return what it wrote."""
+    buf = mylib.BufWriter()
+    encode(val, buf, *args)
+    return buf.getvalue()
+
+
+def J8Line(val):
+    """Encode a value as one line of J8, e.g. to compare two values."""
+    return Encoded(j8.PrintMessage, val, -1, True)
+
+
 def PrintableString(s):
     """For pretty-printing in tests."""
     if all(c in string.printable for c in s):
@@ -286,7 +299,7 @@ def InitCommandEvaluator(parse_ctx=None,
     multi_trace = dev.MultiTracer(posix.getpid(), '', '', '', fd_state)
     tracer = dev.Tracer(parse_ctx, exec_opts, mutable_opts, mem, debug_f,
                         multi_trace)
-    waiter = process.Waiter(job_list, exec_opts, trap_state, tracer)
+    waiter = process.Waiter(job_list, exec_opts, signal_safe, tracer)
 
     cmd_deps.cflow_builtin = cmd_eval.ControlFlowBuiltin(
         mem, exec_opts, tracer, errfmt)
@@ -316,7 +329,8 @@ def InitCommandEvaluator(parse_ctx=None,
     except ImportError:
         TOPICS = None  # minimal dev build
     spec_builder = completion_osh.SpecBuilder(cmd_ev, parse_ctx, word_ev,
-                                              splitter, comp_lookup, TOPICS,
+                                              splitter, comp_lookup,
+                                              completion.DirCache(), TOPICS,
                                               errfmt)
 
     # Add some builtins that depend on the executor!
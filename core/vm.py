@@ -21,6 +21,7 @@ if TYPE_CHECKING:
     from _devbuild.gen.syntax_asdl import (command, command_t, CommandSub)
     from builtin import hay_ysh
     from core import optview
+    from core import process
     from core import state
     from frontend import typed_args
     from osh import sh_expr_eval
@@ -336,6 +337,10 @@ class _Executor(object):
         # type: (command_t) -> int
         return 0
 
+    def RunPoolJob(self, node, pool):
+        # type: (command_t, process.JobPool) -> int
+        return 0
+
     def RunPipeline(self, node, status_out):
         # type: (command.Pipeline, CommandStatus) -> None
         pass
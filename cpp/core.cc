@@ -6,6 +6,7 @@
 #include <errno.h>
 #include <float.h>
 #include <math.h>  // fmod()
+#include <poll.h>  // poll()
 #include <pwd.h>   // passwd
 #include <signal.h>
 #include <sys/resource.h>  // getrusage
@@ -19,6 +20,8 @@
 #include <time.h>          // time()
 #include <unistd.h>        // getuid(), environ
 
+#include <vector>
+
 #include "_build/detected-cpp-config.h"  // HAVE_PWENT
 #include "_gen/cpp/build_stamp.h"        // gCommitHash
 #include "_gen/frontend/consts.h"        // gVersion
@@ -255,17 +258,24 @@ bool InputAvailable(int fd) {
 }
 
 List<int>* WaitForReading(List<int>* fd_list) {
-  auto* ret = NewList<int>();
-  fd_set fd_bits;
-  FD_ZERO(&fd_bits);
+  // Unlike select(), poll() works with descriptors above FD_SETSIZE
   int n = len(fd_list);
+  std::vector<struct pollfd> pfds(n);
   for (int i = 0; i < n; ++i) {
-    FD_SET(fd_list->at(i), &fd_bits);
+    pfds[i].fd = fd_list->at(i);
+    pfds[i].events = POLLIN;
+    pfds[i].revents = 0;
+  }
+
+  auto* ret = NewList<int>();
+  int num_ready = ::poll(pfds.data(), n, -1);
+  if (num_ready < 0) {
+    return ret;  // e.g. EINTR from a signal
   }
-  int num_ready = select(FD_SETSIZE, &fd_bits, NULL, NULL, NULL);
   for (int i = 0; i < n; ++i) {
-    if (FD_ISSET(fd_list->at(i), &fd_bits)) {
-      ret->append(fd_list->at(i));
+    // POLLHUP is EOF on a pipe
+    if (pfds[i].revents != 0) {
+      ret->append(pfds[i].fd);
     }
     if (len(ret) == num_ready) {
       break;
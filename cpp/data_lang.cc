@@ -2,6 +2,8 @@
 
 #include "cpp/data_lang.h"
 
+#include <inttypes.h>  // PRId64
+
 #include "data_lang/j8.h"
 #include "data_lang/utf8.h"
 
@@ -183,18 +185,26 @@ Tuple2<int, int> Utf8DecodeOne(BigStr* s, int start) {
 namespace pyj8 {
 
 bool PartIsUtf8(BigStr* s, int start, int end) {
-  Utf8Result result;
+  if (start >= end) {
+    return true;
+  }
+  return utf8_is_valid(reinterpret_cast<unsigned char*>(s->data_ + start),
+                       end - start);
+}
 
-  for (int i = start; i < end;) {
-    utf8_decode(reinterpret_cast<unsigned char*>(s->data_ + i), &result);
-    if (result.error) {
-      return false;
-    }
+int FindPlainStrEnd(BigStr* s, int start, bool double_quoted) {
+  // Bounds check for safety
+  DCHECK(0 <= start && start <= len(s));
 
-    i += result.bytes_read;
-  }
+  uint8_t* in = reinterpret_cast<uint8_t*>(s->data_);
+  uint8_t* in_end = in + len(s);  // BigStr is NUL-terminated
 
-  return true;
+  uint8_t quote = double_quoted ? '"' : '\'';
+  uint8_t* p = J8ScanPlainChars(in + start, in_end, quote);
+  if (p < in_end && *p == quote) {
+    return p - in;
+  }
+  return -1;
 }
 
 void WriteString(BigStr* s, int options, mylib::BufWriter* buf) {
@@ -253,6 +263,104 @@ void WriteString(BigStr* s, int options, mylib::BufWriter* buf) {
   buf->WriteConst("\"");
 }
 
+// Like the number formatting in mops::ToStr() and str(double), but
+// written directly to the buffer, without an intermediate BigStr
+
+const int kMaxInt64Chars = 32;  // like kInt64BufSize in mycpp/gc_mops.cc
+
+void WriteBigInt(mops::BigInt i, mylib::BufWriter* buf) {
+  buf->EnsureMoreSpace(kMaxInt64Chars);
+
+  char* out = reinterpret_cast<char*>(buf->LengthPointer());
+  int n = snprintf(out, kMaxInt64Chars, "%" PRId64, i);
+  buf->SetLengthFrom(reinterpret_cast<uint8_t*>(out + n));
+}
+
+void WriteFloat(double f, mylib::BufWriter* buf) {
+  buf->EnsureMoreSpace(kDoubleBufSize);
+
+  char* out = reinterpret_cast<char*>(buf->LengthPointer());
+  int n = FormatDouble(f, out);
+  buf->SetLengthFrom(reinterpret_cast<uint8_t*>(out + n));
+}
+
+//
+// For data_lang/bin8.py.  Byte order is explicit, so the output is the same
+// on any host.
+//
+
+void WriteInt64(mops::BigInt i, mylib::BufWriter* buf) {
+  buf->EnsureMoreSpace(8);
+
+  uint8_t* out = buf->LengthPointer();
+  uint64_t u = static_cast<uint64_t>(i);
+  for (int k = 0; k < 8; ++k) {
+    out[k] = (u >> (8 * k)) & 0xFF;
+  }
+  buf->SetLengthFrom(out + 8);
+}
+
+mops::BigInt ReadInt64(BigStr* s, int pos) {
+  DCHECK(0 <= pos && pos + 8 <= len(s));
+
+  uint8_t* in = reinterpret_cast<uint8_t*>(s->data_ + pos);
+  uint64_t u = 0;
+  for (int k = 0; k < 8; ++k) {
+    u |= static_cast<uint64_t>(in[k]) << (8 * k);
+  }
+  return static_cast<mops::BigInt>(u);
+}
+
+void WriteFloat64(double f, mylib::BufWriter* buf) {
+  int64_t bits;
+  memcpy(&bits, &f, sizeof(bits));
+  WriteInt64(bits, buf);
+}
+
+double ReadFloat64(BigStr* s, int pos) {
+  int64_t bits = ReadInt64(s, pos);
+  double f;
+  memcpy(&f, &bits, sizeof(f));
+  return f;
+}
+
+void WriteUvarint(int n, mylib::BufWriter* buf) {
+  DCHECK(n >= 0);
+  buf->EnsureMoreSpace(5);  // 31 bits
+
+  uint8_t* out = buf->LengthPointer();
+  uint32_t u = n;
+  while (u >= 0x80) {
+    *out++ = (u & 0x7F) | 0x80;
+    u >>= 7;
+  }
+  *out++ = u;
+  buf->SetLengthFrom(out);
+}
+
+Tuple2<int, int> ReadUvarint(BigStr* s, int pos) {
+  uint8_t* in = reinterpret_cast<uint8_t*>(s->data_);
+  int n = len(s);
+
+  int64_t result = 0;
+  int shift = 0;
+  for (int i = pos; i < n; ++i) {
+    if (shift > 28) {  // more than 5 bytes
+      break;
+    }
+    uint8_t b = in[i];
+    result |= static_cast<int64_t>(b & 0x7F) << shift;
+    if (result >= (1LL << 31)) {
+      break;
+    }
+    if (b < 0x80) {
+      return Tuple2<int, int>(static_cast<int>(result), i + 1);
+    }
+    shift += 7;
+  }
+  return Tuple2<int, int>(-1, pos);
+}
+
 }  // namespace pyj8
 
 namespace j8 {
@@ -21,8 +21,31 @@ namespace pyj8 {
 
 bool PartIsUtf8(BigStr* s, int start, int end);
 
+int FindPlainStrEnd(BigStr* s, int start, bool double_quoted);
+
 void WriteString(BigStr* s, int options, mylib::BufWriter* buf);
 
+void WriteBigInt(mops::BigInt i, mylib::BufWriter* buf);
+
+void WriteFloat(double f, mylib::BufWriter* buf);
+
+// BigInt is int64_t in C++, so it always fits
+inline bool FitsInInt64(mops::BigInt i) {
+  return true;
+}
+
+void WriteInt64(mops::BigInt i, mylib::BufWriter* buf);
+
+mops::BigInt ReadInt64(BigStr* s, int pos);
+
+void WriteFloat64(double f, mylib::BufWriter* buf);
+
+double ReadFloat64(BigStr* s, int pos);
+
+void WriteUvarint(int n, mylib::BufWriter* buf);
+
+Tuple2<int, int> ReadUvarint(BigStr* s, int pos);
+
 }  // namespace pyj8
 
 namespace j8 {
@@ -26,6 +26,32 @@ TEST PartIsUtf8_test() {
   PASS();
 }
 
+TEST FindPlainStrEnd_test() {
+  BigStr* s = StrFromC("\"hello world\"");
+  ASSERT_EQ(12, pyj8::FindPlainStrEnd(s, 1, true));
+
+  // no closing quote
+  ASSERT_EQ(-1, pyj8::FindPlainStrEnd(s, len(s), true));
+
+  // escapes and control chars aren't plain
+  s = StrFromC("\"0123456789 abcdef \\n\"");
+  ASSERT_EQ(-1, pyj8::FindPlainStrEnd(s, 1, true));
+  s = StrFromC("\"0123456789 abcdef \n\"");
+  ASSERT_EQ(-1, pyj8::FindPlainStrEnd(s, 1, true));
+
+  // valid UTF-8 is plain, invalid UTF-8 isn't
+  s = StrFromC("\"0123456789 \u03bc abcdef\"");
+  ASSERT_EQ(len(s) - 1, pyj8::FindPlainStrEnd(s, 1, true));
+  s = StrFromC("\"0123456789 \xff abcdef\"");
+  ASSERT_EQ(-1, pyj8::FindPlainStrEnd(s, 1, true));
+
+  // J8 strings like b'' end with ', and may contain "
+  s = StrFromC("b'0123456789 \" abcdef'");
+  ASSERT_EQ(len(s) - 1, pyj8::FindPlainStrEnd(s, 2, false));
+
+  PASS();
+}
+
 // TODO: remove duplication
 #define LOSSY_JSON (1 << 3)
 
@@ -52,6 +78,85 @@ TEST WriteString_test() {
   PASS();
 }
 
+TEST WriteNumber_test() {
+  // Same output as mops::ToStr() and str(double)
+  mops::BigInt ints[] = {0, -1, 42, INT64_MAX, INT64_MIN};
+  for (unsigned i = 0; i < sizeof(ints) / sizeof(ints[0]); ++i) {
+    auto buf = Alloc<mylib::BufWriter>();
+    buf->write(StrFromC("x="));
+    pyj8::WriteBigInt(ints[i], buf);
+    ASSERT(str_equals(str_concat(StrFromC("x="), mops::ToStr(ints[i])),
+                      buf->getvalue()));
+  }
+
+  double floats[] = {0.0, -0.0, 1.5, 3.0, -42.0, 1e300, 1.0 / 3, 5e-324};
+  for (unsigned i = 0; i < sizeof(floats) / sizeof(floats[0]); ++i) {
+    auto buf = Alloc<mylib::BufWriter>();
+    buf->write(StrFromC("x="));
+    pyj8::WriteFloat(floats[i], buf);
+    ASSERT(str_equals(str_concat(StrFromC("x="), str(floats[i])),
+                      buf->getvalue()));
+  }
+
+  // Many numbers in one buffer, so it grows
+  auto buf = Alloc<mylib::BufWriter>();
+  for (int i = 0; i < 1000; ++i) {
+    pyj8::WriteBigInt(INT64_MIN, buf);
+    pyj8::WriteFloat(1.0 / 3, buf);
+  }
+  ASSERT_EQ(1000 * (20 + 18), len(buf->getvalue()));
+
+  PASS();
+}
+
+TEST binary_numbers_test() {
+  // Same bytes on any host
+  auto buf = Alloc<mylib::BufWriter>();
+  pyj8::WriteInt64(0x0102030405060708LL, buf);
+  pyj8::WriteUvarint(300, buf);
+  BigStr* s = buf->getvalue();
+  BigStr* expected = StrFromC("\x08\x07\x06\x05\x04\x03\x02\x01\xac\x02");
+  ASSERT(str_equals(expected, s));
+
+  ASSERT_EQ(0x0102030405060708LL, pyj8::ReadInt64(s, 0));
+  Tuple2<int, int> tup = pyj8::ReadUvarint(s, 8);
+  ASSERT_EQ(300, tup.at0());
+  ASSERT_EQ(10, tup.at1());
+
+  // Round trips
+  mops::BigInt ints[] = {0, -1, 42, INT64_MAX, INT64_MIN};
+  double floats[] = {0.0, -0.0, 1.5, 1.0 / 3, 1e300, -5e-324};
+  int lengths[] = {0, 1, 127, 128, 16383, 16384, INT32_MAX};
+  for (int i = 0; i < 5; ++i) {
+    buf = Alloc<mylib::BufWriter>();
+    pyj8::WriteInt64(ints[i], buf);
+    ASSERT_EQ(ints[i], pyj8::ReadInt64(buf->getvalue(), 0));
+  }
+  for (int i = 0; i < 6; ++i) {
+    buf = Alloc<mylib::BufWriter>();
+    pyj8::WriteFloat64(floats[i], buf);
+    double f = pyj8::ReadFloat64(buf->getvalue(), 0);
+    ASSERT_EQ(0, memcmp(&f, &floats[i], sizeof(f)));  // -0.0 too
+  }
+  for (int i = 0; i < 7; ++i) {
+    buf = Alloc<mylib::BufWriter>();
+    pyj8::WriteUvarint(lengths[i], buf);
+    tup = pyj8::ReadUvarint(buf->getvalue(), 0);
+    ASSERT_EQ(lengths[i], tup.at0());
+  }
+
+  // Truncated, too many bytes, too big
+  const char* bad[] = {"", "\x80", "\x80\x80\x80\x80\x80\x01",
+                       "\xff\xff\xff\xff\x08"};
+  for (int i = 0; i < 4; ++i) {
+    tup = pyj8::ReadUvarint(StrFromC(bad[i]), 0);
+    ASSERT_EQ(-1, tup.at0());
+    ASSERT_EQ(0, tup.at1());
+  }
+
+  PASS();
+}
+
 TEST compare_c_test() {
   // Compare two implementations
 
@@ -166,7 +271,10 @@ int main(int argc, char** argv) {
   GREATEST_MAIN_BEGIN();
 
   RUN_TEST(PartIsUtf8_test);
+  RUN_TEST(FindPlainStrEnd_test);
   RUN_TEST(WriteString_test);
+  RUN_TEST(WriteNumber_test);
+  RUN_TEST(binary_numbers_test);
   RUN_TEST(compare_c_test);
   RUN_TEST(heap_id_test);
   RUN_TEST(utf8_decode_one_test);
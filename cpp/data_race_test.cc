@@ -65,11 +65,11 @@ TEST list_test() {
 }
 
 void* SimulateSignalHandlers(void* p) {
-  auto signal_safe = static_cast<pyos::SignalSafe*>(p);
+  auto signal_safe = static_cast<iolib::SignalSafe*>(p);
 
-  // Send a whole bunch of SIGINT in a tight loop, which will append to
-  // List<int> signal_queue_.
-  for (int i = 0; i < pyos::kMaxPendingSignals + 10; ++i) {
+  // Send a whole bunch of SIGINT in a tight loop, which will be queued in the
+  // ring, or coalesced.
+  for (int i = 0; i < 10 * iolib::kSignalRingSize; ++i) {
     // This line can race with PollSigInt and LastSignal
     signal_safe->UpdateFromSignalHandler(SIGINT);
 
@@ -80,7 +80,7 @@ void* SimulateSignalHandlers(void* p) {
 }
 
 TEST take_pending_signals_test() {
-  pyos::SignalSafe signal_safe;
+  iolib::SignalSafe signal_safe;
 
   // Background thread that simulates signal handler
   pthread_t t;
@@ -101,24 +101,80 @@ TEST take_pending_signals_test() {
   PASS();
 }
 
+const int kNumRounds = 10000;
+
+void* SendEverySignal(void* p) {
+  auto signal_safe = static_cast<iolib::SignalSafe*>(p);
+
+  for (int i = 0; i < kNumRounds; ++i) {
+    for (int sig_num = 1; sig_num < NSIG; ++sig_num) {
+      signal_safe->UpdateFromSignalHandler(sig_num);
+    }
+  }
+  return nullptr;
+}
+
+// The ring is written by one "thread" and read by another.  Every kind of
+// signal must come out, and each one only once per TakePendingSignals(), no
+// matter how they interleave.
+//
+// #define LOCK_FREE_ATOMICS in mycpp/gc_iolib.h makes this PASS ThreadSanitizer
+TEST ring_stress_test() {
+  iolib::SignalSafe signal_safe;
+
+  int counts[NSIG] = {0};
+
+  pthread_t t;
+  pthread_create(&t, 0, SendEverySignal, &signal_safe);
+
+  bool done = false;
+  while (!done) {
+    // Check for exit BEFORE taking, so the last take sees everything
+    done = pthread_tryjoin_np(t, nullptr) == 0;
+
+    List<int>* received = signal_safe.TakePendingSignals();
+    ASSERT(len(received) <= NSIG - 1);
+
+    bool seen[NSIG] = {false};
+    for (int i = 0; i < len(received); ++i) {
+      int sig_num = received->at(i);
+      ASSERT(1 <= sig_num && sig_num < NSIG);
+      ASSERT(!seen[sig_num]);  // coalesced
+      seen[sig_num] = true;
+      counts[sig_num]++;
+    }
+    received->clear();
+    signal_safe.ReuseEmptyList(received);
+  }
+  ASSERT(!signal_safe.HasPendingSignals());
+
+  for (int sig_num = 1; sig_num < NSIG; ++sig_num) {
+    ASSERT(counts[sig_num] >= 1);
+    ASSERT(counts[sig_num] <= kNumRounds);
+  }
+  log("SIGUSR1 taken %d times in %d rounds", counts[SIGUSR1], kNumRounds);
+
+  PASS();
+}
+
 TEST set_sigwinch_test() {
-  pyos::SignalSafe signal_safe;
+  iolib::SignalSafe signal_safe;
 
   // Background thread that simulates signal handler
   pthread_t t;
   pthread_create(&t, 0, SimulateSignalHandlers, &signal_safe);
 
   // Concurrent access in main thread
-  signal_safe.SetSigWinchCode(pyos::UNTRAPPED_SIGWINCH);
+  signal_safe.SetSigWinchCode(iolib::UNTRAPPED_SIGWINCH);
 
   pthread_join(t, 0);
   PASS();
 }
 
-// #define LOCK_FREE_ATOMICS in core.h makes this PASS ThreadSanitizer
+// #define LOCK_FREE_ATOMICS in mycpp/gc_iolib.h makes this PASS ThreadSanitizer
 
 TEST last_signal_test() {
-  pyos::SignalSafe signal_safe;
+  iolib::SignalSafe signal_safe;
 
   // Background thread that simulates signal handler
   pthread_t t;
@@ -133,7 +189,7 @@ TEST last_signal_test() {
 }
 
 TEST poll_sigint_test() {
-  pyos::SignalSafe signal_safe;
+  iolib::SignalSafe signal_safe;
 
   // Background thread that simulates signal handler
   pthread_t t;
@@ -148,7 +204,7 @@ TEST poll_sigint_test() {
 }
 
 TEST poll_sigwinch_test() {
-  pyos::SignalSafe signal_safe;
+  iolib::SignalSafe signal_safe;
 
   // Background thread that simulates signal handler
   pthread_t t;
@@ -189,6 +245,7 @@ int main(int argc, char** argv) {
 
   // SignalSafe tests
   RUN_TEST(take_pending_signals_test);
+  RUN_TEST(ring_stress_test);
   RUN_TEST(set_sigwinch_test);
   RUN_TEST(last_signal_test);
   RUN_TEST(poll_sigint_test);
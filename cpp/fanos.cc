@@ -13,9 +13,8 @@
 
 namespace fanos {
 
-void send(int sock_fd, BigStr* blob) {
-  // TODO: Support this argument
-  int fds[FANOS_NUM_FDS] = {-1, -1, -1};
+void send(int sock_fd, BigStr* blob, int fd0, int fd1, int fd2) {
+  int fds[FANOS_NUM_FDS] = {fd0, fd1, fd2};
 
   FanosError err = {0};
   fanos_send(sock_fd, blob->data(), len(blob), fds, &err);
@@ -54,4 +53,37 @@ BigStr* recv(int sock_fd, List<int>* fd_out) {
   return ret;
 }
 
+int listen(BigStr* path) {
+  FanosError err = {0};
+  int sock_fd = fanos_listen(path->data(), &err);
+  if (err.err_code != 0) {
+    throw Alloc<IOError>(err.err_code);
+  }
+  if (err.value_err != nullptr) {
+    throw Alloc<ValueError>(StrFromC(err.value_err));
+  }
+  return sock_fd;
+}
+
+int accept(int listen_fd) {
+  FanosError err = {0};
+  int conn_fd = fanos_accept(listen_fd, &err);
+  if (err.err_code != 0) {
+    throw Alloc<IOError>(err.err_code);
+  }
+  return conn_fd;
+}
+
+int connect(BigStr* path) {
+  FanosError err = {0};
+  int sock_fd = fanos_connect(path->data(), &err);
+  if (err.err_code != 0) {
+    throw Alloc<IOError>(err.err_code);
+  }
+  if (err.value_err != nullptr) {
+    throw Alloc<ValueError>(StrFromC(err.value_err));
+  }
+  return sock_fd;
+}
+
 }  // namespace fanos
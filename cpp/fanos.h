@@ -7,12 +7,23 @@
 
 namespace fanos {
 
-void send(int sock_fd, BigStr* blob);
+// Sends the blob, and up to 3 file descriptors.  -1 means no descriptor.
+void send(int sock_fd, BigStr* blob, int fd0 = -1, int fd1 = -1,
+          int fd2 = -1);
 
 // Returns the decoded netstring payload and file descriptors.  The payload is
 // nullptr (Python None) on EOF.
 BigStr* recv(int sock_fd, List<int>* fd_out);
 
+// Returns a Unix socket listening at the path.
+int listen(BigStr* path);
+
+// Returns a connection accepted on the listening socket.
+int accept(int listen_fd);
+
+// Returns a Unix socket connected to the path.
+int connect(BigStr* path);
+
 }  // namespace fanos
 
 #endif  // FANOS_H
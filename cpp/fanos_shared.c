@@ -1,12 +1,19 @@
+#ifndef _GNU_SOURCE
+  #define _GNU_SOURCE  // struct ucred
+#endif
+
 #include "cpp/fanos_shared.h"
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>   // fcntl
 #include <stdarg.h>  // va_list, etc.
 #include <stdio.h>   // vfprintf
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
+#include <sys/stat.h>  // umask
+#include <sys/un.h>    // sockaddr_un
 #include <unistd.h>
 
 #define SIZEOF_FDS (sizeof(int) * FANOS_NUM_FDS)
@@ -18,6 +25,7 @@ const char* kErrUnexpectedEof = "Unexpected EOF";
 const char* kErrMissingLength = "Expected netstring length";
 const char* kErrMissingColon = "Expected : after netstring length";
 const char* kErrMissingComma = "Expected ,";
+const char* kErrPathTooLong = "Socket path too long";
 
 void fanos_send(int sock_fd, char* blob, int blob_len, const int* fds,
                 struct FanosError* err) {
@@ -213,3 +221,128 @@ void fanos_recv(int sock_fd, int* fd_out, struct FanosResult* result_out,
   result_out->data = data_buf;
   result_out->len = expected_bytes;
 }
+
+// Sockets aren't inherited by processes that we exec.
+#ifdef SOCK_CLOEXEC
+static int socket_cloexec(void) {
+  return socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+}
+
+static int accept_cloexec(int listen_fd) {
+  return accept4(listen_fd, NULL, NULL, SOCK_CLOEXEC);
+}
+#else
+// e.g. OS X doesn't have SOCK_CLOEXEC.  Then there's a window before
+// fcntl(), but the shell doesn't run other threads.
+static int set_cloexec(int fd) {
+  if (fd >= 0 && fcntl(fd, F_SETFD, FD_CLOEXEC) < 0) {
+    int saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return -1;
+  }
+  return fd;
+}
+
+static int socket_cloexec(void) {
+  return set_cloexec(socket(AF_UNIX, SOCK_STREAM, 0));
+}
+
+static int accept_cloexec(int listen_fd) {
+  return set_cloexec(accept(listen_fd, NULL, NULL));
+}
+#endif
+
+// Fill in the address of a Unix socket.  Returns 0, or -1 if the path is too
+// long.
+static int set_socket_path(struct sockaddr_un* addr, const char* path,
+                           struct FanosError* err) {
+  addr->sun_family = AF_UNIX;
+  if (strlen(path) >= sizeof(addr->sun_path)) {
+    err->value_err = kErrPathTooLong;
+    return -1;
+  }
+  strcpy(addr->sun_path, path);
+  return 0;
+}
+
+int fanos_listen(const char* path, struct FanosError* err) {
+  struct sockaddr_un addr = {0};
+  if (set_socket_path(&addr, path, err) < 0) {
+    return -1;
+  }
+
+  int sock_fd = socket_cloexec();
+  if (sock_fd < 0) {
+    err->err_code = errno;
+    return -1;
+  }
+
+  // The socket file has mode 0600, so only our user can connect.  Setting the
+  // umask around bind() avoids a window before chmod().
+  mode_t old_mask = umask(0177);
+  int status = bind(sock_fd, (struct sockaddr*)&addr, sizeof(addr));
+  umask(old_mask);
+
+  if (status < 0 || listen(sock_fd, SOMAXCONN) < 0) {
+    err->err_code = errno;
+    close(sock_fd);
+    return -1;
+  }
+  return sock_fd;
+}
+
+// Is the process on the other end of the socket running as our user?
+static int peer_is_our_user(int conn_fd) {
+#ifdef SO_PEERCRED
+  struct ucred cred;
+  socklen_t len = sizeof(cred);
+  if (getsockopt(conn_fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) < 0) {
+    return 0;
+  }
+  return cred.uid == geteuid();
+#else
+  uid_t uid;
+  gid_t gid;
+  if (getpeereid(conn_fd, &uid, &gid) < 0) {
+    return 0;
+  }
+  return uid == geteuid();
+#endif
+}
+
+int fanos_accept(int listen_fd, struct FanosError* err) {
+  while (1) {
+    int conn_fd = accept_cloexec(listen_fd);
+    if (conn_fd >= 0) {
+      if (peer_is_our_user(conn_fd)) {
+        return conn_fd;
+      }
+      close(conn_fd);  // e.g. the socket's directory is shared
+      continue;
+    }
+    if (errno != EINTR) {
+      err->err_code = errno;
+      return -1;
+    }
+  }
+}
+
+int fanos_connect(const char* path, struct FanosError* err) {
+  struct sockaddr_un addr = {0};
+  if (set_socket_path(&addr, path, err) < 0) {
+    return -1;
+  }
+
+  int sock_fd = socket_cloexec();
+  if (sock_fd < 0) {
+    err->err_code = errno;
+    return -1;
+  }
+  if (connect(sock_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+    err->err_code = errno;
+    close(sock_fd);
+    return -1;
+  }
+  return sock_fd;
+}
@@ -46,4 +46,20 @@ void fanos_send(int sock_fd, char* blob, int blob_len, const int* fds,
 void fanos_recv(int sock_fd, int* fd_out, struct FanosResult* result_out,
                 struct FanosError* err);
 
+// Sockets returned by these functions are close-on-exec.
+
+// Create a Unix socket bound to the given path, and listen on it.  The socket
+// has mode 0600.  Returns the socket descriptor, or -1 on failure, with `err`
+// populated.
+int fanos_listen(const char* path, struct FanosError* err);
+
+// Accept a connection on a listening socket, retrying if interrupted by a
+// signal.  Connections from other users are closed and skipped.  Returns the
+// new descriptor, or -1 on failure, with `err` populated.
+int fanos_accept(int listen_fd, struct FanosError* err);
+
+// Connect to a Unix socket listening at the given path.  Returns the socket
+// descriptor, or -1 on failure, with `err` populated.
+int fanos_connect(const char* path, struct FanosError* err);
+
 #endif  // FANOS_SHARED_H
@@ -4,6 +4,7 @@
 #include <errno.h>       // errno, EINTR
 #include <signal.h>      // SIGINT
 #include <stdio.h>       // required for readline/readline.h (man readline)
+#include <string.h>      // strncmp(), strstr()
 #include <sys/select.h>  // select(), FD_ISSET, FD_SET, FD_ZERO
 
 #include "_build/detected-cpp-config.h"
@@ -305,6 +306,27 @@ BigStr* Readline::get_history_item(int pos) {
 #endif
 }
 
+int Readline::search_history(BigStr* needle, bool prefix_only) {
+#if HAVE_READLINE
+  // Like get_history_item(), but doesn't make a string for each item
+  int length = get_current_history_length();
+  int n = len(needle);
+  for (int i = length; i >= 1; --i) {
+    HIST_ENTRY* hist_ent = history_get(i);
+    if (hist_ent == nullptr) {
+      continue;
+    }
+    if (prefix_only ? strncmp(hist_ent->line, needle->data(), n) == 0
+                    : strstr(hist_ent->line, needle->data()) != nullptr) {
+      return i;
+    }
+  }
+  return -1;
+#else
+  assert(0);  // not implemented
+#endif
+}
+
 int Readline::get_current_history_length() {
 #if HAVE_READLINE
   HISTORY_STATE* hist_st = history_get_history_state();
@@ -41,6 +41,7 @@ class Readline {
   int get_endidx();
   void clear_history();
   BigStr* get_history_item(int pos);
+  int search_history(BigStr* needle, bool prefix_only);
   void remove_history_item(int pos);
   int get_current_history_length();
   void resize_terminal();
@@ -8,6 +8,7 @@
 #include <fcntl.h>      // open
 #include <math.h>       // isinf, isnan
 #include <signal.h>     // kill
+#include <spawn.h>      // posix_spawn
 #include <sys/stat.h>   // umask
 #include <sys/types.h>  // umask
 #include <sys/wait.h>   // WUNTRACED
@@ -86,8 +87,10 @@ mylib::File* fdopen(int fd, BigStr* c_mode) {
   return Alloc<mylib::CFile>(f);
 }
 
-void execve(BigStr* argv0, List<BigStr*>* argv,
-            Dict<BigStr*, BigStr*>* environ) {
+// Put argv and the "k=v" strings of environ in one malloc() buffer, which
+// the caller may free().
+static char* MakeArgvEnvp(List<BigStr*>* argv, Dict<BigStr*, BigStr*>* environ,
+                          char*** p_argv, char*** p_envp) {
   int n_args = len(argv);
   int n_env = len(environ);
   int combined_size = 0;
@@ -102,9 +105,9 @@ void execve(BigStr* argv0, List<BigStr*>* argv,
   const int env_size = (n_env + 1) * sizeof(char*);
   combined_size += argv_size;
   combined_size += env_size;
-  char* combined_buf = static_cast<char*>(malloc(combined_size));
+  char* result = static_cast<char*>(malloc(combined_size));
+  char* combined_buf = result;
 
-  // never deallocated
   char** _argv = reinterpret_cast<char**>(combined_buf);
   combined_buf += argv_size;
 
@@ -135,6 +138,17 @@ void execve(BigStr* argv0, List<BigStr*>* argv,
   }
   envp[n_env] = nullptr;
 
+  *p_argv = _argv;
+  *p_envp = envp;
+  return result;
+}
+
+void execve(BigStr* argv0, List<BigStr*>* argv,
+            Dict<BigStr*, BigStr*>* environ) {
+  char** _argv;
+  char** envp;
+  MakeArgvEnvp(argv, environ, &_argv, &envp);  // never deallocated
+
   int ret = ::execve(argv0->data_, _argv, envp);
   if (ret == -1) {
     throw Alloc<OSError>(errno);
@@ -144,6 +158,53 @@ void execve(BigStr* argv0, List<BigStr*>* argv,
   FAIL(kShouldNotGetHere);
 }
 
+int posix_spawn(BigStr* path, List<BigStr*>* argv,
+                Dict<BigStr*, BigStr*>* environ, List<int>* fds,
+                List<int>* new_fds, int pgid, List<int>* default_sigs) {
+  DCHECK(len(fds) == len(new_fds));
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  for (int i = 0; i < len(fds); ++i) {
+    if (new_fds->at(i) == -1) {
+      posix_spawn_file_actions_addclose(&actions, fds->at(i));
+    } else {
+      posix_spawn_file_actions_adddup2(&actions, fds->at(i), new_fds->at(i));
+    }
+  }
+
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+  short flags = POSIX_SPAWN_SETSIGDEF;
+  if (pgid != -1) {
+    flags |= POSIX_SPAWN_SETPGROUP;
+    posix_spawnattr_setpgroup(&attr, pgid);
+  }
+  sigset_t default_set;
+  sigemptyset(&default_set);
+  for (int i = 0; i < len(default_sigs); ++i) {
+    sigaddset(&default_set, default_sigs->at(i));
+  }
+  posix_spawnattr_setsigdefault(&attr, &default_set);
+  posix_spawnattr_setflags(&attr, flags);
+
+  char** _argv;
+  char** envp;
+  char* buf = MakeArgvEnvp(argv, environ, &_argv, &envp);
+
+  pid_t pid;
+  int ret = ::posix_spawn(&pid, path->data_, &actions, &attr, _argv, envp);
+
+  free(buf);
+  posix_spawnattr_destroy(&attr);
+  posix_spawn_file_actions_destroy(&actions);
+
+  if (ret != 0) {
+    throw Alloc<OSError>(ret);
+  }
+  return pid;
+}
+
 void kill(int pid, int sig) {
   if (::kill(pid, sig) != 0) {
     throw Alloc<OSError>(errno);
@@ -148,6 +148,13 @@ mylib::File* fdopen(int fd, BigStr* c_mode);
 void execve(BigStr* argv0, List<BigStr*>* argv,
             Dict<BigStr*, BigStr*>* environ);
 
+// Like fork() and execve(), but the child doesn't copy our page tables.
+// Before exec, it applies dup2(fds[i], new_fds[i]), or close(fds[i]) when
+// new_fds[i] is -1.  If pgid isn't -1, it joins that process group.
+int posix_spawn(BigStr* path, List<BigStr*>* argv,
+                Dict<BigStr*, BigStr*>* environ, List<int>* fds,
+                List<int>* new_fds, int pgid, List<int>* default_sigs);
+
 void kill(int pid, int sig);
 void killpg(int pgid, int sig);
 
@@ -1,7 +1,9 @@
 #include "cpp/stdlib.h"
 
 #include <errno.h>
+#include <signal.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 
 #include "mycpp/gc_builtins.h"
 #include "vendor/greatest.h"
@@ -66,6 +68,49 @@ TEST open_test() {
   PASS();
 }
 
+TEST posix_spawn_test() {
+  Tuple2<int, int> p = posix::pipe();
+  int r = p.at0();
+  int w = p.at1();
+
+  auto argv = NewList<BigStr*>(
+      std::initializer_list<BigStr*>{StrFromC("sh"), StrFromC("-c"),
+                                     StrFromC("echo $X")});
+  auto environ = Alloc<Dict<BigStr*, BigStr*>>();
+  environ->set(StrFromC("X"), StrFromC("hi"));
+
+  // stdout to the pipe, then close both ends
+  auto fds = NewList<int>(std::initializer_list<int>{w, r, w});
+  auto new_fds = NewList<int>(std::initializer_list<int>{1, -1, -1});
+  auto sigs = NewList<int>(std::initializer_list<int>{SIGPIPE});
+
+  int pid = posix::posix_spawn(StrFromC("/bin/sh"), argv, environ, fds,
+                               new_fds, 0, sigs);
+  posix::close(w);
+
+  char buf[16];
+  ASSERT_EQ(3, ::read(r, buf, sizeof(buf)));
+  ASSERT_EQ(0, memcmp("hi\n", buf, 3));
+  posix::close(r);
+
+  int status;
+  ASSERT_EQ(pid, ::waitpid(pid, &status, 0));
+  ASSERT_EQ(0, WEXITSTATUS(status));
+
+  // exec() errors are reported to the parent
+  bool caught = false;
+  try {
+    posix::posix_spawn(StrFromC("/nonexistent"), argv, environ,
+                       NewList<int>(), NewList<int>(), -1, NewList<int>());
+  } catch (IOError_OSError* e) {
+    ASSERT_EQ(ENOENT, e->errno_);
+    caught = true;
+  }
+  ASSERT(caught);
+
+  PASS();
+}
+
 TEST time_test() {
   int ts = time_::time();
   log("ts = %d", ts);
@@ -145,6 +190,7 @@ int main(int argc, char** argv) {
   RUN_TEST(posix_test);
   RUN_TEST(putenv_test);
   RUN_TEST(open_test);
+  RUN_TEST(posix_spawn_test);
   RUN_TEST(time_test);
   RUN_TEST(mtime_demo);
   RUN_TEST(listdir_test);
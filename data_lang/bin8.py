@@ -0,0 +1,235 @@
+#!/usr/bin/env python2
+"""
+bin8.py - A binary encoding of the J8 data model
+
+For json8 write --binary and json8 read --binary.  YSH processes can pass
+structured data to each other without escaping, unescaping, or formatting
+numbers.
+
+Every value starts with a tag byte:
+
+    n   null
+    f   false
+    t   true
+    i   Int, then 8 bytes, little endian
+    d   Float, then 8 bytes of an IEEE 754 double, little endian
+    s   Str, then a varint length, then the bytes
+    l   List, then a varint count, then the items
+    m   Dict, then a varint count, then pairs of key and value.  A key is a
+        varint length, then the bytes (no tag).
+
+Varints are unsigned LEB128, like protobuf, and are at most 31 bits.
+
+Like J8, strings are arbitrary bytes, so there's no separate bytes type.  The
+tags are printable so a hexdump is easy to read.
+"""
+from __future__ import print_function
+
+from _devbuild.gen.value_asdl import (value, value_e, value_t)
+
+from core import error
+from data_lang import j8
+from data_lang import pyj8
+from mycpp import mops
+from mycpp import mylib
+from mycpp.mylib import tagswitch, iteritems, NewDict, log
+
+from typing import cast, Dict, List
+
+_ = log
+
+
+def Encode(val, buf, type_errors):
+    # type: (value_t, mylib.BufWriter, bool) -> None
+    """For json8 write --binary (x)
+
+    Caller must handle error.Encode
+    """
+    enc = Encoder(buf, type_errors)
+    enc.Encode(val)
+
+
+def Decode(s):
+    # type: (str) -> value_t
+    """For json8 read --binary
+
+    Caller must handle error.Decode
+    """
+    dec = Decoder(s)
+    return dec.DecodeValue()
+
+
+class Encoder(object):
+
+    def __init__(self, buf, type_errors):
+        # type: (mylib.BufWriter, bool) -> None
+        self.buf = buf
+        self.type_errors = type_errors
+
+        self.visiting = j8.Visiting()
+
+    def Encode(self, val):
+        # type: (value_t) -> None
+
+        UP_val = val
+        with tagswitch(val) as case:
+            if case(value_e.Null):
+                self.buf.write('n')
+
+            elif case(value_e.Bool):
+                val = cast(value.Bool, UP_val)
+                self.buf.write('t' if val.b else 'f')
+
+            elif case(value_e.Int):
+                val = cast(value.Int, UP_val)
+                if not pyj8.FitsInInt64(val.i):
+                    raise error.Encode("Can't encode Int %s in 8 bytes" %
+                                       mops.ToStr(val.i))
+                self.buf.write('i')
+                pyj8.WriteInt64(val.i, self.buf)
+
+            elif case(value_e.Float):
+                val = cast(value.Float, UP_val)
+                self.buf.write('d')
+                pyj8.WriteFloat64(val.f, self.buf)
+
+            elif case(value_e.Str):
+                val = cast(value.Str, UP_val)
+                self.buf.write('s')
+                pyj8.WriteUvarint(len(val.s), self.buf)
+                self.buf.write(val.s)
+
+            elif case(value_e.List):
+                val = cast(value.List, UP_val)
+
+                heap_id = j8.HeapValueId(val)
+                if not self.visiting.Push(heap_id):
+                    raise error.Encode("Can't encode List%s in object cycle" %
+                                       j8.ValueIdString(val))
+
+                self.buf.write('l')
+                pyj8.WriteUvarint(len(val.items), self.buf)
+                for item in val.items:
+                    self.Encode(item)
+
+                self.visiting.Pop()
+
+            elif case(value_e.Dict):
+                val = cast(value.Dict, UP_val)
+
+                heap_id = j8.HeapValueId(val)
+                if not self.visiting.Push(heap_id):
+                    raise error.Encode("Can't encode Dict%s in object cycle" %
+                                       j8.ValueIdString(val))
+
+                self.buf.write('m')
+                pyj8.WriteUvarint(len(val.d), self.buf)
+                for k, v in iteritems(val.d):
+                    pyj8.WriteUvarint(len(k), self.buf)
+                    self.buf.write(k)
+                    self.Encode(v)
+
+                self.visiting.Pop()
+
+            else:
+                pass  # mycpp workaround
+                if self.type_errors:
+                    raise error.Encode("Can't serialize object of type %s" %
+                                       j8.ValType(val))
+                self.buf.write('n')
+
+
+class Decoder(object):
+
+    def __init__(self, s):
+        # type: (str) -> None
+        self.s = s
+        self.pos = 0
+
+    def _Error(self, msg, start_pos):
+        # type: (str, int) -> error.Decode
+
+        # There are no lines in binary data
+        return error.Decode(msg, self.s, start_pos, self.pos, 1)
+
+    def _Check(self, n):
+        # type: (int) -> None
+        """Check that there are n more bytes."""
+        if self.pos + n > len(self.s):
+            raise self._Error('Unexpected end of input', self.pos)
+
+    def _ReadLength(self):
+        # type: () -> int
+        n, next_pos = pyj8.ReadUvarint(self.s, self.pos)
+        if n == -1:
+            raise self._Error('Invalid length', self.pos)
+        self.pos = next_pos
+        return n
+
+    def _ReadBytes(self, n):
+        # type: (int) -> str
+        """One slice, so there's one allocation per string."""
+        self._Check(n)
+        end = self.pos + n
+        s = self.s[self.pos:end]
+        self.pos = end
+        return s
+
+    def _DecodeValue(self):
+        # type: () -> value_t
+        self._Check(1)
+
+        b = mylib.ByteAt(self.s, self.pos)
+        self.pos += 1
+
+        if mylib.ByteEquals(b, 'n'):
+            return value.Null
+
+        if mylib.ByteEquals(b, 't'):
+            return value.Bool(True)
+
+        if mylib.ByteEquals(b, 'f'):
+            return value.Bool(False)
+
+        if mylib.ByteEquals(b, 'i'):
+            self._Check(8)
+            big = pyj8.ReadInt64(self.s, self.pos)
+            self.pos += 8
+            return value.Int(big)
+
+        if mylib.ByteEquals(b, 'd'):
+            self._Check(8)
+            f = pyj8.ReadFloat64(self.s, self.pos)
+            self.pos += 8
+            return value.Float(f)
+
+        if mylib.ByteEquals(b, 's'):
+            n = self._ReadLength()
+            return value.Str(self._ReadBytes(n))
+
+        if mylib.ByteEquals(b, 'l'):
+            n = self._ReadLength()
+            # Don't preallocate n items, because n isn't trusted
+            items = []  # type: List[value_t]
+            for _ in xrange(n):
+                items.append(self._DecodeValue())
+            return value.List(items)
+
+        if mylib.ByteEquals(b, 'm'):
+            n = self._ReadLength()
+            d = NewDict()  # type: Dict[str, value_t]
+            for _ in xrange(n):
+                key_len = self._ReadLength()
+                k = self._ReadBytes(key_len)
+                d[k] = self._DecodeValue()
+            return value.Dict(d)
+
+        raise self._Error('Invalid tag byte', self.pos - 1)
+
+    def DecodeValue(self):
+        # type: () -> value_t
+        """Decode exactly one value, with no trailing bytes."""
+        val = self._DecodeValue()
+        if self.pos != len(self.s):
+            raise self._Error('Unexpected trailing input', self.pos)
+        return val
@@ -0,0 +1,96 @@
+#!/usr/bin/env python2
+from __future__ import print_function
+
+import unittest
+
+from _devbuild.gen.value_asdl import value
+from core import error
+from core import test_lib
+from data_lang import bin8  # module under test
+from data_lang import j8
+from mycpp import mops
+from mycpp import mylib
+
+
+def _Encode(val):
+    return test_lib.Encoded(bin8.Encode, val, True)
+
+
+class Bin8Test(unittest.TestCase):
+
+    def testRoundTrip(self):
+        for s in [
+                'null',
+                'true',
+                '[]',
+                '{}',
+                '-1',
+                '9223372036854775807',
+                '-9223372036854775808',
+                '3.14',
+                '-0.0',
+                '1e300',
+                '""',
+                '"a\\nb \u03bc"',
+                "b'\\yff\\yfe'",
+                '[1, [2, [3, {}]], {"k": [null, false]}]',
+                '{"a": 1, "b": {"c": "d"}, "": 0.5}',
+        ]:
+            val = j8.Parser(s, True).ParseValue()
+            encoded = _Encode(val)
+            decoded = bin8.Decode(encoded)
+            self.assertEqual(test_lib.J8Line(val), test_lib.J8Line(decoded))
+
+    def testFormat(self):
+        self.assertEqual('n', _Encode(value.Null))
+        self.assertEqual('t', _Encode(value.Bool(True)))
+        self.assertEqual('i\x01' + '\x00' * 7,
+                         _Encode(value.Int(mops.BigInt(1))))
+        self.assertEqual('s\x02hi', _Encode(value.Str('hi')))
+        self.assertEqual('l\x01n', _Encode(value.List([value.Null])))
+
+        # 300 needs a 2 byte varint
+        encoded = _Encode(value.Str('x' * 300))
+        self.assertEqual('s\xac\x02', encoded[:3])
+        self.assertEqual(303, len(encoded))
+
+    def testErrors(self):
+        for s, expected in [
+            ('', 'Unexpected end of input'),  # no value
+            ('x', 'Invalid tag byte'),
+            ('nn', 'Unexpected trailing input'),
+            ('i\x01', 'Unexpected end of input'),  # truncated int
+            ('s\x05abc', 'Unexpected end of input'),  # truncated string
+            ('s\xff\xff\xff\xff\xff\x01', 'Invalid length'),  # too big
+            ('l\x02n', 'Unexpected end of input'),  # too few items
+            ('m\x01\x01k', 'Unexpected end of input'),  # missing value
+        ]:
+            try:
+                bin8.Decode(s)
+            except error.Decode as e:
+                self.assertTrue(e.Message().startswith(expected),
+                                e.Message())
+            else:
+                self.fail('Expected error.Decode for %r' % s)
+
+    def testEncodeErrors(self):
+        L = value.List([])
+        L.items.append(L)
+        self.assertRaises(error.Encode, _Encode, L)
+
+        func = value.BuiltinFunc(None)
+        self.assertRaises(error.Encode, _Encode, func)
+
+        buf = mylib.BufWriter()
+        bin8.Encode(func, buf, False)
+        self.assertEqual('n', buf.getvalue())
+
+        # Python ints can be bigger than 8 bytes
+        for big in [2**63, -(2**63) - 1, 2**70]:
+            self.assertRaises(error.Encode, _Encode,
+                              value.Int(mops.BigInt(big)))
+        self.assertEqual(9, len(_Encode(value.Int(mops.BigInt(-(2**63))))))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -145,7 +145,26 @@ class Output(object):
 
 
 def MakeLexer(rules):
-    return [(re.compile(pat, re.VERBOSE), i) for (pat, i) in rules]
+    # type: (List[Tuple[str, Any]]) -> Tuple[Any, List[Any]]
+    """Compile an ordered list of (regex, id) rules into ONE regex.
+
+    Each rule becomes a group of an alternation.  Alternatives are tried left
+    to right, so the first rule that matches wins, like looping over the rules.
+    But we call into the regex engine once per token, not once per rule.
+
+    Returns the regex and a list that maps m.lastindex to the rule's id.  The
+    groups inside a rule are numbered after the rule's own group g, so the
+    first one is m.group(g + 1).
+    """
+    parts = []  # type: List[str]
+    ids = [None]  # type: List[Any]  # group 0 is the whole match
+    for pat, tok_id in rules:
+        # Newline in case the pattern ends with a VERBOSE comment
+        parts.append('(%s\n)' % pat)
+        ids.append(tok_id)
+        num_inner = re.compile(pat, re.VERBOSE).groups
+        ids.extend([None] * num_inner)
+    return re.compile('|'.join(parts), re.VERBOSE), ids
 
 
 #
@@ -280,51 +299,53 @@ class Lexer(object):
             # beginning
             return h8_id.HtmlCData, pos
 
-        # Find the first match.
+        # Find the first match, with one regex for all rules.
         # Note: frontend/match.py uses _LongestMatch(), which is different!
         # TODO: reconcile them.  This lexer should be expressible in re2c.
 
-        for pat, tok_id in HTM8_LEX_COMPILED:
-            m = pat.match(self.s, self.pos)
-            if m:
-                if tok_id in (h8_id.StartTag, h8_id.EndTag, h8_id.StartEndTag):
-                    self.tag_pos_left = m.start(1)
-                    self.tag_pos_right = m.end(1)
-                else:
-                    # Reset state
-                    self.tag_pos_left = -1
-                    self.tag_pos_right = -1
-
-                if tok_id == h8_id.CommentBegin:
-                    pos = self.s.find('-->', self.pos)
-                    if pos == -1:
-                        raise LexError('Unterminated <!--', self.s, self.pos)
-                    return h8_id.Comment, pos + 3  # -->
-
-                if tok_id == h8_id.ProcessingBegin:
-                    pos = self.s.find('?>', self.pos)
-                    if pos == -1:
-                        raise LexError('Unterminated <?', self.s, self.pos)
-                    return h8_id.Processing, pos + 2  # ?>
-
-                if tok_id == h8_id.CDataBegin:
-                    pos = self.s.find(']]>', self.pos)
-                    if pos == -1:
-                        # unterminated <![CDATA[
-                        raise LexError('Unterminated <![CDATA[', self.s,
-                                       self.pos)
-                    return h8_id.CData, pos + 3  # ]]>
-
-                if tok_id == h8_id.StartTag:
-                    # TODO: reduce allocations
-                    if (self.TagNameEquals('script') or
-                            self.TagNameEquals('style')):
-                        # <SCRipt a=b>  -> </SCRipt>
-                        self.search_state = '</' + self._LiteralTagName() + '>'
-
-                return tok_id, m.end()
-        else:
-            raise AssertionError('h8_id.Invalid rule should have matched')
+        pat, ids = HTM8_LEX_COMPILED
+        m = pat.match(self.s, self.pos)
+        if m:
+            g = m.lastindex
+            tok_id = ids[g]
+            if tok_id in (h8_id.StartTag, h8_id.EndTag, h8_id.StartEndTag):
+                self.tag_pos_left = m.start(g + 1)
+                self.tag_pos_right = m.end(g + 1)
+            else:
+                # Reset state
+                self.tag_pos_left = -1
+                self.tag_pos_right = -1
+
+            if tok_id == h8_id.CommentBegin:
+                pos = self.s.find('-->', self.pos)
+                if pos == -1:
+                    raise LexError('Unterminated <!--', self.s, self.pos)
+                return h8_id.Comment, pos + 3  # -->
+
+            if tok_id == h8_id.ProcessingBegin:
+                pos = self.s.find('?>', self.pos)
+                if pos == -1:
+                    raise LexError('Unterminated <?', self.s, self.pos)
+                return h8_id.Processing, pos + 2  # ?>
+
+            if tok_id == h8_id.CDataBegin:
+                pos = self.s.find(']]>', self.pos)
+                if pos == -1:
+                    # unterminated <![CDATA[
+                    raise LexError('Unterminated <![CDATA[', self.s,
+                                   self.pos)
+                return h8_id.CData, pos + 3  # ]]>
+
+            if tok_id == h8_id.StartTag:
+                # TODO: reduce allocations
+                if (self.TagNameEquals('script') or
+                        self.TagNameEquals('style')):
+                    # <SCRipt a=b>  -> </SCRipt>
+                    self.search_state = '</' + self._LiteralTagName() + '>'
+
+            return tok_id, m.end()
+
+        raise AssertionError('h8_id.Invalid rule should have matched')
 
     def TagNamePos(self):
         # type: () -> int
@@ -526,42 +547,44 @@ class AttrLexer(object):
           <a !>
           <a foo=bar !>
         """
-        for pat, a in A_NAME_LEX_COMPILED:
-            m = pat.match(self.s, self.pos)
-            #log('ReadName() matching %r at %d', self.s, self.pos)
-            if m:
-                #log('ReadName() tag_name_pos %d pos, %d %s', self.tag_name_pos, self.pos, m.groups())
-                if a == attr_name.Invalid:
-                    #log('m.groups %s', m.groups())
-                    return attr_name.Invalid, -1, -1, -1
-
-                self.pos = m.end(0)  # Advance if it's not invalid
-
-                if a == attr_name.Ok:
-                    #log('%r', m.groups())
-                    self.name_start = m.start(1)
-                    self.name_end = m.end(1)
-                    self.equal_end = m.end(0)  # XML conversion needs this
-                    # Is the equals sign missing?  Set state.
-                    if m.group(2) is None:
-                        self.next_value_is_missing = True
-                        # HACK: REWIND, since we don't want to consume whitespace
-                        self.pos = self.name_end
-                    else:
-                        self.next_value_is_missing = False
-                    return attr_name.Ok, self.name_start, self.name_end, self.equal_end
+        pat, ids = A_NAME_LEX_COMPILED
+        m = pat.match(self.s, self.pos)
+        #log('ReadName() matching %r at %d', self.s, self.pos)
+        if m:
+            g = m.lastindex
+            a = ids[g]
+            #log('ReadName() tag_name_pos %d pos, %d %s', self.tag_name_pos, self.pos, m.groups())
+            if a == attr_name.Invalid:
+                #log('m.groups %s', m.groups())
+                return attr_name.Invalid, -1, -1, -1
+
+            self.pos = m.end(0)  # Advance if it's not invalid
+
+            if a == attr_name.Ok:
+                #log('%r', m.groups())
+                self.name_start = m.start(g + 1)
+                self.name_end = m.end(g + 1)
+                self.equal_end = m.end(0)  # XML conversion needs this
+                # Is the equals sign missing?  Set state.
+                if m.group(g + 2) is None:
+                    self.next_value_is_missing = True
+                    # HACK: REWIND, since we don't want to consume whitespace
+                    self.pos = self.name_end
                 else:
-                    # Reset state - e.g. you must call AttrNameEquals
-                    self.name_start = -1
-                    self.name_end = -1
+                    self.next_value_is_missing = False
+                return attr_name.Ok, self.name_start, self.name_end, self.equal_end
+            else:
+                # Reset state - e.g. you must call AttrNameEquals
+                self.name_start = -1
+                self.name_end = -1
 
-                if a == attr_name.Done:
-                    return attr_name.Done, -1, -1, -1
-        else:
-            context = self.s[self.pos:]
-            #log('s %r %d', self.s, self.pos)
-            raise AssertionError('h8_id.Invalid rule should have matched %r' %
-                                 context)
+            if a == attr_name.Done:
+                return attr_name.Done, -1, -1, -1
+
+        context = self.s[self.pos:]
+        #log('s %r %d', self.s, self.pos)
+        raise AssertionError('h8_id.Invalid rule should have matched %r' %
+                             context)
 
     def _CanonicalAttrName(self):
         # type: () -> str
@@ -590,18 +613,18 @@ class AttrLexer(object):
     def _QuotedRead(self):
         # type: () -> Tuple[h8_id_t, int]
 
-        for pat, tok_id in QUOTED_VALUE_LEX_COMPILED:
-            # BUG: We can OVER-READ what the segement lexer gave us, e.g. with
-            # <a href=">"> - the inside > ends it
-            m = pat.match(self.s, self.pos)
-            if m:
-                end_pos = m.end(0)  # Advance
-                #log('_QuotedRead %r', self.s[self.pos:end_pos])
-                return tok_id, end_pos
-        else:
-            context = self.s[self.pos:self.pos + 10]
-            raise AssertionError('h8_id.Invalid rule should have matched %r' %
-                                 context)
+        pat, ids = QUOTED_VALUE_LEX_COMPILED
+        # BUG: We can OVER-READ what the segement lexer gave us, e.g. with
+        # <a href=">"> - the inside > ends it
+        m = pat.match(self.s, self.pos)
+        if m:
+            end_pos = m.end(0)  # Advance
+            #log('_QuotedRead %r', self.s[self.pos:end_pos])
+            return ids[m.lastindex], end_pos
+
+        context = self.s[self.pos:self.pos + 10]
+        raise AssertionError('h8_id.Invalid rule should have matched %r' %
+                             context)
 
     def ReadValue(self, tokens_out=None):
         # type: (Optional[List[Tuple[h8_id, int]]]) -> Tuple[attr_value_t, int, int]
@@ -625,63 +648,64 @@ class AttrLexer(object):
             return attr_value_e.Missing, -1, -1
 
         # Now read " ', unquoted or empty= is valid too.
-        for pat, a in A_VALUE_LEX_COMPILED:
-            m = pat.match(self.s, self.pos)
-            if m:
-                first_end_pos = m.end(0)
-                # We shouldn't go past the end
-                assert first_end_pos <= self.end_pos, \
-                        'first_end_pos = %d should be less than self.end_pos = %d' % (first_end_pos, self.end_pos)
-                #log('m %s', m.groups())
-
-                # Note: Unquoted value can't contain &amp; etc. now, so there
-                # is no unquoting, and no respecting tokens_raw.
-                if a == h8_val_id.UnquotedVal:
-                    if first_end_pos > self.must_not_exceed_pos:
-                        #log('first_end_pos %d', first_end_pos)
-                        #log('must_not_exceed_pos %d', self.must_not_exceed_pos)
+        pat, ids = A_VALUE_LEX_COMPILED
+        m = pat.match(self.s, self.pos)
+        if m:
+            a = ids[m.lastindex]
+            first_end_pos = m.end(0)
+            # We shouldn't go past the end
+            assert first_end_pos <= self.end_pos, \
+                    'first_end_pos = %d should be less than self.end_pos = %d' % (first_end_pos, self.end_pos)
+            #log('m %s', m.groups())
+
+            # Note: Unquoted value can't contain &amp; etc. now, so there
+            # is no unquoting, and no respecting tokens_raw.
+            if a == h8_val_id.UnquotedVal:
+                if first_end_pos > self.must_not_exceed_pos:
+                    #log('first_end_pos %d', first_end_pos)
+                    #log('must_not_exceed_pos %d', self.must_not_exceed_pos)
+                    raise LexError(
+                        'Ambiguous slash: last attribute should be quoted',
+                        self.s, first_end_pos)
+                self.pos = first_end_pos  # Advance
+                return attr_value_e.Unquoted, m.start(0), first_end_pos
+
+            # TODO: respect tokens_out
+            if a == h8_val_id.DoubleQuote:
+                self.pos = first_end_pos
+                while True:
+                    tok_id, q_end_pos = self._QuotedRead()
+                    #log('self.pos %d q_end_pos %d', self.pos, q_end_pos)
+                    if tok_id == h8_id.Invalid:
                         raise LexError(
-                            'Ambiguous slash: last attribute should be quoted',
-                            self.s, first_end_pos)
-                    self.pos = first_end_pos  # Advance
-                    return attr_value_e.Unquoted, m.start(0), first_end_pos
-
-                # TODO: respect tokens_out
-                if a == h8_val_id.DoubleQuote:
-                    self.pos = first_end_pos
-                    while True:
-                        tok_id, q_end_pos = self._QuotedRead()
-                        #log('self.pos %d q_end_pos %d', self.pos, q_end_pos)
-                        if tok_id == h8_id.Invalid:
-                            raise LexError(
-                                'ReadValue() got invalid token (DQ)', self.s,
-                                self.pos)
-                        if tok_id == h8_id.DoubleQuote:
-                            right_pos = self.pos
-                            self.pos = q_end_pos  # Advance past "
-                            return attr_value_e.DoubleQuoted, first_end_pos, right_pos
-                        self.pos = q_end_pos  # Advance _QuotedRead
-
-                # TODO: respect tokens_out
-                if a == h8_val_id.SingleQuote:
-                    self.pos = first_end_pos
-                    while True:
-                        tok_id, q_end_pos = self._QuotedRead()
-                        if tok_id == h8_id.Invalid:
-                            raise LexError(
-                                'ReadValue() got invalid token (SQ)', self.s,
-                                self.pos)
-                        if tok_id == h8_id.SingleQuote:
-                            right_pos = self.pos
-                            self.pos = q_end_pos  # Advance past "
-                            return attr_value_e.SingleQuoted, first_end_pos, right_pos
-                        self.pos = q_end_pos  # Advance _QuotedRead
-
-                if a == h8_val_id.NoMatch:
-                    # <a foo = >
-                    return attr_value_e.Empty, -1, -1
-        else:
-            raise AssertionError('h8_val_id.NoMatch rule should have matched')
+                            'ReadValue() got invalid token (DQ)', self.s,
+                            self.pos)
+                    if tok_id == h8_id.DoubleQuote:
+                        right_pos = self.pos
+                        self.pos = q_end_pos  # Advance past "
+                        return attr_value_e.DoubleQuoted, first_end_pos, right_pos
+                    self.pos = q_end_pos  # Advance _QuotedRead
+
+            # TODO: respect tokens_out
+            if a == h8_val_id.SingleQuote:
+                self.pos = first_end_pos
+                while True:
+                    tok_id, q_end_pos = self._QuotedRead()
+                    if tok_id == h8_id.Invalid:
+                        raise LexError(
+                            'ReadValue() got invalid token (SQ)', self.s,
+                            self.pos)
+                    if tok_id == h8_id.SingleQuote:
+                        right_pos = self.pos
+                        self.pos = q_end_pos  # Advance past "
+                        return attr_value_e.SingleQuoted, first_end_pos, right_pos
+                    self.pos = q_end_pos  # Advance _QuotedRead
+
+            if a == h8_val_id.NoMatch:
+                # <a foo = >
+                return attr_value_e.Empty, -1, -1
+
+        raise AssertionError('h8_val_id.NoMatch rule should have matched')
 
 
 def GetAttrRaw(attr_lx, name):
@@ -25,6 +25,31 @@ class FunctionsTest(unittest.TestCase):
             line_num = htm8._FindLineNum(s, pos)
             print(line_num)
 
+    def testMakeLexer(self):
+        # type: () -> None
+        pat, ids = htm8.MakeLexer([
+            (r'(a) (b)?', 'AB'),
+            (r'a', 'A'),  # never matches, because the first rule wins
+            (r'(c) # comment', 'C'),
+            (r'.', 'Other'),
+        ])
+
+        m = pat.match('ax')
+        g = m.lastindex
+        self.assertEqual('AB', ids[g])
+        self.assertEqual('a', m.group(g + 1))
+        self.assertEqual(None, m.group(g + 2))
+
+        m = pat.match('c')
+        g = m.lastindex
+        self.assertEqual('C', ids[g])
+        self.assertEqual('c', m.group(g + 1))
+
+        m = pat.match('z')
+        self.assertEqual('Other', ids[m.lastindex])
+
+        self.assertEqual(None, pat.match('\n'))
+
 
 def _MakeAttrLexer(t, h, expected_tag=h8_id.StartTag):
     # type: (Any, str) -> htm8.AttrLexer
@@ -44,7 +44,7 @@ def Validate(contents, flags, counters):
 
     no_special_tags = bool(flags & NO_SPECIAL_TAGS)
     lx = htm8.Lexer(contents, no_special_tags=no_special_tags)
-    tokens = []
+    num_tokens = 0  # count them instead of holding them in memory
     start_pos = 0
     tag_stack = []
     while True:
@@ -56,7 +56,7 @@ def Validate(contents, flags, counters):
         if tok_id == h8_id.EndOfStream:
             break
 
-        tokens.append((tok_id, end_pos))
+        num_tokens += 1
 
         if tok_id == h8_id.StartEndTag:
             counters.num_start_end_tags += 1
@@ -113,7 +113,7 @@ def Validate(contents, flags, counters):
                          s=contents,
                          start_pos=start_pos)
 
-    counters.num_tokens += len(tokens)
+    counters.num_tokens += num_tokens
 
 
 def ToXml(htm8_str):
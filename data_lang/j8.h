@@ -217,6 +217,104 @@ static inline int BourneShellEncodeOne(unsigned char** p_in,
   }
 }
 
+//
+// Scanning for plain chars, 8 bytes at a time
+//
+// This is SWAR ("SIMD within a register"), not SSE2/AVX2 intrinsics, so it's
+// portable C.  It's the inner loop of both decoding and encoding:
+//
+// - the decoder can slice strings without escapes directly out of the input
+// - the encoder can memcpy() runs that don't need escaping
+
+#define J8_ONES_64 0x0101010101010101ULL
+#define J8_HIGHS_64 0x8080808080808080ULL
+
+// Nonzero if any byte of w is equal to b
+static inline uint64_t J8WordHasByte(uint64_t w, unsigned char b) {
+  uint64_t x = w ^ (J8_ONES_64 * b);  // matching bytes become 0
+  return (x - J8_ONES_64) & ~x & J8_HIGHS_64;
+}
+
+// Nonzero if any byte of w is an ASCII control char < 0x20, or has the high
+// bit set.  The subtraction can produce false positives, but only in bytes
+// ABOVE a byte that really matches, so the test on the whole word is exact.
+static inline uint64_t J8WordHasControlOrHigh(uint64_t w) {
+  return ((w - J8_ONES_64 * 0x20) | w) & J8_HIGHS_64;
+}
+
+// Returns a pointer to the first byte in [in, in_end) that can't be copied
+// verbatim between the quotes of a string: 'quote', backslash, an ASCII
+// control char, or the start of invalid UTF-8.  Returns in_end if there's no
+// such byte.
+//
+// Runs of printable ASCII are skipped a word at a time, and valid UTF-8 is
+// skipped a rune at a time.
+//
+// Like utf8_decode(), this requires a NUL terminator at or after in_end.  If
+// in_end isn't the end of the string, a valid rune may straddle it, and then
+// the returned pointer is PAST in_end.
+
+static inline unsigned char* J8ScanPlainChars(unsigned char* in,
+                                              unsigned char* in_end,
+                                              unsigned char quote) {
+  while (in < in_end) {
+    while (in_end - in >= 8) {
+      uint64_t w;
+      memcpy(&w, in, sizeof(w));  // unaligned load
+      if (J8WordHasControlOrHigh(w) || J8WordHasByte(w, quote) ||
+          J8WordHasByte(w, '\\')) {
+        break;
+      }
+      in += 8;
+    }
+    if (in >= in_end) {
+      break;
+    }
+
+    unsigned char ch = *in;
+    if (ch == quote || ch == '\\' || ch < 0x20) {
+      return in;
+    }
+    if (ch < 0x80) {
+      in++;
+      continue;
+    }
+
+    Utf8Result_t result;
+    utf8_decode(in, &result);
+    if (result.error) {
+      return in;
+    }
+    in += result.bytes_read;
+  }
+  return in;
+}
+
+// Copy a run of plain chars with memcpy(), as far as it fits in the output
+// buffer.  A UTF-8 sequence is never split, so the *EncodeOne() functions can
+// resume at *p_in.
+
+static inline void J8CopyPlainChars(unsigned char** p_in,
+                                    unsigned char* in_end,
+                                    unsigned char** p_out,
+                                    unsigned char* out_end,
+                                    unsigned char quote) {
+  unsigned char* scan_end = in_end;
+  if (out_end - *p_out < in_end - *p_in) {
+    scan_end = *p_in + (out_end - *p_out);
+  }
+  unsigned char* p = J8ScanPlainChars(*p_in, scan_end, quote);
+  if (p > scan_end) {  // the last rune doesn't fit; back up to its first byte
+    do {
+      p--;
+    } while ((*p & 0xC0) == 0x80);
+  }
+  int n = p - *p_in;
+  memcpy(*p_out, *p_in, n);
+  *p_in += n;
+  *p_out += n;
+}
+
 // Right now \u001f and \u{1f} are the longest output sequences for a byte.
 // Bug fix: we need 6 + 1 for the NUL terminator that sprintf() writes!  (Even
 // though we don't technically need it)
@@ -234,8 +332,14 @@ static inline int BourneShellEncodeOne(unsigned char** p_in,
 static inline int J8EncodeChunk(unsigned char** p_in, unsigned char* in_end,
                                 unsigned char** p_out, unsigned char* out_end,
                                 int j8_escape) {
+  // JSON strings are "", and J8 strings are b'' or u''
+  unsigned char quote = j8_escape ? '\'' : '"';
   while (*p_in < in_end && (*p_out + J8_MAX_BYTES_PER_INPUT_BYTE) <= out_end) {
     // printf("iter %d  %p < %p \n", i++, *p_out, out_end);
+    J8CopyPlainChars(p_in, in_end, p_out, out_end, quote);
+    if (*p_in >= in_end || (*p_out + J8_MAX_BYTES_PER_INPUT_BYTE) > out_end) {
+      break;
+    }
     int invalid_utf8 = J8EncodeOne(p_in, p_out, j8_escape);
     if (invalid_utf8 && !j8_escape) {  // first JSON pass got binary data?
       return invalid_utf8;             // early return
@@ -249,6 +353,10 @@ static inline int BashDollarEncodeChunk(unsigned char** p_in,
                                         unsigned char** p_out,
                                         unsigned char* out_end) {
   while (*p_in < in_end && (*p_out + J8_MAX_BYTES_PER_INPUT_BYTE) <= out_end) {
+    J8CopyPlainChars(p_in, in_end, p_out, out_end, '\'');
+    if (*p_in >= in_end || (*p_out + J8_MAX_BYTES_PER_INPUT_BYTE) > out_end) {
+      break;
+    }
     BashDollarEncodeOne(p_in, p_out);
   }
   return 0;
@@ -259,6 +367,10 @@ static inline int BourneShellEncodeChunk(unsigned char** p_in,
                                          unsigned char** p_out,
                                          unsigned char* out_end) {
   while (*p_in < in_end && (*p_out + J8_MAX_BYTES_PER_INPUT_BYTE) <= out_end) {
+    J8CopyPlainChars(p_in, in_end, p_out, out_end, '\'');
+    if (*p_in >= in_end || (*p_out + J8_MAX_BYTES_PER_INPUT_BYTE) > out_end) {
+      break;
+    }
     int cannot_encode = BourneShellEncodeOne(p_in, p_out);
     if (cannot_encode) {     // we need escaping, e.g. \u0001 or \'
       return cannot_encode;  // early return
@@ -97,6 +97,58 @@ def ValueIdString(val):
         return ' 0x%s' % mylib.hex_lower(heap_id)
 
 
+# Ancestors up to this depth are found with a linear scan, without hashing
+_MAX_SCAN_DEPTH = 32
+
+
+class Visiting(object):
+    """Cycle detection for encoders and printers.
+
+    A List, Dict, or Obj is in a cycle iff it's one of its own ancestors.  So
+    we keep a stack of the containers being visited, not a set of every
+    container seen, and a big acyclic value uses O(depth) memory.
+
+    Most values are shallow, so a linear scan of the stack is cheaper than
+    hashing.  Entries below _MAX_SCAN_DEPTH are also indexed in a Dict, so
+    very deep values aren't quadratic.
+    """
+
+    def __init__(self):
+        # type: () -> None
+        self.stack = []  # type: List[int]
+        self.deep = {}  # type: Dict[int, bool]
+
+    def Push(self, heap_id):
+        # type: (int) -> bool
+        """Returns False, without pushing, if heap_id is being visited."""
+        stack = self.stack
+        n = len(stack)
+        i = 0
+        while i < n and i < _MAX_SCAN_DEPTH:
+            if stack[i] == heap_id:
+                return False
+            i += 1
+
+        if n >= _MAX_SCAN_DEPTH:
+            if heap_id in self.deep:
+                return False
+            self.deep[heap_id] = True
+
+        stack.append(heap_id)
+        return True
+
+    def Pop(self):
+        # type: () -> None
+        heap_id = self.stack.pop()
+        if len(self.stack) >= _MAX_SCAN_DEPTH:
+            mylib.dict_erase(self.deep, heap_id)
+
+    def Clear(self):
+        # type: () -> None
+        del self.stack[:]
+        self.deep.clear()
+
+
 def Utf8Encode(code):
     # type: (int) -> str
     """Return utf-8 encoded bytes from a unicode code point.
@@ -140,22 +192,27 @@ NON_DATA_IS_NULL = 1 << 6
 NON_DATA_IS_ERROR = 1 << 7
 # Otherwise, non-data objects like Eggex will be <Eggex 0xff>
 
+# json write --compact flushes output in chunks of about this size
+STREAM_CHUNK_SIZE = 4096
+
 # Hack until we fully translate
 assert pyj8.LOSSY_JSON_STRINGS == LOSSY_JSON_STRINGS
 
 
-def _Print(val, buf, indent, options=0):
-    # type: (value_t, mylib.BufWriter, int, int) -> None
+def _Print(val, buf, indent, options=0, stream_out=None):
+    # type: (value_t, mylib.BufWriter, int, int, Optional[mylib.Writer]) -> None
     """
     Args:
       indent: number of spaces to indent, or -1 for everything on one line
+      stream_out: if set, buf is flushed to it as it fills up
     """
     p = InstancePrinter(buf, indent, options)
+    p.stream_out = stream_out
     p.Print(val)
 
 
-def PrintMessage(val, buf, indent, type_errors):
-    # type: (value_t, mylib.BufWriter, int, bool) -> None
+def PrintMessage(val, buf, indent, type_errors, stream_out=None):
+    # type: (value_t, mylib.BufWriter, int, bool, Optional[mylib.Writer]) -> None
     """ For json8 write (x) and toJson8() 
 
     Caller must handle error.Encode
@@ -165,11 +222,11 @@ def PrintMessage(val, buf, indent, type_errors):
         options |= NON_DATA_IS_ERROR
     else:
         options |= NON_DATA_IS_NULL
-    _Print(val, buf, indent, options=options)
+    _Print(val, buf, indent, options=options, stream_out=stream_out)
 
 
-def PrintJsonMessage(val, buf, indent, type_errors):
-    # type: (value_t, mylib.BufWriter, int, bool) -> None
+def PrintJsonMessage(val, buf, indent, type_errors, stream_out=None):
+    # type: (value_t, mylib.BufWriter, int, bool, Optional[mylib.Writer]) -> None
     """ For json write (x) and toJson()
 
     Caller must handle error.Encode()
@@ -180,7 +237,7 @@ def PrintJsonMessage(val, buf, indent, type_errors):
         options |= NON_DATA_IS_ERROR
     else:
         options |= NON_DATA_IS_NULL
-    _Print(val, buf, indent, options=options)
+    _Print(val, buf, indent, options=options, stream_out=stream_out)
 
 
 def PrintLine(val, f):
@@ -230,6 +287,20 @@ def MaybeEncodeJsonString(s):
     return buf.getvalue()
 
 
+class _PrintFrame(object):
+    """A List, Dict, or Obj that InstancePrinter has opened but not closed."""
+
+    def __init__(self, keys, items, level, right, prototype, pop_visiting):
+        # type: (Optional[List[str]], List[value_t], int, str, Optional[Obj], bool) -> None
+        self.keys = keys  # None for a List
+        self.items = items
+        self.i = 0  # index of the next item to print
+        self.level = level
+        self.right = right
+        self.prototype = prototype  # printed after an Obj is closed
+        self.pop_visiting = pop_visiting
+
+
 class InstancePrinter(object):
     """Print a value tree as J8/JSON."""
 
@@ -239,8 +310,19 @@ class InstancePrinter(object):
         self.indent = indent
         self.options = options
 
-        # Key is vm.HeapValueId(val)
-        self.visiting = {}  # type: Dict[int, bool]
+        self.visiting = Visiting()
+
+        # For json write --compact.  The caller writes what's left in buf.
+        self.stream_out = None  # type: Optional[mylib.Writer]
+
+    def _MaybeFlush(self):
+        # type: () -> None
+        """Called between items, so memory is bounded by the largest item."""
+        if self.stream_out is None:
+            return
+        if self.buf.Length() < STREAM_CHUNK_SIZE:
+            return
+        self.buf.FlushTo(self.stream_out)
 
     def _ItemIndent(self, level):
         # type: (int) -> None
@@ -270,67 +352,43 @@ class InstancePrinter(object):
             return
         self.buf.write(' ')
 
-    def _PrintList(self, val, level):
-        # type: (value.List, int) -> None
-
+    def _OpenList(self, val, level, stack):
+        # type: (value.List, int, List[_PrintFrame]) -> None
         if len(val.items) == 0:  # Special case like Python/JS
             self.buf.write('[]')
-        else:
-            self.buf.write('[')
-            self._MaybeNewline()
-            for i, item in enumerate(val.items):
-                if i != 0:
-                    self.buf.write(',')
-                    self._MaybeNewline()
-
-                self._ItemIndent(level)
-                self.Print(item, level + 1)
-            self._MaybeNewline()
+            self.visiting.Pop()
+            return
 
-            self._BracketIndent(level)
-            self.buf.write(']')
+        self.buf.write('[')
+        self._MaybeNewline()
+        stack.append(_PrintFrame(None, val.items, level, ']', None, True))
 
-    def _PrintMapping(self, d, left, right, level):
-        # type: (Dict[str, value_t], str, str, int) -> None
+    def _OpenMapping(self, d, left, right, level, prototype, pop_visiting,
+                     stack):
+        # type: (Dict[str, value_t], str, str, int, Optional[Obj], bool, List[_PrintFrame]) -> None
         if len(d) == 0:  # Special case like Python/JS
             self.buf.write(left)
             self.buf.write(right)
-        else:
-            self.buf.write(left)
-            self._MaybeNewline()
-            i = 0
-            for k, v in iteritems(d):
-                if i != 0:
-                    self.buf.write(',')
-                    self._MaybeNewline()
-
-                self._ItemIndent(level)
-
-                pyj8.WriteString(k, self.options, self.buf)
-
-                self.buf.write(':')
-                self._MaybeSpace()
-
-                self.Print(v, level + 1)
-
-                i += 1
-
-            self._MaybeNewline()
-            self._BracketIndent(level)
-            self.buf.write(right)
-
-    def _PrintDict(self, val, level):
-        # type: (value.Dict, int) -> None
-        self._PrintMapping(val.d, '{', '}', level)
-
-    def _PrintObj(self, val, level):
-        # type: (Obj, int) -> None
-
-        self._PrintMapping(val.d, '(', ')', level)
+            self._CloseMapping(level, prototype, pop_visiting, stack)
+            return
 
-        if val.prototype:
+        self.buf.write(left)
+        self._MaybeNewline()
+        stack.append(
+            _PrintFrame(d.keys(), d.values(), level, right, prototype,
+                        pop_visiting))
+
+    def _CloseMapping(self, level, prototype, pop_visiting, stack):
+        # type: (int, Optional[Obj], bool, List[_PrintFrame]) -> None
+        """After the closing bracket, print the prototype chain of an Obj."""
+        if prototype:
             self.buf.write(' --> ')
-            self._PrintObj(val.prototype, level)
+            # The prototype isn't cycle checked; the Obj stays on the visiting
+            # stack until its whole chain is printed
+            self._OpenMapping(prototype.d, '(', ')', level,
+                              prototype.prototype, pop_visiting, stack)
+        elif pop_visiting:
+            self.visiting.Pop()
 
     def _PrintBashPrefix(self, type_str, level):
         # type: (str, int) -> None
@@ -466,6 +524,45 @@ class InstancePrinter(object):
 
     def Print(self, val, level=0):
         # type: (value_t, int) -> None
+        """Print a value with an explicit stack of open containers, so deeply
+        nested values don't overflow the C stack."""
+        stack = []  # type: List[_PrintFrame]
+        self._PrintValue(val, level, stack)
+
+        while len(stack):
+            frame = stack[-1]
+
+            if frame.i == len(frame.items):
+                stack.pop()
+                self._MaybeNewline()
+                self._BracketIndent(frame.level)
+                self.buf.write(frame.right)
+                if frame.keys is None:
+                    self.visiting.Pop()
+                else:
+                    self._CloseMapping(frame.level, frame.prototype,
+                                       frame.pop_visiting, stack)
+                continue
+
+            if frame.i != 0:
+                # Between items, so memory is bounded by the largest item
+                self._MaybeFlush()
+                self.buf.write(',')
+                self._MaybeNewline()
+
+            self._ItemIndent(frame.level)
+            if frame.keys is not None:
+                pyj8.WriteString(frame.keys[frame.i], self.options, self.buf)
+                self.buf.write(':')
+                self._MaybeSpace()
+
+            item = frame.items[frame.i]
+            frame.i += 1
+            self._PrintValue(item, frame.level + 1, stack)
+
+    def _PrintValue(self, val, level, stack):
+        # type: (value_t, int, List[_PrintFrame]) -> None
+        """Print a scalar, or open a container by pushing it on the stack."""
 
         # special value that means everything is on one line
         # It's like
@@ -483,15 +580,9 @@ class InstancePrinter(object):
 
             elif case(value_e.Int):
                 val = cast(value.Int, UP_val)
-                # TODO: avoid intermediate allocation with
-                # self.buf.WriteBigInt(val.i)
-                #
-                # Or maybe we need pyj8.WriteBigInt() because truly BigInt may
-                # be of arbitrary length, and will need a growth strategy.
-                # Although that is not very common, so we could allocate in
-                # that case.
-
-                self.buf.write(mops.ToStr(val.i))
+                # Note: a truly arbitrary length BigInt will need a growth
+                # strategy in pyj8.WriteBigInt()
+                pyj8.WriteBigInt(val.i, self.buf)
 
             elif case(value_e.Float):
                 val = cast(value.Float, UP_val)
@@ -504,6 +595,7 @@ class InstancePrinter(object):
                         s = 'INFINITY'
                         if fl < 0:
                             s = '-' + s
+                    self.buf.write(s)
                 elif isnan_(fl):
                     if self.options & INF_NAN_ARE_NULL:
                         # JavaScript JSON lib behavior: Inf and NaN are null
@@ -512,12 +604,9 @@ class InstancePrinter(object):
                         s = 'null'
                     else:
                         s = 'NAN'
+                    self.buf.write(s)
                 else:
-                    # TODO: can we avoid intermediate allocation?
-                    # self.buf.WriteFloat(val.f)
-                    s = str(fl)
-
-                self.buf.write(s)
+                    pyj8.WriteFloat(fl, self.buf)
 
             elif case(value_e.Str):
                 val = cast(value.Str, UP_val)
@@ -530,7 +619,7 @@ class InstancePrinter(object):
                 # Cycle detection, only for containers that can be in cycles
                 heap_id = HeapValueId(val)
 
-                if self.visiting.get(heap_id, False):
+                if not self.visiting.Push(heap_id):
                     if self.options & SHOW_CYCLES:
                         # Showing the ID would be nice for pretty printing, but
                         # the problem is we'd have to show it TWICE to make it
@@ -545,9 +634,7 @@ class InstancePrinter(object):
                             "Can't encode List%s in object cycle" %
                             ValueIdString(val))
                 else:
-                    self.visiting[heap_id] = True
-                    self._PrintList(val, level)
-                    self.visiting[heap_id] = False
+                    self._OpenList(val, level, stack)
 
             elif case(value_e.Dict):
                 val = cast(value.Dict, UP_val)
@@ -555,7 +642,7 @@ class InstancePrinter(object):
                 # Cycle detection, only for containers that can be in cycles
                 heap_id = HeapValueId(val)
 
-                if self.visiting.get(heap_id, False):
+                if not self.visiting.Push(heap_id):
                     if self.options & SHOW_CYCLES:
                         self.buf.write('{...}')
                         return
@@ -565,9 +652,8 @@ class InstancePrinter(object):
                             "Can't encode Dict%s in object cycle" %
                             ValueIdString(val))
                 else:
-                    self.visiting[heap_id] = True
-                    self._PrintDict(val, level)
-                    self.visiting[heap_id] = False
+                    self._OpenMapping(val.d, '{', '}', level, None, True,
+                                      stack)
 
             elif case(value_e.Obj):
                 val = cast(Obj, UP_val)
@@ -581,7 +667,7 @@ class InstancePrinter(object):
                 # Cycle detection, only for containers that can be in cycles
                 heap_id = HeapValueId(val)
 
-                if self.visiting.get(heap_id, False):
+                if not self.visiting.Push(heap_id):
                     if self.options & SHOW_CYCLES:
                         self.buf.write('(...)')
                         return
@@ -591,9 +677,8 @@ class InstancePrinter(object):
                             "Can't encode Obj%s in object cycle" %
                             ValueIdString(val))
                 else:
-                    self.visiting[heap_id] = True
-                    self._PrintObj(val, level)
-                    self.visiting[heap_id] = False
+                    self._OpenMapping(val.d, '(', ')', level, val.prototype,
+                                      True, stack)
 
             elif case(value_e.BashArray):
                 val = cast(value.BashArray, UP_val)
@@ -645,6 +730,10 @@ class LexerDecoder(object):
         # thousands of strings.
         self.decoded = mylib.BufWriter()
 
+        # When False, strings are validated but not decoded, and the
+        # J8_String token has an empty string.  For Parser._SkipValue().
+        self.decode_strings = True
+
     def _Error(self, msg, end_pos):
         # type: (str, int) -> error.Decode
 
@@ -716,8 +805,20 @@ class LexerDecoder(object):
         # type: (Id_t, int) -> Tuple[Id_t, int, Optional[str]]
         """ Returns a string token and updates self.pos """
 
+        # Fast path: most strings have no escapes.  A native scan finds the
+        # closing quote and validates UTF-8, so we can slice the input instead
+        # of lexing it and copying parts into self.decoded.
+        double_quoted = left_id in (Id.Left_DoubleQuote, Id.Left_JDoubleQuote)
+        quote_pos = pyj8.FindPlainStrEnd(self.s, str_pos, double_quoted)
+        if quote_pos != -1:
+            self.pos = quote_pos + 1
+            if not self.decode_strings:
+                return Id.J8_String, self.pos, ''
+            return Id.J8_String, self.pos, self.s[str_pos:quote_pos]
+
+        # Slow path, which also reports errors
         while True:
-            if left_id in (Id.Left_DoubleQuote, Id.Left_JDoubleQuote):
+            if double_quoted:
                 tok_id, str_end = match.MatchJsonStrToken(self.s, str_pos)
             else:
                 tok_id, str_end = match.MatchJ8StrToken(self.s, str_pos)
@@ -753,11 +854,14 @@ class LexerDecoder(object):
             #
 
             if tok_id == Id.Lit_Chars:  # JSON and J8
-                part = self.s[str_pos:str_end]
                 if not pyj8.PartIsUtf8(self.s, str_pos, str_end):
                     raise self._Error(
                         'Invalid UTF-8 in %s string literal' % self.lang_str,
                         str_end)
+                if not self.decode_strings:
+                    str_pos = str_end
+                    continue
+                part = self.s[str_pos:str_end]
 
             # TODO: would be nice to avoid allocation in all these cases.
             # But LookupCharC() would have to change.
@@ -815,10 +919,27 @@ class LexerDecoder(object):
                 raise AssertionError(Id_str(tok_id))
 
             #log('%s part %r', Id_str(tok_id), part)
-            self.decoded.write(part)
+            if self.decode_strings:
+                self.decoded.write(part)
             str_pos = str_end
 
 
+class Poller(object):
+    """Called for each item while parsing a List or Dict.
+
+    The 'json read' builtin uses it to run traps, so a big document doesn't
+    delay them.
+    """
+
+    def __init__(self):
+        # type: () -> None
+        pass
+
+    def Poll(self):
+        # type: () -> None
+        pass
+
+
 class _Parser(object):
 
     def __init__(self, s, is_j8):
@@ -826,6 +947,7 @@ class _Parser(object):
         self.s = s
         self.is_j8 = is_j8
         self.lang_str = "J8" if is_j8 else "JSON"
+        self.poller = None  # type: Optional[Poller]
 
         self.lexer = LexerDecoder(s, is_j8, self.lang_str)
         self.tok_id = Id.Undefined_Tok
@@ -914,6 +1036,8 @@ class Parser(_Parser):
         #log('  [1] k %s  v  %s  Id %s', k, v, Id_str(self.tok_id))
 
         while self.tok_id == Id.J8_Comma:
+            if self.poller is not None:
+                self.poller.Poll()
             self._Next()
             k, v = self._ParsePair()
             d[k] = v
@@ -943,6 +1067,8 @@ class Parser(_Parser):
         items.append(self._ParseValue())
 
         while self.tok_id == Id.J8_Comma:
+            if self.poller is not None:
+                self.poller.Poll()
             self._Next()
             items.append(self._ParseValue())
 
@@ -996,18 +1122,178 @@ class Parser(_Parser):
             raise self._ParseError('Invalid token while parsing %s: %s' %
                                    (self.lang_str, Id_str(self.tok_id)))
 
-    def ParseValue(self):
-        # type: () -> value_t
-        """ Raises error.Decode. """
-        self._Next()
-        obj = self._ParseValue()
+    def _SkipPair(self):
+        # type: () -> None
+        self._Eat(Id.J8_String)
+        self._Eat(Id.J8_Colon)
+        self._SkipValue()
+
+    def _SkipValue(self):
+        # type: () -> None
+        """Like _ParseValue(), but only validate the input.
 
+        Doesn't allocate value.Dict, value.List, value.Str, etc.  The caller
+        must set self.lexer.decode_strings = False.
+        """
+        if self.tok_id == Id.J8_LBrace:
+            self._Next()
+            if self.tok_id == Id.J8_RBrace:
+                self._Next()
+                return
+
+            self._SkipPair()
+            while self.tok_id == Id.J8_Comma:
+                if self.poller is not None:
+                    self.poller.Poll()
+                self._Next()
+                self._SkipPair()
+            self._Eat(Id.J8_RBrace)
+
+        elif self.tok_id == Id.J8_LBracket:
+            self._Next()
+            if self.tok_id == Id.J8_RBracket:
+                self._Next()
+                return
+
+            self._SkipValue()
+            while self.tok_id == Id.J8_Comma:
+                if self.poller is not None:
+                    self.poller.Poll()
+                self._Next()
+                self._SkipValue()
+            self._Eat(Id.J8_RBracket)
+
+        elif self.tok_id in (Id.J8_Null, Id.J8_Bool, Id.J8_Float,
+                             Id.J8_String):
+            self._Next()
+
+        elif self.tok_id == Id.J8_Int:
+            # Same error as _ParseValue()
+            part = self.s[self.start_pos:self.end_pos]
+            self._Next()
+            ok, _ = mops.FromStr2(part)
+            if not ok:
+                raise self._ParseError('Integer is too big')
+
+        elif self.tok_id == Id.Eol_Tok:
+            raise self._ParseError('Unexpected EOF while parsing %s' %
+                                   self.lang_str)
+
+        else:  # Id.Unknown_Tok, Id.J8_{LParen,RParen}
+            raise self._ParseError('Invalid token while parsing %s: %s' %
+                                   (self.lang_str, Id_str(self.tok_id)))
+
+    def _SkipValueNoDecode(self):
+        # type: () -> None
+        self.lexer.decode_strings = False
+        self._SkipValue()
+        self.lexer.decode_strings = True
+
+    def _ParseAt(self, path, i):
+        # type: (List[value_t], int) -> Optional[value_t]
+        """Parse the value at path[i:], and skip everything else.
+
+        Returns None if there's no such value.
+        """
+        if i == len(path):
+            return self._ParseValue()
+
+        result = None  # type: Optional[value_t]
+
+        UP_elem = path[i]
+        with tagswitch(UP_elem) as case:
+            if case(value_e.Str):
+                elem = cast(value.Str, UP_elem)
+                if self.tok_id != Id.J8_LBrace:
+                    self._SkipValueNoDecode()
+                    return None
+
+                self._Next()
+                if self.tok_id == Id.J8_RBrace:
+                    self._Next()
+                    return None
+
+                while True:
+                    k = self.decoded
+                    self._Eat(Id.J8_String)
+                    self._Eat(Id.J8_Colon)
+                    if k == elem.s:
+                        # Like _ParseDict(), the last duplicate key wins
+                        result = self._ParseAt(path, i + 1)
+                    else:
+                        self._SkipValueNoDecode()
+
+                    if self.tok_id != Id.J8_Comma:
+                        break
+                    self._Next()
+                self._Eat(Id.J8_RBrace)
+
+            elif case(value_e.Int):
+                elem2 = cast(value.Int, UP_elem)
+                if self.tok_id != Id.J8_LBracket:
+                    self._SkipValueNoDecode()
+                    return None
+
+                self._Next()
+                if self.tok_id == Id.J8_RBracket:
+                    self._Next()
+                    return None
+
+                # Compare as BigInt, so an index that doesn't fit in an int
+                # is out of range, not truncated
+                index = elem2.i
+                if mops.Greater(mops.ZERO, index):
+                    # We only make one pass, so -1 isn't known until the end
+                    raise AssertionError('caller rejects negative indices')
+                j = mops.ZERO
+                while True:
+                    if mops.Equal(j, index):
+                        result = self._ParseAt(path, i + 1)
+                    else:
+                        self._SkipValueNoDecode()
+                    j = mops.Add(j, mops.ONE)
+
+                    if self.tok_id != Id.J8_Comma:
+                        break
+                    self._Next()
+                self._Eat(Id.J8_RBracket)
+
+            else:
+                raise AssertionError()  # caller checks types
+
+        return result
+
+    def _CheckTrailingInput(self):
+        # type: () -> None
         n = len(self.s)
         if self.start_pos != n:
             extra = n - self.start_pos
             #log('n %d pos %d', n, self.start_pos)
             raise self._ParseError(
                 'Got %d bytes of unexpected trailing input' % extra)
+
+    def ParseValue(self):
+        # type: () -> value_t
+        """ Raises error.Decode. """
+        self._Next()
+        obj = self._ParseValue()
+        self._CheckTrailingInput()
+        return obj
+
+    def ParseValueAt(self, path):
+        # type: (List[value_t]) -> Optional[value_t]
+        """For json read (&x, path=['items', 3, 'name'])
+
+        Only the value at the path is materialized; the rest of the document
+        is validated without allocating.  Each path element is a Str key or
+        a non-negative Int index.  Returns None if there's no value at the
+        path.
+
+        Raises error.Decode.
+        """
+        self._Next()
+        obj = self._ParseAt(path, 0)
+        self._CheckTrailingInput()
         return obj
 
 
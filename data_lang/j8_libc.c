@@ -5,13 +5,17 @@
 
 #include "data_lang/j8.h"  // EncodeRuneOrByte
 
+// The *EncodeChunk() functions may fill the buffer right up to out_end, so
+// leave room for the closing quote and the NUL terminator.
+#define J8_CLOSE_BYTES 2
+
 void EncodeBString(j8_buf_t in_buf, j8_buf_t* out_buf, int capacity) {
   // Compute pointers for the inner loop
   unsigned char* in = (unsigned char*)in_buf.data;
   unsigned char* in_end = in + in_buf.len;
 
   unsigned char* out = out_buf->data;  // mutated
-  unsigned char* out_end = out_buf->data + capacity;
+  unsigned char* out_end = out_buf->data + capacity - J8_CLOSE_BYTES;
   unsigned char** p_out = &out;
 
   J8_OUT('b');  // Left quote b''
@@ -34,7 +38,7 @@ void EncodeBString(j8_buf_t in_buf, j8_buf_t* out_buf, int capacity) {
 
     // Recompute pointers
     out = out_buf->data + out_buf->len;
-    out_end = out_buf->data + capacity;
+    out_end = out_buf->data + capacity - J8_CLOSE_BYTES;
     p_out = &out;
   }
 
@@ -52,7 +56,7 @@ void EncodeBashDollarString(j8_buf_t in_buf, j8_buf_t* out_buf, int capacity) {
   unsigned char* in_end = in + in_buf.len;
 
   unsigned char* out = out_buf->data;  // mutated
-  unsigned char* out_end = out_buf->data + capacity;
+  unsigned char* out_end = out_buf->data + capacity - J8_CLOSE_BYTES;
   unsigned char** p_out = &out;
 
   J8_OUT('$');  // Left quote b''
@@ -76,7 +80,7 @@ void EncodeBashDollarString(j8_buf_t in_buf, j8_buf_t* out_buf, int capacity) {
 
     // Recompute pointers
     out = out_buf->data + out_buf->len;
-    out_end = out_buf->data + capacity;
+    out_end = out_buf->data + capacity - J8_CLOSE_BYTES;
     p_out = &out;
   }
 
@@ -101,7 +105,7 @@ void J8EncodeString(j8_buf_t in_buf, j8_buf_t* out_buf, int j8_fallback) {
   out_buf->len = 0;  // starts out empty
 
   unsigned char* out = out_buf->data;  // mutated
-  unsigned char* out_end = out_buf->data + capacity;
+  unsigned char* out_end = out_buf->data + capacity - J8_CLOSE_BYTES;
   unsigned char** p_out = &out;
 
   J8_OUT('"');
@@ -136,7 +140,7 @@ void J8EncodeString(j8_buf_t in_buf, j8_buf_t* out_buf, int j8_fallback) {
 
     // Recompute pointers
     out = out_buf->data + out_buf->len;
-    out_end = out_buf->data + capacity;
+    out_end = out_buf->data + capacity - J8_CLOSE_BYTES;
     p_out = &out;
     // printf("[1] out %p out_end %p\n", out, out_end);
   }
@@ -170,7 +174,7 @@ void ShellEncodeString(j8_buf_t in_buf, j8_buf_t* out_buf, int ysh_fallback) {
   out_buf->len = 0;  // starts out empty
 
   unsigned char* out = out_buf->data;  // mutated
-  unsigned char* out_end = out_buf->data + capacity;
+  unsigned char* out_end = out_buf->data + capacity - J8_CLOSE_BYTES;
   unsigned char** p_out = &out;
 
   J8_OUT('\'');
@@ -209,7 +213,7 @@ void ShellEncodeString(j8_buf_t in_buf, j8_buf_t* out_buf, int ysh_fallback) {
 
     // Recompute pointers
     out = out_buf->data + out_buf->len;
-    out_end = out_buf->data + capacity;
+    out_end = out_buf->data + capacity - J8_CLOSE_BYTES;
     p_out = &out;
     // printf("[1] out %p out_end %p\n", out, out_end);
   }
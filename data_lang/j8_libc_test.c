@@ -191,6 +191,41 @@ TEST can_omit_quotes_test() {
   PASS();
 }
 
+TEST closing_quote_fits_test() {
+  // A run of plain chars can fill the buffer, and then the closing quote and
+  // NUL terminator must still fit.  Run this under ASAN.
+  const char* specials = "\x01'\xff";
+  char s[100];
+  for (int n = 0; n < 40; ++n) {
+    for (int m = 0; m < 40; ++m) {
+      for (int j = 0; j < 3; ++j) {
+        int len = 0;
+        memset(s, 'a', n);
+        len += n;
+        s[len++] = '\'';
+        memset(s + len, 'b', m);
+        len += m;
+        s[len++] = specials[j];
+        s[len] = '\0';
+
+        j8_buf_t in = {(unsigned char*)s, len};
+        j8_buf_t result = {0};
+
+        ShellEncodeString(in, &result, 0);
+        ASSERT_EQ('\'', result.data[result.len - 1]);
+        ASSERT_EQ('\0', result.data[result.len]);
+        free(result.data);
+
+        J8EncodeString(in, &result, 1);
+        ASSERT_EQ('\0', result.data[result.len]);
+        free(result.data);
+      }
+    }
+  }
+
+  PASS();
+}
+
 GREATEST_MAIN_DEFS();
 
 int main(int argc, char** argv) {
@@ -200,6 +235,7 @@ int main(int argc, char** argv) {
   RUN_TEST(shell_encode_test);
   RUN_TEST(invalid_utf8_test);
   RUN_TEST(all_bytes_test);
+  RUN_TEST(closing_quote_fits_test);
   RUN_TEST(char_int_test);
   RUN_TEST(can_omit_quotes_test);
 
@@ -208,12 +208,107 @@ TEST encode_test() {
   PASS();
 }
 
+// Encode with J8EncodeOne() only, which is the reference for the memcpy()
+// fast path in J8EncodeChunk()
+std::string EncodeOneAtATime(const char* s, int n, int j8_escape) {
+  std::string result;
+  unsigned char buf[J8_MAX_BYTES_PER_INPUT_BYTE];
+  unsigned char* in = (unsigned char*)s;
+  unsigned char* in_end = in + n;
+  while (in < in_end) {
+    unsigned char* out = buf;
+    J8EncodeOne(&in, &out, j8_escape);
+    result.append((char*)buf, out - buf);
+  }
+  return result;
+}
+
+// Encode with J8EncodeChunk() into an output buffer of the given size
+std::string EncodeInChunks(const char* s, int n, int j8_escape,
+                           int chunk_size) {
+  std::string result;
+  unsigned char buf[64];
+  unsigned char* in = (unsigned char*)s;
+  unsigned char* in_end = in + n;
+  while (in < in_end) {
+    unsigned char* out = buf;
+    J8EncodeChunk(&in, in_end, &out, buf + chunk_size, j8_escape);
+    result.append((char*)buf, out - buf);
+  }
+  return result;
+}
+
+TEST encode_chunk_test() {
+  // Runs of plain ASCII and UTF-8 of different lengths, so that small chunk
+  // sizes make the copied runs end in the middle of a multi-byte rune
+  const char* cases[] = {
+      "",
+      "abc",
+      "0123456789abcdefghijklmnopqrstuvwxyz",
+      "a \u03bc \u4000 \U0001f926 z 0123456789 \u03bc\u03bc\u03bc\u03bc",
+      "quotes ' and \" and \\ in a longer string, ok?",
+      "\u03bc\u03bc\u03bc\u03bc\u03bc\u03bc\u03bc\u03bc\u03bc\u03bc\u03bc",
+      "tab\there\nnewline \x01 \x1f end of plain text",
+      "invalid \xfe\xff UTF-8 \xce after",
+  };
+
+  for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+    const char* s = cases[i];
+    int n = strlen(s);
+    for (int j8_escape = 1; j8_escape >= 0; --j8_escape) {
+      std::string expected = EncodeOneAtATime(s, n, j8_escape);
+      for (int chunk_size = J8_MIN_CAPACITY; chunk_size <= 64; ++chunk_size) {
+        if (!j8_escape && strstr(s, "invalid")) {
+          continue;  // JSON encoding returns early
+        }
+        std::string actual = EncodeInChunks(s, n, j8_escape, chunk_size);
+        ASSERT_STR_EQ(expected.c_str(), actual.c_str());
+      }
+    }
+  }
+
+  PASS();
+}
+
+TEST scan_plain_test() {
+  // Put each kind of special byte at every position of a 40 byte buffer, so
+  // we test both the word-at-a-time loop and the byte loop.
+  const unsigned char specials[] = {'"', '\\', '\0', '\n', 0x1f, 0xff};
+
+  for (unsigned i = 0; i < sizeof(specials); ++i) {
+    for (int pos = 0; pos < 40; ++pos) {
+      unsigned char buf[41];
+      memset(buf, 'a', 40);
+      buf[40] = '\0';
+      buf[pos] = specials[i];
+
+      unsigned char* p = J8ScanPlainChars(buf, buf + 40, '"');
+      ASSERT_EQ(pos, p - buf);
+    }
+  }
+
+  // ' doesn't stop a scan for "
+  unsigned char single[] = "aaaa'aaaaaaaaaaaaaaa";
+  int n = strlen(reinterpret_cast<char*>(single));
+  ASSERT_EQ(n, J8ScanPlainChars(single, single + n, '"') - single);
+  ASSERT_EQ(4, J8ScanPlainChars(single, single + n, '\'') - single);
+
+  // Valid UTF-8 is skipped; truncated UTF-8 stops the scan
+  unsigned char utf8[] = "aaaaaaaaaa \xce\xbc \xce\xbc aaaaaaaaaa \xce";
+  n = strlen(reinterpret_cast<char*>(utf8));
+  ASSERT_EQ(n - 1, J8ScanPlainChars(utf8, utf8 + n, '"') - utf8);
+
+  PASS();
+}
+
 GREATEST_MAIN_DEFS();
 
 int main(int argc, char** argv) {
   GREATEST_MAIN_BEGIN();
 
   RUN_TEST(encode_test);
+  RUN_TEST(encode_chunk_test);
+  RUN_TEST(scan_plain_test);
 
   GREATEST_MAIN_END();
   return 0;
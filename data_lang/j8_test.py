@@ -4,8 +4,12 @@ from __future__ import print_function
 import unittest
 
 from _devbuild.gen.id_kind_asdl import Id, Id_str
+from _devbuild.gen.value_asdl import value
 from core import error
+from core import test_lib
 from data_lang import j8
+from mycpp import mops
+from mycpp import mylib
 from mycpp.mylib import log
 
 
@@ -26,6 +30,41 @@ class FunctionsTest(unittest.TestCase):
             print('Utf8Encode case %r %r' % (expected, code_point))
             self.assertEqual(expected, j8.Utf8Encode(code_point))
 
+    def testVisiting(self):
+        v = j8.Visiting()
+
+        # Deeper than _MAX_SCAN_DEPTH, so both the scan and the Dict are used
+        n = 100
+        for i in xrange(n):
+            self.assertEqual(True, v.Push(i))
+        for i in xrange(n):
+            self.assertEqual(False, v.Push(i))
+
+        for i in xrange(n):
+            v.Pop()
+        self.assertEqual([], v.stack)
+        self.assertEqual({}, v.deep)
+
+        # Siblings with the same ID aren't a cycle
+        self.assertEqual(True, v.Push(42))
+        v.Pop()
+        self.assertEqual(True, v.Push(42))
+
+    def testDeepCycle(self):
+        inner = value.List([])
+        outer = inner
+        for i in xrange(100):
+            outer = value.List([outer])
+
+        # Deep, but no cycle
+        buf = mylib.BufWriter()
+        j8.PrintMessage(outer, buf, -1, True)
+        self.assertEqual('[' * 101 + ']' * 101, buf.getvalue())
+
+        inner.items.append(outer)
+        buf = mylib.BufWriter()
+        self.assertRaises(error.Encode, j8.PrintMessage, outer, buf, -1, True)
+
 
 def _PrintTokens(lex):
     log('---')
@@ -212,6 +251,73 @@ class J8Test(unittest.TestCase):
             self.fail('Expected failure')
 
 
+class ParseValueAtTest(unittest.TestCase):
+
+    def testSelect(self):
+        doc = r'''
+        {"items": [{"name": "a", "tags": ["x\ny", "z"]},
+                   {"name": "b\u00e9", "n": 42}],
+         "meta": {"count": 2}, "meta": {"count": 3}}
+        '''
+        cases = [
+            ([value.Str('items'), value.Int(mops.IntWiden(1)),
+              value.Str('name')], value.Str('b\xc3\xa9')),
+            ([value.Str('items'), value.Int(mops.IntWiden(0)),
+              value.Str('tags'), value.Int(mops.IntWiden(0))],
+             value.Str('x\ny')),
+            # last duplicate key wins, like ParseValue()
+            ([value.Str('meta'), value.Str('count')],
+             value.Int(mops.IntWiden(3))),
+        ]
+        for path, expected in cases:
+            p = j8.Parser(doc, False)
+            self.assertEqual(test_lib.J8Line(expected),
+                             test_lib.J8Line(p.ParseValueAt(path)))
+
+        # no value at path
+        for path in [
+            [value.Str('zz')],
+            [value.Str('items'), value.Int(mops.IntWiden(2))],
+            [value.Str('items'), value.Str('name')],
+            [value.Int(mops.IntWiden(0))],
+            # doesn't fit in a C++ int
+            [value.Str('items'), value.Int(mops.BigInt(1 << 32))],
+        ]:
+            p = j8.Parser(doc, False)
+            self.assertEqual(None, p.ParseValueAt(path))
+
+        # json read rejects negative indices before parsing
+        p = j8.Parser(doc, False)
+        path = [value.Str('items'), value.Int(mops.IntWiden(-1))]
+        self.assertRaises(AssertionError, p.ParseValueAt, path)
+
+    def testErrorsInSkippedValues(self):
+        # Skipped values are still validated, with the same errors
+        path = [value.Str('a')]
+        for s in [
+                '{"a": 1, "b": [1, 2,]}',
+                '{"a": 1, "b": "\x01"}',
+                '{"a": 1, "b": "\xff"}',
+                '{"a": 1, "b": 99999999999999999999999}',
+                '{"a": 1, "b": {}} extra',
+                '{"a": 1, "b": ',
+        ]:
+            try:
+                j8.Parser(s, False).ParseValue()
+            except error.Decode as e:
+                expected = e.Message()
+            else:
+                self.fail('Expected error.Decode when parsing %r' % s)
+            self.assertTrue(expected)
+
+            try:
+                j8.Parser(s, False).ParseValueAt(path)
+            except error.Decode as e:
+                self.assertEqual(expected, e.Message())
+            else:
+                self.fail('Expected error.Decode when parsing %r' % s)
+
+
 class YajlTest(unittest.TestCase):
     """
     Note on old tests for YAJL.  Differences
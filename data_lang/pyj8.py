@@ -1,11 +1,16 @@
 #!/usr/bin/env python2
 from __future__ import print_function
 
+import struct
+
+from mycpp import mops
 from mycpp import mylib
 from mycpp.mylib import log
 
 import fastfunc
 
+from typing import Tuple
+
 _ = log
 
 LOSSY_JSON_STRINGS = 1 << 3
@@ -22,6 +27,99 @@ def WriteString(s, options, buf):
     buf.write(fastfunc.J8EncodeString(s, j8_fallback))
 
 
+def WriteBigInt(i, buf):
+    # type: (mops.BigInt, mylib.BufWriter) -> None
+    """Write an integer to the buffer.
+
+    The C++ version formats it in place, without the intermediate string.
+    """
+    buf.write(mops.ToStr(i))
+
+
+def WriteFloat(f, buf):
+    # type: (float, mylib.BufWriter) -> None
+    """Write a finite float to the buffer, like str(f).
+
+    The C++ version formats it in place, without the intermediate string.
+    """
+    buf.write(str(f))
+
+
+#
+# Fixed-size and varint numbers for data_lang/bin8.py.  The C++ versions
+# read and write bytes in place.
+#
+
+
+def FitsInInt64(i):
+    # type: (mops.BigInt) -> bool
+    """Python ints don't overflow, e.g. 2 ** 70"""
+    return mops.MAX_NEG_INT <= i.i and i.i <= mops.MAX_POS_INT
+
+
+def WriteInt64(i, buf):
+    # type: (mops.BigInt, mylib.BufWriter) -> None
+    """Write 8 bytes, little endian."""
+    buf.write(struct.pack('<q', i.i))
+
+
+def ReadInt64(s, pos):
+    # type: (str, int) -> mops.BigInt
+    """Read 8 bytes at pos, which the caller checked are there."""
+    return mops.BigInt(struct.unpack_from('<q', s, pos)[0])
+
+
+def WriteFloat64(f, buf):
+    # type: (float, mylib.BufWriter) -> None
+    """Write the 8 bytes of an IEEE 754 double, little endian."""
+    buf.write(struct.pack('<d', f))
+
+
+def ReadFloat64(s, pos):
+    # type: (str, int) -> float
+    """Read 8 bytes at pos, which the caller checked are there."""
+    return struct.unpack_from('<d', s, pos)[0]
+
+
+def WriteUvarint(n, buf):
+    # type: (int, mylib.BufWriter) -> None
+    """Write a non-negative integer as unsigned LEB128."""
+    assert n >= 0, n
+    while n >= 0x80:
+        buf.write(chr((n & 0x7F) | 0x80))
+        n >>= 7
+    buf.write(chr(n))
+
+
+def ReadUvarint(s, pos):
+    # type: (str, int) -> Tuple[int, int]
+    """Read unsigned LEB128 at pos.
+
+    Returns (value, position after it), or (-1, pos) if it's truncated or
+    doesn't fit in 31 bits.
+    """
+    n = 0
+    shift = 0
+    i = pos
+    while i < len(s):
+        if shift > 28:  # more than 5 bytes
+            return -1, pos
+        b = ord(s[i])
+        i += 1
+        n |= (b & 0x7F) << shift
+        if n >= (1 << 31):
+            return -1, pos
+        if b < 0x80:
+            return n, i
+        shift += 7
+    return -1, pos
+
+
 PartIsUtf8 = fastfunc.PartIsUtf8
 
+# Returns the position of the closing quote if the string body starting at
+# 'start' can be sliced out as is: no escapes, control chars, or invalid UTF-8.
+# Otherwise returns -1.
+FindPlainStrEnd = fastfunc.FindPlainStrEnd
+
 # vim: sw=4
@@ -0,0 +1,917 @@
+#!/usr/bin/env python2
+"""
+tsv8.py - Read and write TSV8, the table format in doc/j8-notation.md
+
+    !tsv8   age     name
+    !type   Int     Str
+            44      alice
+            33      "a\\tb"
+
+A table is decoded to a value.Table, which stores each column unboxed:
+
+    age   column_data.Int    [44, 33]
+    name  column_data.Str    arena 'alicea\tb', ends [5, 8]
+
+So there's no allocation per cell, and each column has cells of one type,
+which is the shape that column operations like sum() and sorting want.  The
+text is scanned in place, and only cells are sliced out, not lines or rows.
+
+ColumnToList() and TableToDict() box the cells, e.g. for JSON.
+
+Rules:
+
+- Cells are separated by tabs, and surrounding spaces are stripped.
+- The !type line is optional.  Without it, every column is Str.
+- Other !attr lines are allowed before the rows, and ignored for now.
+- Each row starts with an empty "gutter" cell.
+- A Str cell is unquoted, or a J8 string: "" u'' b''
+- An unquoted null is null in any column, like NA in R.  Write "null" for
+  the string.
+"""
+from __future__ import print_function
+
+from _devbuild.gen.value_asdl import (value, value_e, value_t, column_data,
+                                      column_data_e, column_data_t, Column)
+
+from core import error
+from data_lang import j8
+from data_lang import pyj8
+from mycpp import mops
+from mycpp import mylib
+from mycpp.mylib import tagswitch, iteritems, NewDict, log, isinf_, isnan_
+
+from typing import cast, Dict, List, Optional, Tuple
+
+_ = log
+
+# Column types
+_STR = 0
+_INT = 1
+_FLOAT = 2
+_BOOL = 3
+
+_TYPE_NAMES = ['Str', 'Int', 'Float', 'Bool']
+
+
+def Decode(s):
+    # type: (str) -> value.Table
+    """For fromTsv8()
+
+    Caller must handle error.Decode
+    """
+    dec = Decoder(s)
+    return dec.Decode()
+
+
+def Encode(val, buf):
+    # type: (value_t, mylib.BufWriter) -> None
+    """For toTsv8(), with a Table or a Dict of column Lists
+
+    Caller must handle error.Encode
+    """
+    enc = Encoder(buf)
+    enc.Encode(val)
+
+
+def _DataType(data):
+    # type: (column_data_t) -> int
+    with tagswitch(data) as case:
+        if case(column_data_e.Str):
+            return _STR
+        elif case(column_data_e.Int):
+            return _INT
+        elif case(column_data_e.Float):
+            return _FLOAT
+        else:
+            return _BOOL
+
+
+def ColumnTypeName(col):
+    # type: (Column) -> str
+    return _TYPE_NAMES[_DataType(col.data)]
+
+
+def _StrCell(data, i):
+    # type: (column_data.Str, int) -> str
+    start = 0 if i == 0 else data.ends[i - 1]
+    return data.arena[start:data.ends[i]]
+
+
+def _CellValue(col, i):
+    # type: (Column, int) -> value_t
+    """Box one cell."""
+    if col.nulls is not None and col.nulls[i]:
+        return value.Null
+
+    UP_data = col.data
+    with tagswitch(UP_data) as case:
+        if case(column_data_e.Str):
+            data = cast(column_data.Str, UP_data)
+            return value.Str(_StrCell(data, i))
+
+        elif case(column_data_e.Int):
+            data = cast(column_data.Int, UP_data)
+            return value.Int(data.ints[i])
+
+        elif case(column_data_e.Float):
+            data = cast(column_data.Float, UP_data)
+            return value.Float(data.floats[i])
+
+        elif case(column_data_e.Bool):
+            data = cast(column_data.Bool, UP_data)
+            return value.Bool(data.bools[i])
+
+        else:
+            raise AssertionError()
+
+
+def ColumnToList(col, num_rows):
+    # type: (Column, int) -> value.List
+    items = []  # type: List[value_t]
+    for i in xrange(num_rows):
+        items.append(_CellValue(col, i))
+    return value.List(items)
+
+
+def TableToDict(t):
+    # type: (value.Table) -> value.Dict
+    """The Dict of column Lists that toTsv8() also accepts."""
+    d = NewDict()  # type: Dict[str, value_t]
+    for col in t.columns:
+        d[col.name] = ColumnToList(col, t.num_rows)
+    return value.Dict(d)
+
+
+def FindColumn(t, name):
+    # type: (value.Table, str) -> Optional[Column]
+    for col in t.columns:
+        if col.name == name:
+            return col
+    return None
+
+
+# Comparison operators for Filter()
+_EQ = 0
+_NE = 1
+_LT = 2
+_LE = 3
+_GT = 4
+_GE = 5
+
+_OP_STRS = ['==', '!=', '<', '<=', '>', '>=']
+
+
+def ParseOp(op_str):
+    # type: (str) -> int
+    """Returns -1 if op_str isn't a comparison operator."""
+    for i, s in enumerate(_OP_STRS):
+        if op_str == s:
+            return i
+    return -1
+
+
+def CanFilter(col, op, arg):
+    # type: (Column, int, value_t) -> bool
+    """Can cells of col be compared to arg?  A Float column accepts an Int."""
+    with tagswitch(col.data) as case:
+        if case(column_data_e.Str):
+            return arg.tag() == value_e.Str
+        elif case(column_data_e.Int):
+            return arg.tag() == value_e.Int
+        elif case(column_data_e.Float):
+            return arg.tag() in (value_e.Float, value_e.Int)
+        else:  # Bool is only == and !=
+            return arg.tag() == value_e.Bool and op in (_EQ, _NE)
+
+
+def _OpMatches(op, c):
+    # type: (int, int) -> bool
+    """c is -1, 0, or 1, like the result of a compare function."""
+    if op == _EQ:
+        return c == 0
+    elif op == _NE:
+        return c != 0
+    elif op == _LT:
+        return c < 0
+    elif op == _LE:
+        return c <= 0
+    elif op == _GT:
+        return c > 0
+    else:
+        return c >= 0
+
+
+def _CompareBytes(s1, start1, end1, s2, start2, end2):
+    # type: (str, int, int, str, int, int) -> int
+    """Compare two byte ranges without slicing them."""
+    while start1 < end1 and start2 < end2:
+        b1 = mylib.ByteAt(s1, start1)
+        b2 = mylib.ByteAt(s2, start2)
+        if b1 != b2:
+            return -1 if b1 < b2 else 1
+        start1 += 1
+        start2 += 1
+
+    if start1 == end1:
+        return 0 if start2 == end2 else -1
+    return 1
+
+
+def _CompareInts(a, b):
+    # type: (mops.BigInt, mops.BigInt) -> int
+    if mops.Equal(a, b):
+        return 0
+    return 1 if mops.Greater(a, b) else -1
+
+
+def _CompareFloats(a, b):
+    # type: (float, float) -> int
+    if a == b:
+        return 0
+    return 1 if a > b else -1
+
+
+def _CompareCells(data, i, j):
+    # type: (column_data_t, int, int) -> int
+    UP_data = data
+    with tagswitch(UP_data) as case:
+        if case(column_data_e.Str):
+            data = cast(column_data.Str, UP_data)
+            start1 = 0 if i == 0 else data.ends[i - 1]
+            start2 = 0 if j == 0 else data.ends[j - 1]
+            return _CompareBytes(data.arena, start1, data.ends[i], data.arena,
+                                 start2, data.ends[j])
+
+        elif case(column_data_e.Int):
+            data = cast(column_data.Int, UP_data)
+            return _CompareInts(data.ints[i], data.ints[j])
+
+        elif case(column_data_e.Float):
+            data = cast(column_data.Float, UP_data)
+            return _CompareFloats(data.floats[i], data.floats[j])
+
+        elif case(column_data_e.Bool):
+            data = cast(column_data.Bool, UP_data)
+            b1 = data.bools[i]
+            b2 = data.bools[j]
+            if b1 == b2:
+                return 0
+            return 1 if b1 else -1
+
+        else:
+            raise AssertionError()
+
+
+def _CompareRows(col, i, j, reverse):
+    # type: (Column, int, int, bool) -> int
+    """Nulls sort last, even in reverse."""
+    nulls = col.nulls
+    if nulls is not None and (nulls[i] or nulls[j]):
+        if nulls[i] and nulls[j]:
+            return 0
+        return 1 if nulls[i] else -1
+
+    c = _CompareCells(col.data, i, j)
+    return -c if reverse else c
+
+
+def _SortRows(col, num_rows, reverse):
+    # type: (Column, int, bool) -> List[int]
+    """Return row indices in order.  A stable, bottom-up merge sort."""
+    rows = []  # type: List[int]
+    for i in xrange(num_rows):
+        rows.append(i)
+    tmp = [0] * num_rows
+
+    width = 1
+    while width < num_rows:
+        lo = 0
+        while lo < num_rows:
+            mid = lo + width
+            if mid > num_rows:
+                mid = num_rows
+            hi = lo + 2 * width
+            if hi > num_rows:
+                hi = num_rows
+
+            a = lo
+            b = mid
+            k = lo
+            while k < hi:
+                if b == hi or (a < mid and
+                               _CompareRows(col, rows[a], rows[b], reverse) <= 0):
+                    tmp[k] = rows[a]
+                    a += 1
+                else:
+                    tmp[k] = rows[b]
+                    b += 1
+                k += 1
+            lo = hi
+
+        swap = rows
+        rows = tmp
+        tmp = swap
+        width *= 2
+
+    return rows
+
+
+def _TakeColumn(col, rows, name):
+    # type: (Column, List[int], str) -> Column
+    """A new column with the cells of col at rows, in that order."""
+    nulls = None  # type: Optional[List[bool]]
+    if col.nulls is not None:
+        nulls = [col.nulls[r] for r in rows]
+
+    UP_data = col.data
+    with tagswitch(UP_data) as case:
+        if case(column_data_e.Str):
+            data = cast(column_data.Str, UP_data)
+            arena = mylib.BufWriter()
+            ends = []  # type: List[int]
+            for r in rows:
+                start = 0 if r == 0 else data.ends[r - 1]
+                arena.write(data.arena[start:data.ends[r]])
+                ends.append(arena.Length())
+            new_data = column_data.Str(arena.getvalue(),
+                                       ends)  # type: column_data_t
+
+        elif case(column_data_e.Int):
+            data = cast(column_data.Int, UP_data)
+            new_data = column_data.Int([data.ints[r] for r in rows])
+
+        elif case(column_data_e.Float):
+            data = cast(column_data.Float, UP_data)
+            new_data = column_data.Float([data.floats[r] for r in rows])
+
+        elif case(column_data_e.Bool):
+            data = cast(column_data.Bool, UP_data)
+            new_data = column_data.Bool([data.bools[r] for r in rows])
+
+        else:
+            raise AssertionError()
+
+    return Column(name, new_data, nulls)
+
+
+def _TakeRows(t, rows):
+    # type: (value.Table, List[int]) -> value.Table
+    columns = []  # type: List[Column]
+    for col in t.columns:
+        columns.append(_TakeColumn(col, rows, col.name))
+    return value.Table(columns, len(rows))
+
+
+def Filter(t, col, op, arg):
+    # type: (value.Table, Column, int, value_t) -> value.Table
+    """t => filter('age', '>', 30)
+
+    The caller checks CanFilter().  Null cells never match, like SQL.  Each
+    column type has its own loop, so cells aren't boxed.
+    """
+    nulls = col.nulls
+    rows = []  # type: List[int]
+
+    UP_data = col.data
+    with tagswitch(UP_data) as case:
+        if case(column_data_e.Str):
+            data = cast(column_data.Str, UP_data)
+            s = cast(value.Str, arg).s
+            n = len(s)
+            start = 0
+            for i in xrange(t.num_rows):
+                end = data.ends[i]
+                if nulls is None or not nulls[i]:
+                    c = _CompareBytes(data.arena, start, end, s, 0, n)
+                    if _OpMatches(op, c):
+                        rows.append(i)
+                start = end
+
+        elif case(column_data_e.Int):
+            data = cast(column_data.Int, UP_data)
+            big = cast(value.Int, arg).i
+            for i in xrange(t.num_rows):
+                if nulls is None or not nulls[i]:
+                    if _OpMatches(op, _CompareInts(data.ints[i], big)):
+                        rows.append(i)
+
+        elif case(column_data_e.Float):
+            data = cast(column_data.Float, UP_data)
+            if arg.tag() == value_e.Int:
+                f = mops.ToFloat(cast(value.Int, arg).i)
+            else:
+                f = cast(value.Float, arg).f
+            for i in xrange(t.num_rows):
+                if nulls is None or not nulls[i]:
+                    if _OpMatches(op, _CompareFloats(data.floats[i], f)):
+                        rows.append(i)
+
+        elif case(column_data_e.Bool):
+            data = cast(column_data.Bool, UP_data)
+            b = cast(value.Bool, arg).b
+            for i in xrange(t.num_rows):
+                if nulls is None or not nulls[i]:
+                    if _OpMatches(op, 0 if data.bools[i] == b else 1):
+                        rows.append(i)
+
+        else:
+            raise AssertionError()
+
+    return _TakeRows(t, rows)
+
+
+def SortBy(t, col, reverse):
+    # type: (value.Table, Column, bool) -> value.Table
+    """t => sortBy('age').  Stable, and null cells are last."""
+    return _TakeRows(t, _SortRows(col, t.num_rows, reverse))
+
+
+def GroupCount(t, col):
+    # type: (value.Table, Column) -> value.Table
+    """t => groupCount('name'), like sort | uniq -c
+
+    Returns a Table with the distinct cells of col, in order, and an Int
+    'count' column.  The rows are sorted, so there's no hashing, and equal
+    cells are adjacent.
+    """
+    rows = _SortRows(col, t.num_rows, False)
+
+    firsts = []  # type: List[int]
+    counts = []  # type: List[mops.BigInt]
+    n = 0
+    for i, r in enumerate(rows):
+        if i != 0 and _CompareRows(col, rows[i - 1], r, False) == 0:
+            n += 1
+            continue
+        if i != 0:
+            counts.append(mops.IntWiden(n))
+        firsts.append(r)
+        n = 1
+    if len(rows):
+        counts.append(mops.IntWiden(n))
+
+    columns = [
+        _TakeColumn(col, firsts, col.name),
+        Column('count', column_data.Int(counts), None)
+    ]
+    return value.Table(columns, len(firsts))
+
+
+def _MakeColumns(names, types):
+    # type: (List[str], List[int]) -> Tuple[List[Column], List[Optional[mylib.BufWriter]]]
+    """Returns empty columns, and an arena for each Str column."""
+    columns = []  # type: List[Column]
+    arenas = []  # type: List[Optional[mylib.BufWriter]]
+    for i, name in enumerate(names):
+        typ = types[i]
+        arena = None  # type: Optional[mylib.BufWriter]
+        if typ == _STR:
+            data = column_data.Str('', [])  # type: column_data_t
+            arena = mylib.BufWriter()
+        elif typ == _INT:
+            data = column_data.Int([])
+        elif typ == _FLOAT:
+            data = column_data.Float([])
+        else:
+            data = column_data.Bool([])
+        columns.append(Column(name, data, None))
+        arenas.append(arena)
+    return columns, arenas
+
+
+class Decoder(object):
+
+    def __init__(self, s):
+        # type: (str) -> None
+        self.s = s
+
+        # The current line
+        self.line_start = 0
+        self.line_end = 0
+        self.line_num = 1
+        self.next_line_pos = 0
+
+        # The current cell, stripped of spaces
+        self.cell_pos = 0  # where the next cell starts
+        self.cell_start = 0
+        self.cell_end = 0
+
+    def _Error(self, msg):
+        # type: (str) -> error.Decode
+        """Error at the current cell."""
+        return error.Decode(msg, self.s, self.cell_start, self.cell_end,
+                            self.line_num)
+
+    def _NextLine(self):
+        # type: () -> bool
+        """Move to the next line, returning False at the end of input."""
+        n = len(self.s)
+        start = self.next_line_pos
+        if start >= n:
+            return False
+
+        end = self.s.find('\n', start)
+        if end == -1:
+            end = n
+
+        if start != 0:
+            self.line_num += 1
+        self.line_start = start
+        self.line_end = end
+        self.next_line_pos = end + 1
+        self.cell_pos = start
+        return True
+
+    def _NextCell(self):
+        # type: () -> bool
+        """Set cell_start and cell_end, returning False at the end of line."""
+        if self.cell_pos > self.line_end:
+            return False
+
+        end = self.s.find('\t', self.cell_pos, self.line_end)
+        if end == -1:
+            end = self.line_end
+        start = self.cell_pos
+        self.cell_pos = end + 1
+
+        # Strip spaces, and \r of CRLF
+        while start < end and mylib.ByteInSet(mylib.ByteAt(self.s, start),
+                                              ' \r'):
+            start += 1
+        while start < end and mylib.ByteInSet(mylib.ByteAt(self.s, end - 1),
+                                              ' \r'):
+            end -= 1
+
+        self.cell_start = start
+        self.cell_end = end
+        return True
+
+    def _CellEquals(self, expected):
+        # type: (str) -> bool
+        n = len(expected)
+        if self.cell_end - self.cell_start != n:
+            return False
+        return self.s.find(expected, self.cell_start,
+                           self.cell_end) == self.cell_start
+
+    def _IsBlankLine(self):
+        # type: () -> bool
+        for i in xrange(self.line_start, self.line_end):
+            if not mylib.ByteInSet(mylib.ByteAt(self.s, i), ' \t\r'):
+                return False
+        return True
+
+    def _DecodeStr(self):
+        # type: () -> str
+        """Decode an unquoted cell, or a J8 string."""
+        s = self.s
+        start = self.cell_start
+        end = self.cell_end
+        if start == end:
+            raise self._Error('Unexpected empty cell (use "" for empty string)')
+
+        b = mylib.ByteAt(s, start)
+        is_quoted = mylib.ByteInSet(b, '"\'')
+        if (not is_quoted and mylib.ByteInSet(b, 'ub') and start + 1 < end and
+                mylib.ByteEquals(mylib.ByteAt(s, start + 1), "'")):
+            is_quoted = True
+
+        if not is_quoted:
+            return s[start:end]
+
+        p = j8.Parser(s[start:end], True)
+        try:
+            val = p.ParseValue()
+        except error.Decode as e:
+            raise self._Error('Invalid string cell: %s' % e.Message())
+        if val.tag() != value_e.Str:
+            raise self._Error('Expected string cell')
+        return cast(value.Str, val).s
+
+    def _NonEmptyCell(self):
+        # type: () -> str
+        if self.cell_start == self.cell_end:
+            raise self._Error('Unexpected empty cell')
+        return self.s[self.cell_start:self.cell_end]
+
+    def _AppendCell(self, col, arena, row):
+        # type: (Column, Optional[mylib.BufWriter], int) -> None
+        """Append the current cell to a column, without boxing it."""
+        is_null = self._CellEquals('null')
+        if is_null and col.nulls is None:
+            col.nulls = [False] * row
+        if col.nulls is not None:
+            col.nulls.append(is_null)
+
+        # A null cell gets an empty or zero placeholder
+        UP_data = col.data
+        with tagswitch(UP_data) as case:
+            if case(column_data_e.Str):
+                data = cast(column_data.Str, UP_data)
+                assert arena is not None
+                if not is_null:
+                    arena.write(self._DecodeStr())
+                data.ends.append(arena.Length())
+
+            elif case(column_data_e.Int):
+                data = cast(column_data.Int, UP_data)
+                big = mops.ZERO
+                if not is_null:
+                    ok, big = mops.FromStr2(self._NonEmptyCell())
+                    if not ok:
+                        raise self._Error('Invalid Int cell')
+                data.ints.append(big)
+
+            elif case(column_data_e.Float):
+                data = cast(column_data.Float, UP_data)
+                f = 0.0
+                if not is_null:
+                    try:
+                        f = float(self._NonEmptyCell())
+                    except ValueError:
+                        raise self._Error('Invalid Float cell')
+                data.floats.append(f)
+
+            elif case(column_data_e.Bool):
+                data = cast(column_data.Bool, UP_data)
+                b = False
+                if not is_null:
+                    part = self._NonEmptyCell()
+                    if part == 'true':
+                        b = True
+                    elif part != 'false':
+                        raise self._Error('Invalid Bool cell')
+                data.bools.append(b)
+
+            else:
+                raise AssertionError()
+
+    def _DecodeTypes(self, num_cols):
+        # type: (int) -> List[int]
+        types = []  # type: List[int]
+        while self._NextCell():
+            part = self.s[self.cell_start:self.cell_end]
+            found = False
+            for i, name in enumerate(_TYPE_NAMES):
+                if part == name:
+                    types.append(i)
+                    found = True
+                    break
+            if not found:
+                raise self._Error('Invalid column type %r' % part)
+
+        if len(types) != num_cols:
+            raise self._Error('Expected %d column types, got %d' %
+                              (num_cols, len(types)))
+        return types
+
+    def Decode(self):
+        # type: () -> value.Table
+
+        # Header line
+        while True:
+            if not self._NextLine():
+                raise self._Error('Expected !tsv8 header')
+            if not self._IsBlankLine():
+                break
+
+        self._NextCell()
+        if not self._CellEquals('!tsv8'):
+            raise self._Error('Expected !tsv8 header')
+
+        names = []  # type: List[str]
+        seen = {}  # type: Dict[str, bool]
+        while self._NextCell():
+            name = self._DecodeStr()
+            if name in seen:
+                raise self._Error('Duplicate column name %r' % name)
+            seen[name] = True
+            names.append(name)
+        num_cols = len(names)
+
+        types = None  # type: List[int]
+        columns = None  # type: List[Column]
+        arenas = None  # type: List[Optional[mylib.BufWriter]]
+        num_rows = 0
+        in_rows = False
+        while self._NextLine():
+            if self._IsBlankLine():
+                continue
+
+            self._NextCell()  # gutter
+
+            if self.cell_start != self.cell_end:  # !type or other attribute
+                if (in_rows or not mylib.ByteEquals(
+                        mylib.ByteAt(self.s, self.cell_start), '!')):
+                    raise self._Error('Expected empty gutter cell in row')
+
+                if self._CellEquals('!type'):
+                    if types is not None:
+                        raise self._Error('Duplicate !type line')
+                    types = self._DecodeTypes(num_cols)
+                continue  # ignore other attributes
+
+            if not in_rows:
+                in_rows = True
+                if types is None:
+                    types = [_STR] * num_cols
+                columns, arenas = _MakeColumns(names, types)
+
+            i = 0
+            while self._NextCell():
+                if i == num_cols:
+                    raise self._Error('Expected %d cells in row' % num_cols)
+                self._AppendCell(columns[i], arenas[i], num_rows)
+                i += 1
+            if i != num_cols:
+                raise self._Error('Expected %d cells in row, got %d' %
+                                  (num_cols, i))
+            num_rows += 1
+
+        if not in_rows:
+            if types is None:
+                types = [_STR] * num_cols
+            columns, arenas = _MakeColumns(names, types)
+
+        for i, col in enumerate(columns):
+            arena = arenas[i]
+            if arena is not None:
+                data = cast(column_data.Str, col.data)
+                data.arena = arena.getvalue()
+        return value.Table(columns, num_rows)
+
+
+class Encoder(object):
+
+    def __init__(self, buf):
+        # type: (mylib.BufWriter) -> None
+        self.buf = buf
+
+    def _ColumnType(self, name, col):
+        # type: (str, value.List) -> int
+        """All non-null cells must be the same primitive type."""
+        typ = -1
+        for item in col.items:
+            tag = item.tag()
+            if tag == value_e.Null:
+                continue
+            elif tag == value_e.Str:
+                t = _STR
+            elif tag == value_e.Int:
+                t = _INT
+            elif tag == value_e.Float:
+                t = _FLOAT
+            elif tag == value_e.Bool:
+                t = _BOOL
+            else:
+                raise error.Encode("Column %r can't have cell of type %s" %
+                                   (name, j8.ValType(item)))
+
+            if typ == -1:
+                typ = t
+            elif typ != t:
+                raise error.Encode("Column %r has cells of type %s and %s" %
+                                   (name, _TYPE_NAMES[typ], _TYPE_NAMES[t]))
+
+        if typ == -1:  # empty or all null
+            return _STR
+        return typ
+
+    def _WriteFloat(self, f):
+        # type: (float) -> None
+        buf = self.buf
+        if isinf_(f):
+            buf.write('-INFINITY' if f < 0 else 'INFINITY')
+        elif isnan_(f):
+            buf.write('NAN')
+        else:
+            pyj8.WriteFloat(f, buf)
+
+    def _EncodeCell(self, item):
+        # type: (value_t) -> None
+        buf = self.buf
+
+        UP_item = item
+        with tagswitch(item) as case:
+            if case(value_e.Null):
+                buf.write('null')
+
+            elif case(value_e.Bool):
+                item = cast(value.Bool, UP_item)
+                buf.write('true' if item.b else 'false')
+
+            elif case(value_e.Int):
+                item = cast(value.Int, UP_item)
+                pyj8.WriteBigInt(item.i, buf)
+
+            elif case(value_e.Float):
+                item = cast(value.Float, UP_item)
+                self._WriteFloat(item.f)
+
+            elif case(value_e.Str):
+                item = cast(value.Str, UP_item)
+                # Quotes "null", "true", "", and strings with tabs, etc.
+                j8.EncodeString(item.s, buf, unquoted_ok=True)
+
+            else:
+                raise AssertionError()
+
+    def _EncodeColumnCell(self, col, i):
+        # type: (Column, int) -> None
+        """Like _EncodeCell(), without boxing."""
+        buf = self.buf
+        if col.nulls is not None and col.nulls[i]:
+            buf.write('null')
+            return
+
+        UP_data = col.data
+        with tagswitch(UP_data) as case:
+            if case(column_data_e.Str):
+                data = cast(column_data.Str, UP_data)
+                j8.EncodeString(_StrCell(data, i), buf, unquoted_ok=True)
+
+            elif case(column_data_e.Int):
+                data = cast(column_data.Int, UP_data)
+                pyj8.WriteBigInt(data.ints[i], buf)
+
+            elif case(column_data_e.Float):
+                data = cast(column_data.Float, UP_data)
+                self._WriteFloat(data.floats[i])
+
+            elif case(column_data_e.Bool):
+                data = cast(column_data.Bool, UP_data)
+                buf.write('true' if data.bools[i] else 'false')
+
+            else:
+                raise AssertionError()
+
+    def _WriteHeader(self, names, types):
+        # type: (List[str], List[int]) -> None
+        buf = self.buf
+        buf.write('!tsv8')
+        for name in names:
+            buf.write('\t')
+            j8.EncodeString(name, buf, unquoted_ok=True)
+        buf.write('\n')
+
+        buf.write('!type')
+        for typ in types:
+            buf.write('\t')
+            buf.write(_TYPE_NAMES[typ])
+        buf.write('\n')
+
+    def _EncodeTable(self, t):
+        # type: (value.Table) -> None
+        names = []  # type: List[str]
+        types = []  # type: List[int]
+        for col in t.columns:
+            names.append(col.name)
+            types.append(_DataType(col.data))
+        self._WriteHeader(names, types)
+
+        buf = self.buf
+        for row in xrange(t.num_rows):
+            for col in t.columns:
+                buf.write('\t')  # after the empty gutter cell
+                self._EncodeColumnCell(col, row)
+            buf.write('\n')
+
+    def Encode(self, val):
+        # type: (value_t) -> None
+        if val.tag() == value_e.Table:
+            self._EncodeTable(cast(value.Table, val))
+            return
+
+        if val.tag() != value_e.Dict:
+            raise error.Encode("Expected Table or Dict of columns, got %s" %
+                               j8.ValType(val))
+        d = cast(value.Dict, val)
+
+        names = []  # type: List[str]
+        columns = []  # type: List[value.List]
+        num_rows = -1
+        for name, UP_col in iteritems(d.d):
+            if UP_col.tag() != value_e.List:
+                raise error.Encode("Column %r should be a List, got %s" %
+                                   (name, j8.ValType(UP_col)))
+            col = cast(value.List, UP_col)
+            if num_rows == -1:
+                num_rows = len(col.items)
+            elif len(col.items) != num_rows:
+                raise error.Encode(
+                    "Column %r has %d cells, but other columns have %d" %
+                    (name, len(col.items), num_rows))
+            names.append(name)
+            columns.append(col)
+
+        types = []  # type: List[int]
+        for i, col in enumerate(columns):
+            types.append(self._ColumnType(names[i], col))
+        self._WriteHeader(names, types)
+
+        buf = self.buf
+        for row in xrange(max(num_rows, 0)):
+            for col in columns:
+                buf.write('\t')  # after the empty gutter cell
+                self._EncodeCell(col.items[row])
+            buf.write('\n')
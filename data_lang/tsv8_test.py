@@ -0,0 +1,169 @@
+#!/usr/bin/env python2
+from __future__ import print_function
+
+import unittest
+
+from _devbuild.gen.value_asdl import value, column_data_e
+from core import error
+from core import test_lib
+from data_lang import j8
+from data_lang import tsv8  # module under test
+from mycpp import mops
+
+
+def _Encode(val):
+    return test_lib.Encoded(tsv8.Encode, val)
+
+
+class Tsv8Test(unittest.TestCase):
+
+    def testDecode(self):
+        s = ('!tsv8\tage\tname\tok\n'
+             '!type\tInt\tStr\tBool\n'
+             '!other\tx\ty\tz\n'
+             '\t44\talice\ttrue\n'
+             '\t 33 \t"a\\tb"\tfalse\n'
+             '\n'
+             '\tnull\tu\'\\u{3bc}\'\tnull\r\n')
+        t = tsv8.Decode(s)
+        self.assertEqual(3, t.num_rows)
+        self.assertEqual(
+            '{"age":[44,33,null],"name":["alice","a\\tb","\xce\xbc"],'
+            '"ok":[true,false,null]}', test_lib.J8Line(tsv8.TableToDict(t)))
+
+        # Cells aren't boxed.  Strings are in one arena.
+        age, name, ok = t.columns
+        self.assertEqual(column_data_e.Int, age.data.tag())
+        self.assertEqual([False, False, True], age.nulls)
+        self.assertEqual(column_data_e.Str, name.data.tag())
+        self.assertEqual(None, name.nulls)
+        self.assertEqual('alicea\tb\xce\xbc', name.data.arena)
+        self.assertEqual([5, 8, 10], name.data.ends)
+
+        # No !type line
+        t = tsv8.Decode('!tsv8\tx\n\t1\n')
+        self.assertEqual('{"x":["1"]}', test_lib.J8Line(tsv8.TableToDict(t)))
+
+        t = tsv8.Decode('!tsv8\n')
+        self.assertEqual('{}', test_lib.J8Line(tsv8.TableToDict(t)))
+
+        # Columns have types without rows
+        t = tsv8.Decode('!tsv8\tx\n!type\tFloat\n')
+        self.assertEqual(0, t.num_rows)
+        self.assertEqual('Float', tsv8.ColumnTypeName(t.columns[0]))
+
+    def testRoundTrip(self):
+        for s in [
+                '{}',
+                '{"x": []}',
+                '{"i": [1, -2, null], "f": [1.5, -0.0, 1e300]}',
+                '{"s": ["", "null", "true", "a b", "tab\\t", b\'\\yff\']}',
+                '{"b": [true, false], "n": [null, null]}',
+        ]:
+            val = j8.Parser(s, True).ParseValue()
+            encoded = _Encode(val)
+            t = tsv8.Decode(encoded)
+            self.assertEqual(test_lib.J8Line(val), test_lib.J8Line(tsv8.TableToDict(t)), encoded)
+
+            # A Table is encoded without boxing its cells
+            self.assertEqual(encoded, _Encode(t))
+
+    def testEncode(self):
+        val = value.Dict({
+            'n':
+            value.List([value.Int(mops.BigInt(1)),
+                        value.Null]),
+        })
+        self.assertEqual('!tsv8\tn\n!type\tInt\n\t1\n\tnull\n', _Encode(val))
+
+    def testDecodeErrors(self):
+        for s, msg in [
+            ('', 'Expected !tsv8 header'),
+            ('x\ty\n', 'Expected !tsv8 header'),
+            ('!tsv8\tx\tx\n', "Duplicate column name 'x'"),
+            ('!tsv8\tx\n!type\tBig\n', "Invalid column type 'Big'"),
+            ('!tsv8\tx\n!type\tInt\tInt\n', 'Expected 1 column types, got 2'),
+            ('!tsv8\tx\n!type\tInt\n\tz\n', 'Invalid Int cell'),
+            ('!tsv8\tx\n!type\tFloat\n\tz\n', 'Invalid Float cell'),
+            ('!tsv8\tx\n!type\tBool\n\tz\n', 'Invalid Bool cell'),
+            ('!tsv8\tx\ty\n\t1\t\n', 'Unexpected empty cell'),
+            ('!tsv8\tx\n\t1\t2\n', 'Expected 1 cells in row'),
+            ('!tsv8\tx\ty\n\t1\n', 'Expected 2 cells in row, got 1'),
+            ('!tsv8\tx\n1\t2\n', 'Expected empty gutter cell in row'),
+            ('!tsv8\tx\n\t1\n!type\tInt\n', 'Expected empty gutter cell'),
+            ('!tsv8\tx\n\t"unclosed\n', 'Invalid string cell: Unexpected EOF'),
+            ('!tsv8\tx\n\t"a" b\n', 'Invalid string cell: Got 1 bytes'),
+        ]:
+            try:
+                tsv8.Decode(s)
+            except error.Decode as e:
+                self.assertTrue(e.Message().startswith(msg), e.Message())
+            else:
+                self.fail('Expected error.Decode for %r' % s)
+
+    def testColumnOps(self):
+        t = tsv8.Decode('!tsv8\tname\tage\n'
+                        '!type\tStr\tInt\n'
+                        '\tbob\t30\n'
+                        '\talice\t44\n'
+                        '\tbob\tnull\n'
+                        '\t""\t25\n')
+        name = t.columns[0]
+        age = t.columns[1]
+
+        def Ages(t):
+            return test_lib.J8Line(tsv8.ColumnToList(t.columns[1], t.num_rows))
+
+        thirty = value.Int(mops.IntWiden(30))
+        for op_str, expected in [
+            ('==', '[30]'),
+            ('!=', '[44,25]'),  # null never matches
+            ('<', '[25]'),
+            ('<=', '[30,25]'),
+            ('>', '[44]'),
+            ('>=', '[30,44]'),
+        ]:
+            op = tsv8.ParseOp(op_str)
+            self.assertTrue(tsv8.CanFilter(age, op, thirty))
+            self.assertEqual(expected, Ages(tsv8.Filter(t, age, op, thirty)))
+        self.assertEqual(-1, tsv8.ParseOp('=~'))
+        self.assertFalse(
+            tsv8.CanFilter(age, tsv8.ParseOp('<'), value.Str('x')))
+
+        # Str cells are compared without slicing, including the empty one
+        lt = tsv8.ParseOp('<')
+        self.assertEqual(
+            '[44,25]', Ages(tsv8.Filter(t, name, lt, value.Str('bob'))))
+        self.assertEqual('[]', Ages(tsv8.Filter(t, name, lt, value.Str(''))))
+
+        self.assertEqual('[25,30,44,null]', Ages(tsv8.SortBy(t, age, False)))
+        self.assertEqual('[44,30,25,null]', Ages(tsv8.SortBy(t, age, True)))
+        # Stable
+        self.assertEqual('[25,44,30,null]', Ages(tsv8.SortBy(t, name, False)))
+
+        g = tsv8.GroupCount(t, name)
+        self.assertEqual('{"name":["","alice","bob"],"count":[1,1,2]}',
+                         test_lib.J8Line(tsv8.TableToDict(g)))
+        g = tsv8.GroupCount(t, age)
+        self.assertEqual('{"age":[25,30,44,null],"count":[1,1,1,1]}',
+                         test_lib.J8Line(tsv8.TableToDict(g)))
+
+        empty = tsv8.Decode('!tsv8\tx\n!type\tInt\n')
+        x = empty.columns[0]
+        self.assertEqual(0, tsv8.SortBy(empty, x, False).num_rows)
+        self.assertEqual(0, tsv8.GroupCount(empty, x).num_rows)
+
+    def testEncodeErrors(self):
+        for s in [
+                '[]',  # not a Dict
+                '{"x": 1}',  # not a List
+                '{"x": [1], "y": [1, 2]}',  # different lengths
+                '{"x": [1, "a"]}',  # mixed types
+                '{"x": [[]]}',  # not a primitive
+        ]:
+            val = j8.Parser(s, True).ParseValue()
+            self.assertRaises(error.Encode, _Encode, val)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -4,6 +4,7 @@
 #include <stddef.h>  // size_t
 #include <stdint.h>  // uint32_t
 #include <stdio.h>
+#include <string.h>  // memcpy
 
 /**
  *              ---- Quick reference about the encoding ----
@@ -167,4 +168,43 @@ static inline void utf8_decode(const unsigned char *input,
   return;
 }
 
+/**
+ * Return 1 if the `len` bytes starting at `input` are valid UTF-8, and 0
+ * otherwise.
+ *
+ * The same nul-terminator requirement as utf8_decode() applies.  A sequence
+ * that starts before `input + len` is decoded in full.
+ *
+ * Most text is ASCII, so 8 bytes without the high bit set are skipped at a
+ * time.  The rest is checked with utf8_decode(), one codepoint at a time.
+ */
+static inline int utf8_is_valid(const unsigned char *input, size_t len) {
+  const unsigned char *end = input + len;
+  while (input < end) {
+    while (end - input >= 8) {
+      uint64_t w;
+      memcpy(&w, input, sizeof(w));  // unaligned load
+      if (w & 0x8080808080808080ULL) {
+        break;
+      }
+      input += 8;
+    }
+    if (input >= end) {
+      break;
+    }
+    if ((*input & 0x80) == 0) {
+      input++;
+      continue;
+    }
+
+    Utf8Result_t result;
+    utf8_decode(input, &result);
+    if (result.error) {
+      return 0;
+    }
+    input += result.bytes_read;
+  }
+  return 1;
+}
+
 #endif  // DATA_LANG_UTF8_H
@@ -115,6 +115,35 @@ TEST truncated_test() {
   PASS();
 }
 
+TEST is_valid_test() {
+  // Invalid bytes at every position, to test both the ASCII word loop and
+  // the byte loop
+  for (int pos = 0; pos < 24; ++pos) {
+    unsigned char buf[25];
+    memset(buf, 'a', 24);
+    buf[24] = '\0';
+    ASSERT_EQ(1, utf8_is_valid(buf, 24));
+
+    buf[pos] = 0xff;
+    ASSERT_EQ(0, utf8_is_valid(buf, 24));
+  }
+
+  const unsigned char* mixed =
+      (const unsigned char*)"0123456789 \xce\xbc 0123456789 \xe4\x80\x80";
+  size_t n = strlen((const char*)mixed);
+  ASSERT_EQ(1, utf8_is_valid(mixed, n));
+  ASSERT_EQ(0, utf8_is_valid(mixed + 12, 1));      // continuation byte
+
+  // Truncated sequence
+  ASSERT_EQ(0, utf8_is_valid((const unsigned char*)"0123456789\xe4\x80", 12));
+
+  // Empty, and internal NUL
+  ASSERT_EQ(1, utf8_is_valid((const unsigned char*)"", 0));
+  ASSERT_EQ(1, utf8_is_valid((const unsigned char*)"a\0b", 3));
+
+  PASS();
+}
+
 GREATEST_MAIN_DEFS();
 
 int main(int argc, char** argv) {
@@ -124,6 +153,7 @@ int main(int argc, char** argv) {
   RUN_TEST(overlong_test);
   RUN_TEST(too_large_test);
   RUN_TEST(truncated_test);
+  RUN_TEST(is_valid_test);
 
   GREATEST_MAIN_END();
   return 0;
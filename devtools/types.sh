@@ -87,7 +87,7 @@ check-mycpp() {
   banner 'Type checking mycpp'
 
   local -a files=(
-    mycpp/{pass_state,util,crash,format_strings,visitor,const_pass,control_flow_pass,mycpp_main,cppgen_pass,conversion_pass}.py
+    mycpp/{pass_state,util,crash,format_strings,visitor,const_pass,control_flow_pass,mycpp_main,cppgen_pass,conversion_pass,escape_pass}.py
   )
   local -a flags=( --strict --no-strict-optional --follow-imports=silent )
 
@@ -8,6 +8,7 @@ from _devbuild.gen.value_asdl import Obj, value, value_e, value_t, value_str
 from core import bash_impl
 from data_lang import j8
 from data_lang import j8_lite
+from data_lang import tsv8
 from display import ansi
 from display import pp_hnode
 from display.pretty import _Break, _Concat, AsciiText
@@ -84,6 +85,9 @@ class ValueEncoder(pp_hnode.BaseEncoder):
         self.cycle_style = ansi.BOLD + ansi.BLUE
         self.type_style = ansi.MAGENTA
 
+        # Containers being printed, for cycle detection
+        self.ancestors = j8.Visiting()
+
     def TypePrefix(self, type_str):
         # type: (str) -> List[MeasuredDoc]
         """Return docs for type string '(List)', which may break afterward."""
@@ -102,7 +106,7 @@ class ValueEncoder(pp_hnode.BaseEncoder):
     def Value(self, val):
         # type: (value_t) -> MeasuredDoc
         """Convert an Oils value into a `doc`, which can then be pretty printed."""
-        self.visiting.clear()
+        self.ancestors.Clear()
         return self._Value(val)
 
     def _DictKey(self, s):
@@ -273,34 +277,50 @@ class ValueEncoder(pp_hnode.BaseEncoder):
                                                    self._Join(mdocs, '', ' '),
                                                    ')')
 
+            elif case(value_e.Table):
+                t = cast(value.Table, val)
+                type_name = self._Styled(self.type_style,
+                                         AsciiText(ValType(t)))
+                mdocs = []  # type: List[MeasuredDoc]
+                for col in t.columns:
+                    col_type = self._Styled(
+                        self.type_style, AsciiText(tsv8.ColumnTypeName(col)))
+                    mdocs.append(
+                        _Concat([
+                            self._DictKey(col.name),
+                            AsciiText(':'), col_type
+                        ]))
+                mdocs.append(AsciiText('rows=%d' % t.num_rows))
+                return self._SurroundedAndPrefixed('(', type_name, ' ',
+                                                   self._Join(mdocs, '', ' '),
+                                                   ')')
+
             elif case(value_e.List):
                 vlist = cast(value.List, val)
                 heap_id = j8.HeapValueId(vlist)
-                if self.visiting.get(heap_id, False):
+                if not self.ancestors.Push(heap_id):
                     return _Concat([
                         AsciiText('['),
                         self._Styled(self.cycle_style, AsciiText('...')),
                         AsciiText(']')
                     ])
                 else:
-                    self.visiting[heap_id] = True
                     result = self._YshList(vlist)
-                    self.visiting[heap_id] = False
+                    self.ancestors.Pop()
                     return result
 
             elif case(value_e.Dict):
                 vdict = cast(value.Dict, val)
                 heap_id = j8.HeapValueId(vdict)
-                if self.visiting.get(heap_id, False):
+                if not self.ancestors.Push(heap_id):
                     return _Concat([
                         AsciiText('{'),
                         self._Styled(self.cycle_style, AsciiText('...')),
                         AsciiText('}')
                     ])
                 else:
-                    self.visiting[heap_id] = True
                     result = self._YshDict(vdict)
-                    self.visiting[heap_id] = False
+                    self.ancestors.Pop()
                     return result
 
             elif case(value_e.BashArray):
@@ -318,16 +338,15 @@ class ValueEncoder(pp_hnode.BaseEncoder):
             elif case(value_e.Obj):
                 vaobj = cast(Obj, val)
                 heap_id = j8.HeapValueId(vaobj)
-                if self.visiting.get(heap_id, False):
+                if not self.ancestors.Push(heap_id):
                     return _Concat([
                         AsciiText('('),
                         self._Styled(self.cycle_style, AsciiText('...')),
                         AsciiText(')')
                     ])
                 else:
-                    self.visiting[heap_id] = True
                     result = self._Obj(vaobj)
-                    self.visiting[heap_id] = False
+                    self.ancestors.Pop()
                     return result
 
             # Bug fix: these types are GLOBAL singletons in C++.  This means
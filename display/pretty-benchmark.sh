@@ -178,6 +178,32 @@ test-abbrev() {
   wc --bytes _tmp/pretty-*
 }
 
+big-value() {
+  ### Time = and pp on a large nested value, about 1 MB of output
+
+  local ysh=${1:-_bin/cxx-opt/ysh}
+  local n=${2:-2000}
+
+  if test $ysh = _bin/cxx-opt/ysh; then
+    ninja $ysh
+  fi
+
+  local prog='
+var rows = []
+for i in (0 ..< n) {
+  call rows->append({id: i, name: "row $i", tags: ["a", "b", "c"],
+                     nested: {x: i / 3, y: [i, [i, [i]]], z: null}})
+}
+'
+
+  for action in '= rows' 'pp (rows)'; do
+    echo "___ $action  n=$n"
+    /usr/bin/time --format '*** elapsed %e, max RSS %M' -- \
+      $ysh -c "var n = $n; $prog; $action" | wc --bytes
+    echo
+  done
+}
+
 float-demo() {
   ### Test of tabular floats - not a test or a benchmark right now
 
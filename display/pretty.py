@@ -91,16 +91,17 @@ maximum line width.
 # Measures are used in two steps:
 # (1) First, they're computed bottom-up on the `doc`, measuring the size of each
 #     node.
-# (2) Later, PrintDoc() stores a measure in each DocFragment. These Measures
-#     measure something different: the width from the doc _to the end of the
-#     entire doc tree_. This second set of Measures (the ones in the
-#     DocFragments) are computed top-down, and they're used to decide for each
-#     Group whether to use flat mode or not, without needing to scan ahead.
+# (2) Later, PrintDoc() stores a suffix length with each fragment on its
+#     stack. It measures something different: the width from the doc _to the
+#     earliest possible newline after it, or the end of the entire doc tree_.
+#     These are computed top-down with integer arithmetic, and they're used to
+#     decide for each Group whether to use flat mode or not, without needing to
+#     scan ahead.
 
 from __future__ import print_function
 
-from _devbuild.gen.pretty_asdl import (doc, doc_e, DocFragment, Measure,
-                                       MeasuredDoc, List_Measured)
+from _devbuild.gen.pretty_asdl import (doc, doc_e, Measure, MeasuredDoc,
+                                       List_Measured)
 from mycpp.mylib import log, tagswitch, BufWriter
 from typing import cast, List
 
@@ -139,15 +140,6 @@ def _ConcatMeasure(m1, m2):
         return Measure(m1.flat + m2.flat, -1)
 
 
-def _SuffixLen(measure):
-    # type: (Measure) -> int
-    """The width until the earliest possible newline, or end of document."""
-    if measure.nonflat != -1:
-        return measure.nonflat
-    else:
-        return measure.flat
-
-
 #
 # Doc Construction
 #
@@ -231,12 +223,10 @@ class PrettyPrinter(object):
         # type: (int) -> None
         self.max_width = max_width
 
-    def _Fits(self, prefix_len, group, suffix_measure):
-        # type: (int, MeasuredDoc, Measure) -> bool
+    def _Fits(self, prefix_len, group, suffix_len):
+        # type: (int, MeasuredDoc, int) -> bool
         """Will group fit flat on the current line?"""
-        measure = _ConcatMeasure(_FlattenMeasure(group.measure),
-                                 suffix_measure)
-        return prefix_len + _SuffixLen(measure) <= self.max_width
+        return prefix_len + group.measure.flat + suffix_len <= self.max_width
 
     def PrintDoc(self, document, buf):
         # type: (MeasuredDoc, BufWriter) -> None
@@ -244,84 +234,102 @@ class PrettyPrinter(object):
 
         # The width of the text we've printed so far on the current line
         prefix_len = 0
-        # A _stack_ of document fragments to print. Each fragment contains:
+
+        # A _stack_ of document fragments to print.  It's stored as 4
+        # parallel lists, rather than a list of DocFragment, so that visiting
+        # a node doesn't allocate.  Each fragment has:
         # - A MeasuredDoc (doc node and its measure, saying how "big" it is)
         # - The indentation level to print this doc node at.
         # - Is this doc node being printed in flat mode?
-        # - The measure _from just after the doc node, to the end of the entire document_.
-        #   (Call this the suffix_measure)
-        fragments = [DocFragment(_Group(document), 0, False, _EmptyMeasure())]
-
-        max_stack = len(fragments)
-
-        while len(fragments) > 0:
-            max_stack = max(max_stack, len(fragments))
-
-            frag = fragments.pop()
-            UP_doc = frag.mdoc.doc
+        # - The width from just after the doc node to the earliest possible
+        #   newline, or the end of the entire document.  It's all that a
+        #   Group needs to decide whether to print flat.
+        #   (Call this the suffix_len)
+        mdocs = [_Group(document)]  # type: List[MeasuredDoc]
+        indents = [0]  # type: List[int]
+        flats = [False]  # type: List[bool]
+        suffix_lens = [0]  # type: List[int]
+
+        max_stack = len(mdocs)
+
+        while len(mdocs) > 0:
+            max_stack = max(max_stack, len(mdocs))
+
+            mdoc = mdocs.pop()
+            indent = indents.pop()
+            is_flat = flats.pop()
+            suffix_len = suffix_lens.pop()
+
+            UP_doc = mdoc.doc
             with tagswitch(UP_doc) as case:
 
                 if case(doc_e.Text):
                     text = cast(doc.Text, UP_doc)
                     buf.write(text.string)
-                    prefix_len += frag.mdoc.measure.flat
+                    prefix_len += mdoc.measure.flat
 
                 elif case(doc_e.Break):
                     break_ = cast(doc.Break, UP_doc)
-                    if frag.is_flat:
+                    if is_flat:
                         buf.write(break_.string)
-                        prefix_len += frag.mdoc.measure.flat
+                        prefix_len += mdoc.measure.flat
                     else:
                         buf.write('\n')
-                        buf.write_spaces(frag.indent)
-                        prefix_len = frag.indent
+                        buf.write_spaces(indent)
+                        prefix_len = indent
 
                 elif case(doc_e.Indent):
                     indented = cast(doc.Indent, UP_doc)
-                    fragments.append(
-                        DocFragment(indented.mdoc,
-                                    frag.indent + indented.indent,
-                                    frag.is_flat, frag.measure))
+                    mdocs.append(indented.mdoc)
+                    indents.append(indent + indented.indent)
+                    flats.append(is_flat)
+                    suffix_lens.append(suffix_len)
 
                 elif case(doc_e.Concat):
                     concat = cast(List_Measured, UP_doc)
 
-                    # If we encounter Concat([A, B, C]) with a suffix measure M,
+                    # If we encounter Concat([A, B, C]) with a suffix_len S,
                     # we need to push A,B,C onto the stack in reverse order:
-                    # - C, with suffix_measure = B.measure + A.measure + M
-                    # - B, with suffix_measure = A.measure + M
-                    # - A, with suffix_measure = M
-                    measure = frag.measure
-                    for mdoc in reversed(concat):
-                        fragments.append(
-                            DocFragment(mdoc, frag.indent, frag.is_flat,
-                                        measure))
-                        # TODO: this algorithm allocates too much!
-                        measure = _ConcatMeasure(mdoc.measure, measure)
+                    # - C, with suffix_len = S
+                    # - B, with C's width up to its first possible newline,
+                    #   or C.measure.flat + S if C has no Break
+                    # - A, likewise for B, using B's suffix_len
+                    for child in reversed(concat):
+                        mdocs.append(child)
+                        indents.append(indent)
+                        flats.append(is_flat)
+                        suffix_lens.append(suffix_len)
+
+                        if child.measure.nonflat != -1:
+                            suffix_len = child.measure.nonflat
+                        else:
+                            suffix_len += child.measure.flat
 
                 elif case(doc_e.Group):
                     # If the group would fit on the current line when printed
                     # flat, do so. Otherwise, print it non-flat.
                     group = cast(MeasuredDoc, UP_doc)
-                    is_flat = self._Fits(prefix_len, group, frag.measure)
-                    fragments.append(
-                        DocFragment(group, frag.indent, is_flat, frag.measure))
+                    mdocs.append(group)
+                    indents.append(indent)
+                    flats.append(self._Fits(prefix_len, group, suffix_len))
+                    suffix_lens.append(suffix_len)
 
                 elif case(doc_e.IfFlat):
                     if_flat = cast(doc.IfFlat, UP_doc)
-                    if frag.is_flat:
-                        subdoc = if_flat.flat_mdoc
+                    if is_flat:
+                        mdocs.append(if_flat.flat_mdoc)
                     else:
-                        subdoc = if_flat.nonflat_mdoc
-                    fragments.append(
-                        DocFragment(subdoc, frag.indent, frag.is_flat,
-                                    frag.measure))
+                        mdocs.append(if_flat.nonflat_mdoc)
+                    indents.append(indent)
+                    flats.append(is_flat)
+                    suffix_lens.append(suffix_len)
 
                 elif case(doc_e.Flat):
                     flat_doc = cast(doc.Flat, UP_doc)
-                    fragments.append(
-                        DocFragment(flat_doc.mdoc, frag.indent, True,
-                                    frag.measure))
+                    mdocs.append(flat_doc.mdoc)
+                    indents.append(indent)
+                    flats.append(True)
+                    suffix_lens.append(suffix_len)
 
         if 0:
             log('')
@@ -292,6 +292,11 @@ MAIN_SPEC.ShortFlag('-i')  # interactive
 MAIN_SPEC.ShortFlag('-l')  # login - currently no-op
 MAIN_SPEC.LongFlag('--login')  # login - currently no-op
 MAIN_SPEC.LongFlag('--headless')  # accepts ECMD, etc.
+# osh --headless --socket PATH serves many clients with pre-forked workers
+MAIN_SPEC.LongFlag('--socket', args.String)
+MAIN_SPEC.LongFlag('--workers', args.Int, default=4)
+# osh --zygote PATH forks an initialized shell for each 'osh -c' request
+MAIN_SPEC.LongFlag('--zygote', args.String)
 
 # TODO: -h too
 # the output format when passing -n
@@ -503,6 +508,12 @@ PP_SPEC = FlagSpec('pp')
 
 # --verbose?
 FORK_SPEC = FlagSpec('fork')
+# A String, since an Int flag is -1 when it's not passed
+FORK_SPEC.LongFlag('--jobs',
+                   args.String,
+                   help='Run the block for each item, N jobs at a time')
+FORK_SPEC.LongFlag('--capture-stdout',
+                   help='Save the stdout of each job in the results')
 FORKWAIT_SPEC = FlagSpec('forkwait')
 
 # Might want --list at some point
@@ -598,5 +609,23 @@ JSON_WRITE_SPEC.LongFlag('--indent',
                          args.Int,
                          default=2,
                          help='Indent JSON by this amount')
+JSON_WRITE_SPEC.LongFlag(
+    '--compact',
+    args.Bool,
+    default=False,
+    help='Write on one line, and stream the output as it is encoded')
+JSON_WRITE_SPEC.LongFlag('--binary',
+                         args.Bool,
+                         default=False,
+                         help='Write the bin8 encoding (json8 only)')
 
 JSON_READ_SPEC = FlagSpec('json_read')
+JSON_READ_SPEC.LongFlag(
+    '--stream',
+    args.Bool,
+    default=False,
+    help='Read one value per line, and run the block after each one')
+JSON_READ_SPEC.LongFlag('--binary',
+                        args.Bool,
+                        default=False,
+                        help='Read the bin8 encoding (json8 only)')
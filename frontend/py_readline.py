@@ -93,6 +93,11 @@ class Readline(object):
         # type: (int) -> str
         return line_input.get_history_item(pos)
 
+    def search_history(self, needle, prefix_only):
+        # type: (str, bool) -> int
+        """Returns the position of the newest match, or -1."""
+        return line_input.search_history(needle, prefix_only)
+
     def remove_history_item(self, pos):
         # type: (int) -> None
         line_input.remove_history_item(pos)
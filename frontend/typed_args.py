@@ -325,6 +325,15 @@ class Reader(object):
                             'Arg %d should be a Place' % self.pos_consumed,
                             self.BlamePos())
 
+    def _ToTable(self, val):
+        # type: (value_t) -> value.Table
+        if val.tag() == value_e.Table:
+            return cast(value.Table, val)
+
+        raise error.TypeErr(val,
+                            'Arg %d should be a Table' % self.pos_consumed,
+                            self.BlamePos())
+
     def _ToMatch(self, val):
         # type: (value_t) -> RegexMatch
         if val.tag() == value_e.Match:
@@ -468,11 +477,23 @@ class Reader(object):
         val = self.PosValue()
         return self._ToPlace(val)
 
+    def OptionalPlace(self):
+        # type: () -> Optional[value.Place]
+        val = self.OptionalValue()
+        if val is None:
+            return None
+        return self._ToPlace(val)
+
     def PosEggex(self):
         # type: () -> value.Eggex
         val = self.PosValue()
         return self._ToEggex(val)
 
+    def PosTable(self):
+        # type: () -> value.Table
+        val = self.PosValue()
+        return self._ToTable(val)
+
     def PosMatch(self):
         # type: () -> RegexMatch
         val = self.PosValue()
@@ -37,6 +37,18 @@ class BumpLeakHeap {
 #endif
   }
 
+  void PushFrame(RootFrame* frame) {
+#ifdef BUMP_ROOT
+    frame->prev_ = frames_;
+    frames_ = frame;
+#endif
+  }
+  void PopFrame(RootFrame* frame) {
+#ifdef BUMP_ROOT
+    frames_ = frame->prev_;
+#endif
+  }
+
   void RootGlobalVar(void* root) {
   }
 
@@ -68,6 +80,7 @@ class BumpLeakHeap {
 
 #ifdef BUMP_ROOT
   std::vector<RawObject**> roots_;
+  RootFrame* frames_ = nullptr;
   int max_roots_ = 0;
 #endif
 };
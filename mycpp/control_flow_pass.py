@@ -41,6 +41,25 @@ def GetObjectTypeName(t: Type) -> SymbolPath:
 INVALID_ID = -99  # statement IDs are positive
 
 
+def _LoopVarNames(index: Expression) -> List[str]:
+    """
+    for x in ... => [x]
+    for i, (k, v) in ... => [i, k, v]
+    """
+    if isinstance(index, NameExpr):
+        if util.SkipAssignment(index.name):
+            return []
+        return [index.name]
+
+    if isinstance(index, TupleExpr):
+        names: List[str] = []
+        for item in index.items:
+            names.extend(_LoopVarNames(item))
+        return names
+
+    return []  # e.g. for self.x in ...
+
+
 class Build(visitor.TypedVisitor):
 
     def __init__(self, types: Dict[Expression,
@@ -279,6 +298,18 @@ class Build(visitor.TypedVisitor):
         with pass_state.CfgLoopContext(
                 cfg, entry=self.current_statement_id) as loop:
             self.accept(o.expr)
+
+            # The loop header defines the loop variables on every iteration,
+            # so they're analyzed like other locals
+            if cfg:
+                for name in _LoopVarNames(o.index):
+                    cfg.AddFact(
+                        self.current_statement_id,
+                        pass_state.Definition(
+                            (name, ),
+                            '$HeapObject(h{})'.format(self.heap_counter)))
+                    self.heap_counter += 1
+
             self.loop_stack.append(loop)
             self.accept(o.body)
             self.loop_stack.pop()
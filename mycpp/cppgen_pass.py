@@ -654,6 +654,10 @@ class Decl(_Shared):
             current_class_name: Optional[util.SymbolPath]) -> None:
         self.write_ind('class %s', o.name)  # block after this
 
+        # Leaf classes let the compiler turn virtual calls into direct calls
+        if self.virtual.IsFinal(current_class_name):
+            self.write(' final')
+
         # e.g. class TextOutput : public ColorOutput
         if base_class_sym:
             self.write(' : public %s',
@@ -785,7 +789,9 @@ class Impl(_Shared):
             local_vars: Optional[AllLocalVars] = None,
             dot_exprs: Optional['conversion_pass.DotExprs'] = None,
             stack_roots_warn: Optional[int] = None,
-            stack_roots: Optional[pass_state.StackRoots] = None) -> None:
+            stack_roots: Optional[pass_state.StackRoots] = None,
+            root_report: Optional[pass_state.StackRootReport] = None,
+            stack_literals: Optional[Dict[Expression, str]] = None) -> None:
         _Shared.__init__(self,
                          types,
                          global_strings,
@@ -798,6 +804,9 @@ class Impl(_Shared):
         self.dot_exprs = dot_exprs
         self.stack_roots_warn = stack_roots_warn
         self.stack_roots = stack_roots
+        self.root_report = root_report
+        # From escape_pass: list literals to write as C++ values
+        self.stack_literals = stack_literals or {}
 
         # Traversal state used to to create an EAGER List<T>
         self.yield_eager_assign: Dict[AssignmentStmt, Tuple[str, str]] = {}
@@ -1214,12 +1223,13 @@ class Impl(_Shared):
         contains_func = _ContainsFunc(t1)
 
         if operator == 'in':
-            if isinstance(right, TupleExpr):
+            if isinstance(right, TupleExpr) or right in self.stack_literals:
                 left_type = self._GetType(left)
 
                 equals_func = _EqualsFunc(left_type)
 
                 # x in (1, 2, 3) => (x == 1 || x == 2 || x == 3)
+                # Likewise for x in [1, 2, 3], which then isn't allocated
                 self.write('(')
 
                 for i, item in enumerate(right.items):
@@ -1250,7 +1260,7 @@ class Impl(_Shared):
             return
 
         if operator == 'not in':
-            if isinstance(right, TupleExpr):
+            if isinstance(right, TupleExpr) or right in self.stack_literals:
                 left_type = self._GetType(left)
                 equals_func = _EqualsFunc(left_type)
 
@@ -1465,10 +1475,9 @@ class Impl(_Shared):
             op = '->'
             self.write(' = %s%sat%d();\n', temp_name, op, i)  # RHS
 
-            # Note: it would be nice to eliminate these roots, just like
-            # StackRoots _for() below
             if isinstance(lval_item, NameExpr):
-                if CTypeIsManaged(c_item_type) and not self.stack_roots:
+                if (CTypeIsManaged(c_item_type) and
+                        self._NeedsRoot(lval_item.name)):
                     self.write_ind('StackRoot _unpack_%d(&%s);\n' %
                                    (i, lval_item.name))
 
@@ -1904,6 +1913,21 @@ class Impl(_Shared):
             self.accept(o.body)
             return
 
+        if o.expr in self.stack_literals:
+            # for x in ['a', 'b'] =>
+            # for (BigStr* x : std::initializer_list<BigStr*>{str1, str2})
+            assert isinstance(o.index, NameExpr), o.index
+            assert isinstance(o.expr, ListExpr), o.expr
+            c_item_type = GetCType(o.inferred_item_type)
+
+            self.write_ind('for (%s %s : std::initializer_list<%s>',
+                           c_item_type, o.index.name, c_item_type)
+            self._WriteListElements(o.expr.items)
+            self.write(') ')
+
+            self.accept(o.body)
+            return
+
         reverse = False
 
         # for i, x in enumerate(...):
@@ -2080,10 +2104,10 @@ class Impl(_Shared):
 
             # Register loop variable as a stack root.
             # Note we have mylib.Collect() in CommandEvaluator::_Execute(), and
-            # it's called in a loop by _ExecuteList().  Although the 'child'
-            # variable is already live by other means.
-            # TODO: Test how much this affects performance.
-            if CTypeIsManaged(c_item_type) and not self.stack_roots:
+            # it's called in a loop by _ExecuteList().  The Datalog results
+            # say whether the variable is live across such a call.
+            if CTypeIsManaged(c_item_type) and (not isinstance(
+                    index_expr, NameExpr) or self._NeedsRoot(index_expr.name)):
                 self.write_ind('  StackRoot _for(&')
                 self.accept(index_expr)
                 self.write_ind(');\n')
@@ -2104,12 +2128,17 @@ class Impl(_Shared):
                 assert isinstance(index_items[0], NameExpr), index_items[0]
                 assert isinstance(index_items[1], NameExpr), index_items[1]
 
-                # TODO(StackRoots): k, v
                 self.write_ind('  %s %s = it.Key();\n', key_type,
                                index_items[0].name)
                 self.write_ind('  %s %s = it.Value();\n', val_type,
                                index_items[1].name)
 
+                for i, (item, c_type) in enumerate(
+                        zip(index_items, [key_type, val_type])):
+                    if CTypeIsManaged(c_type) and self._NeedsRoot(item.name):
+                        self.write_ind('  StackRoot _for%d(&%s);\n', i,
+                                       item.name)
+
             else:
                 # Example:
                 # for (ListIter it(mylist); !it.Done(); it.Next()) {
@@ -2122,7 +2151,8 @@ class Impl(_Shared):
                 c_item_type = GetCType(item_type)
 
                 if isinstance(o.index, TupleExpr):
-                    # TODO(StackRoots)
+                    # The tuple is reachable from the list, and
+                    # _WriteTupleUnpackingInLoop() roots its items
                     temp_name = 'tup%d' % self.unique_id
                     self.unique_id += 1
                     self.write_ind('  %s %s = it.Value();\n', c_item_type,
@@ -2137,7 +2167,9 @@ class Impl(_Shared):
                 elif isinstance(o.index, NameExpr):
                     self.write_ind('  %s %s = it.Value();\n', c_item_type,
                                    o.index.name)
-                    #self.write_ind('  StackRoots _for(&%s)\n;', o.index.name)
+                    if self._NeedsRoot(o.index.name):
+                        self.write_ind('  StackRoot _for(&%s);\n',
+                                       o.index.name)
 
                 else:
                     raise AssertionError()
@@ -2638,10 +2670,24 @@ class Impl(_Shared):
 
     # Statements
 
-    def _WriteLocals(self, local_var_list: List[LocalVar]) -> None:
-        # TODO: put the pointers first, and then register a single StackRoots
-        # record.
+    def _NeedsRoot(self, var_name: str) -> bool:
+        """Should this managed local or loop variable be a stack root?
+
+        Without the Datalog results, every one is rooted.
+        """
+        needs_root = True
+        func_name = '<module>'
+        if self.current_func_node:
+            func_name = self.current_func_node.fullname
+            if self.stack_roots:
+                needs_root = self.stack_roots.needs_root(
+                    SplitPyName(func_name), SplitPyName(var_name))
 
+        if self.root_report:
+            self.root_report.Add(func_name, var_name, needs_root)
+        return needs_root
+
+    def _WriteLocals(self, local_var_list: List[LocalVar]) -> None:
         # Initialize local vars, e.g. to nullptr
         done = set()  # track duplicates?  why?
         for lval_name, lval_type, is_param in local_var_list:
@@ -2661,11 +2707,7 @@ class Impl(_Shared):
 
                 done.add(lval_name)
 
-        # Figure out if we have any roots to write with StackRoots
-        full_func_name = None
-        if self.current_func_node:
-            full_func_name = SplitPyName(self.current_func_node.fullname)
-
+        # Figure out if we have any roots to write with StackRootFrame
         roots = []  # keep it sorted
         for lval_name, lval_type, is_param in local_var_list:
             if lval_name in roots:  # skip duplicates
@@ -2682,8 +2724,7 @@ class Impl(_Shared):
                 #self.log('Not rooting PNode %s', lval_name)
                 continue
 
-            if (not self.stack_roots or self.stack_roots.needs_root(
-                    full_func_name, SplitPyName(lval_name))):
+            if self._NeedsRoot(lval_name):
                 roots.append(lval_name)
 
         #self.log('roots %s', roots)
@@ -2693,8 +2734,10 @@ class Impl(_Shared):
                 log('WARNING: %s() has %d stack roots. Consider refactoring this function.'
                     % (self.current_func_node.fullname, len(roots)))
 
-            for i, r in enumerate(roots):
-                self.write_ind('StackRoot _root%d(&%s);\n' % (i, r))
+            # One frame per function, linked into the shadow stack with a
+            # single store, rather than a PushRoot() per variable
+            self.write_ind('StackRootFrame<%d> _frame(%s);\n' %
+                           (len(roots), ', '.join('&%s' % r for r in roots)))
 
             self.write('\n')
 
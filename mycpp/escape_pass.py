@@ -0,0 +1,63 @@
+"""
+escape_pass.py - Find list literals that never escape, so cppgen_pass can
+lower them to values on the C++ stack instead of Alloc<List<T>>.
+
+Only two patterns are recognized, since the list can't be referenced after
+the statement it's in:
+
+    x in ['a', 'b']       =>  (str_equals(x, str1) || str_equals(x, str2))
+    for x in ['a', 'b']:  =>  for (BigStr* x : std::initializer_list<...>{})
+
+The loop variable isn't a stack root, so the items of a loop must be string
+literals, or have a type that's not managed by the GC.
+"""
+import mypy
+from mypy.nodes import Expression, ListExpr, NameExpr, StrExpr
+
+from mycpp import visitor
+from mycpp.cppgen_pass import CTypeIsManaged, GetCType
+
+from typing import Dict, List, Optional, Tuple
+
+# list literal -> how it's lowered
+StackLiterals = Dict[Expression, str]
+
+
+class Build(visitor.TypedVisitor):
+
+    def __init__(self, types: Dict[Expression, 'mypy.types.Type'],
+                 stack_literals: StackLiterals,
+                 report: List[Tuple[str, int, str]]) -> None:
+        visitor.TypedVisitor.__init__(self, types)
+        self.stack_literals = stack_literals  # output
+        self.report = report  # output: path, line, kind
+
+    def _Lower(self, o: ListExpr, kind: str) -> None:
+        self.stack_literals[o] = kind
+        self.report.append((self.module_path or '', o.line, kind))
+
+    def _ItemsAreUnmanaged(self, o: ListExpr) -> bool:
+        for item in o.items:
+            if isinstance(item, StrExpr):
+                continue  # global constant
+            t = self._GetTypeOptional(item)
+            if t is None or CTypeIsManaged(GetCType(t)):
+                return False
+        return True
+
+    def oils_visit_for_stmt(self, o: 'mypy.nodes.ForStmt',
+                            func_name: Optional[str]) -> None:
+        if (func_name is None and isinstance(o.expr, ListExpr) and
+                isinstance(o.index, NameExpr) and len(o.expr.items) and
+                self._ItemsAreUnmanaged(o.expr)):
+            self._Lower(o.expr, 'for')
+
+        super().oils_visit_for_stmt(o, func_name)
+
+    def visit_comparison_expr(self, o: 'mypy.nodes.ComparisonExpr') -> None:
+        right = o.operands[1]
+        if (len(o.operators) == 1 and o.operators[0] in ('in', 'not in') and
+                isinstance(right, ListExpr) and len(right.items)):
+            self._Lower(right, o.operators[0])
+
+        super().visit_comparison_expr(o)
@@ -133,6 +133,18 @@ def TestForLoop():
     for item in ['xx', 'yy']:
         log('item = %s', item)
 
+    # These list literals aren't allocated; see escape_pass.py
+    log('--- iterate over ints in list')
+    for num in [3, 4]:
+        log('num = %d', num)
+
+    log('--- in list literal')
+    for item in ['xx', 'zz']:
+        if item in ['xx', 'yy']:
+            log('%s in list', item)
+        if item not in ['xx', 'yy']:
+            log('%s not in list', item)
+
     log('--- tuple unpacking')
 
     # Note: tuple_iter_1 and tuple_iter_2 are also top-level locals, and are
@@ -33,6 +33,37 @@ class StackRoot {
   }
 };
 
+// mycpp generates one of these per function, with the addresses of all its
+// managed locals, e.g.
+//
+//   StackRootFrame<2> _frame(&s, &L);
+template <int N>
+class StackRootFrame : public RootFrame {
+ public:
+  template <typename... Args>
+  StackRootFrame(Args... roots)
+      : slots_{reinterpret_cast<RawObject**>(roots)...} {
+    static_assert(sizeof...(Args) == N, "Wrong number of stack roots");
+#if VALIDATE_ROOTS
+    for (int i = 0; i < N; ++i) {
+      ValidateRoot(*slots_[i]);
+    }
+#endif
+    n_ = N;
+    roots_ = slots_;
+    gHeap.PushFrame(this);
+  }
+
+  ~StackRootFrame() {
+    gHeap.PopFrame(this);
+  }
+
+ private:
+  RawObject** slots_[N];
+
+  DISALLOW_COPY_AND_ASSIGN(StackRootFrame);
+};
+
 // sugar for tests
 class StackRoots {
  public:
@@ -20,10 +20,8 @@ BigStr* str(int i) {
   return s;
 }
 
-BigStr* str(double d) {
-  char buf[64];  // overestimate, but we use snprintf() to be safe
-
-  int n = sizeof(buf) - 2;  // in case we add '.0'
+int FormatDouble(double d, char* buf) {
+  int n = kDoubleBufSize - 2;  // in case we add '.0'
 
   // The round tripping test in mycpp/float_test.cc tells us:
   // %.9g - FLOAT round trip
@@ -55,9 +53,16 @@ BigStr* str(double d) {
     buf[length] = '.';
     buf[length + 1] = '0';
     buf[length + 2] = '\0';
+    length += 2;
   }
 
-  return StrFromC(buf);
+  return length;
+}
+
+BigStr* str(double d) {
+  char buf[kDoubleBufSize];
+  int length = FormatDouble(d, buf);
+  return StrFromC(buf, length);
 }
 // %a is a hexfloat form, probably don't need that
 // int length = snprintf(buf, n, "%a", d);
@@ -123,6 +123,11 @@ BigStr* str(int i);
 
 BigStr* str(double d);
 
+// Formats d like str(d), without allocating.  buf must have kDoubleBufSize
+// bytes.  Returns the length, not including the NUL terminator.
+const int kDoubleBufSize = 64;  // overestimate, but we use snprintf() to be safe
+int FormatDouble(double d, char* buf);
+
 BigStr* intern(BigStr* s);
 
 // Used by mark_sweep_heap and StrFormat
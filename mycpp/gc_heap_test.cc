@@ -450,6 +450,48 @@ TEST stack_roots_test() {
   PASS();
 }
 
+static bool gInnerLinked;
+static int gInnerLive;
+
+// Keeps objects alive only through its StackRootFrame
+static BigStr* Inner() {
+  BigStr* s = nullptr;
+  List<BigStr*>* L = nullptr;
+  StackRootFrame<2> _frame(&s, &L);
+
+  gInnerLinked = gHeap.frames_ == &_frame;
+
+  s = StrFromC("inner");
+  L = NewList<BigStr*>();
+  L->append(StrFromC("item"));
+
+  gHeap.Collect();
+  gInnerLive = gHeap.num_live();
+
+  return s;
+}
+
+TEST stack_root_frame_test() {
+  gHeap.Collect();
+  ASSERT(gHeap.frames_ == nullptr);
+
+  BigStr* outer = nullptr;
+  StackRootFrame<1> _frame(&outer);
+  ASSERT(gHeap.frames_ == &_frame);
+
+  outer = Inner();
+  ASSERT(gInnerLinked);
+  ASSERT_EQ_FMT(4, gInnerLive, "%d");  // s, L, its slab, and "item"
+
+  // The inner frame was unlinked, so only 'outer' is a root
+  ASSERT(gHeap.frames_ == &_frame);
+  gHeap.Collect();
+  ASSERT_NUM_LIVE_OBJS(1);
+  ASSERT(str_equals(StrFromC("inner"), outer));
+
+  PASS();
+}
+
 GREATEST_MAIN_DEFS();
 
 int main(int argc, char** argv) {
@@ -471,6 +513,7 @@ int main(int argc, char** argv) {
   RUN_TEST(inheritance_test);
 
   RUN_TEST(stack_roots_test);
+  RUN_TEST(stack_root_frame_test);
 
   gHeap.CleanProcessExit();
 
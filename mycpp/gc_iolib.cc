@@ -1,6 +1,11 @@
 #include "mycpp/gc_iolib.h"
 
 #include <errno.h>
+#include <fcntl.h>   // fcntl
+#include <unistd.h>  // pipe, write
+
+// Like _SHELL_MIN_FD in core/process.py
+const int kWakeupMinFd = 100;
 
 namespace iolib {
 
@@ -15,14 +20,49 @@ SignalSafe* InitSignalSafe() {
   return gSignalSafe;
 }
 
+// The write end of the pipe returned by OpenWakeupFd(), or -1
+static volatile sig_atomic_t gWakeupWriteFd = -1;
+static int gWakeupReadFd = -1;
+static int gWakeupPid = -1;  // the process that opened the pipe
+
+static void WriteWakeupByte() {
+  int fd = gWakeupWriteFd;
+  if (fd != -1) {
+    int saved_errno = errno;
+    char c = 0;
+    // Fails with EAGAIN if the pipe is full, which is OK
+    ssize_t unused = ::write(fd, &c, 1);
+    (void)unused;
+    errno = saved_errno;
+  }
+}
+
 static void OurSignalHandler(int sig_num) {
   assert(gSignalSafe != nullptr);
   gSignalSafe->UpdateFromSignalHandler(sig_num);
+  WriteWakeupByte();
+}
+
+static void OnSigChld(int sig_num) {
+  WriteWakeupByte();
+}
+
+// SA_RESTART, so other system calls aren't interrupted when a child exits
+static void InstallSigChld() {
+  struct sigaction act = {};
+  act.sa_handler = OnSigChld;
+  act.sa_flags = SA_RESTART;
+  sigfillset(&act.sa_mask);
+  if (::sigaction(SIGCHLD, &act, nullptr) != 0) {
+    throw Alloc<OSError>(errno);
+  }
 }
 
 void RegisterSignalInterest(int sig_num) {
   struct sigaction act = {};
   act.sa_handler = OurSignalHandler;
+  // Don't let another signal interrupt the handler while it updates the ring
+  sigfillset(&act.sa_mask);
   if (sigaction(sig_num, &act, nullptr) != 0) {
     throw Alloc<OSError>(errno);
   }
@@ -36,6 +76,14 @@ void sigaction(int sig_num, void (*handler)(int)) {
   DCHECK(sig_num != SIGINT);
   DCHECK(sig_num != SIGWINCH);
 
+  // e.g. 'trap - CHLD'.  If this process waits on the wakeup pipe, SIGCHLD
+  // must still write to it.  OnSigChld() is otherwise like SIG_DFL, which
+  // ignores SIGCHLD.
+  if (sig_num == SIGCHLD && handler == SIG_DFL && gWakeupPid == ::getpid()) {
+    InstallSigChld();
+    return;
+  }
+
   struct sigaction act = {};
   act.sa_handler = handler;
   if (sigaction(sig_num, &act, nullptr) != 0) {
@@ -43,4 +91,74 @@ void sigaction(int sig_num, void (*handler)(int)) {
   }
 }
 
+bool SignalIsIgnored(int sig_num) {
+  struct sigaction old = {};
+  if (sigaction(sig_num, nullptr, &old) != 0) {
+    throw Alloc<OSError>(errno);
+  }
+  return old.sa_handler == SIG_IGN;
+}
+
+static int MoveAboveUserFds(int fd) {
+  int new_fd = ::fcntl(fd, F_DUPFD_CLOEXEC, kWakeupMinFd);
+  if (new_fd < 0) {
+    throw Alloc<OSError>(errno);
+  }
+  ::close(fd);
+  if (::fcntl(new_fd, F_SETFL, O_NONBLOCK) < 0) {
+    throw Alloc<OSError>(errno);
+  }
+  return new_fd;
+}
+
+// Our signal handlers write a byte to a pipe, and so does SIGCHLD, even when it
+// isn't trapped.  A loop can poll the read end, then call waitpid() with
+// WNOHANG.  Unlike checking for signals before a blocking waitpid(), there's
+// no window where a signal is missed.
+//
+// A forked child gets its own pipe the first time it calls this, so it doesn't
+// read its parent's wakeups.
+int OpenWakeupFd() {
+  int pid = ::getpid();
+  if (gWakeupPid == pid) {
+    return gWakeupReadFd;
+  }
+
+  int fds[2];
+  if (::pipe(fds) < 0) {
+    throw Alloc<OSError>(errno);
+  }
+  int r = MoveAboveUserFds(fds[0]);
+  int w = MoveAboveUserFds(fds[1]);
+
+  int old_r = gWakeupReadFd;
+  int old_w = gWakeupWriteFd;
+  gWakeupWriteFd = w;
+  if (old_r != -1) {  // inherited from the parent
+    ::close(old_r);
+    ::close(old_w);
+  }
+  gWakeupReadFd = r;
+  gWakeupPid = pid;
+
+  // If CHLD is trapped, our handler already writes the byte, and the trap must
+  // still run
+  struct sigaction old = {};
+  if (::sigaction(SIGCHLD, nullptr, &old) != 0) {
+    throw Alloc<OSError>(errno);
+  }
+  if (old.sa_handler != OurSignalHandler) {
+    InstallSigChld();
+  }
+
+  return gWakeupReadFd;
+}
+
+void DrainWakeupFd(int fd) {
+  char buf[64];
+  while (::read(fd, buf, sizeof(buf)) > 0) {
+    ;
+  }
+}
+
 }  // namespace iolib
@@ -21,32 +21,46 @@ namespace iolib {
 
 const int UNTRAPPED_SIGWINCH = -10;
 
-// Make the signal queue slab 4096 bytes, including the GC header.  See
-// cpp/core_test.cc.
-const int kMaxPendingSignals = 1022;
+// Pending signals are queued in a ring.  A signal that's already pending isn't
+// queued again, so the ring holds each signal number at most once, plus one
+// that TakePendingSignals() is removing.  It never drops a signal.
+//
+// One slot is always empty, so that head_ == tail_ means the ring is empty.
+const int kSignalRingSize = 128;
+static_assert(NSIG + 2 <= kSignalRingSize,
+              "ring must hold every signal, plus 1, plus the empty slot");
 
 class SignalSafe {
   // State that is shared between the main thread and signal handlers.
+  //
+  // The handler only writes head_, and the main thread only writes tail_.
+  // Handlers don't interrupt each other, because RegisterSignalInterest()
+  // blocks all signals while one runs.
  public:
   SignalSafe()
-      : pending_signals_(AllocSignalList()),
-        empty_list_(AllocSignalList()),  // to avoid repeated allocation
+      : taken_(AllocSignalList()),
+        head_(0),
+        tail_(0),
         last_sig_num_(0),
+        sigint_trapped_(false),
         received_sigint_(false),
         received_sigwinch_(false),
         sigwinch_code_(UNTRAPPED_SIGWINCH),
-        num_dropped_(0) {
+        num_coalesced_(0) {
+    for (int i = 0; i < kSignalRingSize; ++i) {
+      queued_[i] = 0;
+    }
   }
 
   // Called from signal handling context.  Do not allocate.
   void UpdateFromSignalHandler(int sig_num) {
-    if (pending_signals_->len_ < pending_signals_->capacity_) {
-      // We can append without allocating
-      pending_signals_->append(sig_num);
+    if (queued_[sig_num]) {
+      num_coalesced_++;  // traps run once for signals received together
     } else {
-      // Unlikely: we would have to allocate.  Just increment a counter, which
-      // we could expose somewhere in the UI.
-      num_dropped_++;
+      queued_[sig_num] = 1;
+      int head = head_;
+      ring_[head] = sig_num;
+      head_ = (head + 1) % kSignalRingSize;  // publish after writing the slot
     }
 
     if (sig_num == SIGINT) {
@@ -65,24 +79,58 @@ class SignalSafe {
 #endif
   }
 
-  // Main thread takes signals so it can run traps.
-  List<int>* TakePendingSignals() {
-    List<int>* ret = pending_signals_;
-
-    // Make sure we have a distinct list to reuse.
-    DCHECK(empty_list_ != pending_signals_);
-    pending_signals_ = empty_list_;
+  // Cheap enough to call in the inner loops of builtins.
+  bool HasPendingSignals() {
+    return head_ != tail_;
+  }
 
+  // Main thread takes signals so it can run traps.  The caller clears the
+  // list and gives it back with ReuseEmptyList(), so this doesn't allocate.
+  List<int>* TakePendingSignals() {
+    List<int>* ret = taken_;
+    DCHECK(ret != nullptr);  // previous list was given back
+    DCHECK(len(ret) == 0);
+    taken_ = nullptr;
+
+    while (tail_ != head_) {
+      int tail = tail_;
+      int sig_num = ring_[tail];
+      // Clear before advancing tail_.  If the signal arrives again in
+      // between, it's queued in another slot, and the ring has room for it.
+      queued_[sig_num] = 0;
+      tail_ = (tail + 1) % kSignalRingSize;
+      ret->append(sig_num);  // capacity is reserved
+    }
     return ret;
   }
 
   // Main thread returns the same list as an optimization to avoid allocation.
   void ReuseEmptyList(List<int>* empty_list) {
-    DCHECK(empty_list != pending_signals_);  // must be different
-    DCHECK(len(empty_list) == 0);            // main thread clears
-    DCHECK(empty_list->capacity_ == kMaxPendingSignals);
+    DCHECK(taken_ == nullptr);
+    DCHECK(len(empty_list) == 0);  // main thread clears
+    DCHECK(empty_list->capacity_ >= kSignalRingSize);
 
-    empty_list_ = empty_list;
+    taken_ = empty_list;
+  }
+
+  // Used by the 'wait' builtin.  Returns a signal received since the last
+  // TakePendingSignals() that should interrupt 'wait', or 0.
+  int PendingSignalForWait() {
+    int end = head_;
+    for (int i = tail_; i != end; i = (i + 1) % kSignalRingSize) {
+      int sig_num = ring_[i];
+      if (sig_num == SIGINT && !sigint_trapped_) {
+        continue;
+      }
+      if (sig_num == SIGWINCH && sigwinch_code_ == UNTRAPPED_SIGWINCH) {
+        continue;
+      }
+      if (sig_num == SIGCHLD) {  // like bash, the CHLD trap runs after 'wait'
+        continue;
+      }
+      return sig_num;
+    }
+    return 0;
   }
 
   // Main thread wants to get the last signal received.
@@ -126,27 +174,36 @@ class SignalSafe {
   }
 
   static constexpr uint32_t field_mask() {
-    return maskbit(offsetof(SignalSafe, pending_signals_)) |
-           maskbit(offsetof(SignalSafe, empty_list_));
+    return maskbit(offsetof(SignalSafe, taken_));
   }
 
   static constexpr ObjHeader obj_header() {
     return ObjHeader::ClassFixed(field_mask(), sizeof(SignalSafe));
   }
 
-  List<int>* pending_signals_;  // public for testing
-  List<int>* empty_list_;
+  List<int>* taken_;  // public for testing
 
  private:
   // Enforce private state because two different "threads" will use it!
 
-  // Reserve a fixed number of signals.
   List<int>* AllocSignalList() {
     List<int>* ret = NewList<int>();
-    ret->reserve(kMaxPendingSignals);
+    ret->reserve(kSignalRingSize);
     return ret;
   }
 
+  // The handler and the main thread both read and write the ring, in loops.
+  // Indexes are always in [0, kSignalRingSize).
+#if LOCK_FREE_ATOMICS
+  typedef std::atomic<int> ring_int_t;
+#else
+  typedef volatile sig_atomic_t ring_int_t;
+#endif
+  ring_int_t ring_[kSignalRingSize];
+  ring_int_t queued_[kSignalRingSize];  // indexed by signal number
+  ring_int_t head_;
+  ring_int_t tail_;
+
 #if LOCK_FREE_ATOMICS
   std::atomic<int> last_sig_num_;
 #else
@@ -158,7 +215,7 @@ class SignalSafe {
   int received_sigint_;
   int received_sigwinch_;
   int sigwinch_code_;
-  int num_dropped_;
+  int num_coalesced_;
 };
 
 extern SignalSafe* gSignalSafe;
@@ -170,6 +227,15 @@ void RegisterSignalInterest(int sig_num);
 
 void sigaction(int sig_num, void (*handler)(int));
 
+// Is the signal ignored, e.g. because we were started with nohup?
+bool SignalIsIgnored(int sig_num);
+
+// Returns a descriptor that becomes readable when a signal arrives.
+int OpenWakeupFd();
+
+// Read the bytes written by signals, so the descriptor can be polled again.
+void DrainWakeupFd(int fd);
+
 }  // namespace iolib
 
 #endif  // MYCPP_GC_IOLIB_H
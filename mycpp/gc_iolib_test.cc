@@ -1,5 +1,8 @@
 #include "mycpp/gc_iolib.h"
 
+#include <errno.h>
+#include <poll.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include "mycpp/gc_alloc.h"  // gHeap
@@ -57,11 +60,11 @@ TEST signal_test() {
   kill(mypid, SIGWINCH);
   ASSERT_EQ(SIGWINCH, signal_safe->LastSignal());
   {
+    // The second SIGWINCH is coalesced with the first
     List<int>* q = signal_safe->TakePendingSignals();
     ASSERT(q != nullptr);
-    ASSERT_EQ(2, len(q));
+    ASSERT_EQ(1, len(q));
     ASSERT_EQ(SIGWINCH, q->at(0));
-    ASSERT_EQ(SIGWINCH, q->at(1));
   }
 
   PASS();
@@ -72,21 +75,143 @@ TEST signal_safe_test() {
 
   List<int>* received = signal_safe.TakePendingSignals();
 
-  // We got now signals
+  // We got no signals
   ASSERT_EQ_FMT(0, len(received), "%d");
+  ASSERT(!signal_safe.HasPendingSignals());
+  signal_safe.ReuseEmptyList(received);
 
-  // The existing queue is of length 0
-  ASSERT_EQ_FMT(0, len(signal_safe.pending_signals_), "%d");
-
-  // Capacity is a ROUND NUMBER from the allocator's POV
-  // There's no convenient way to test the obj_len we pass to gHeap.Allocate,
-  // but it should be (1022 + 2) * 4.
-  ASSERT_EQ_FMT(1022, signal_safe.pending_signals_->capacity_, "%d");
+  // The list has room for every signal, so appending doesn't allocate
+  ASSERT(signal_safe.taken_->capacity_ >= iolib::kSignalRingSize);
 
-  // Register too many signals
-  for (int i = 0; i < iolib::kMaxPendingSignals + 10; ++i) {
+  // Many signals of one kind are coalesced
+  for (int i = 0; i < 2000; ++i) {
     signal_safe.UpdateFromSignalHandler(SIGINT);
   }
+  ASSERT(signal_safe.HasPendingSignals());
+
+  // Every kind of signal is kept, in order
+  for (int sig_num = 1; sig_num < NSIG; ++sig_num) {
+    signal_safe.UpdateFromSignalHandler(sig_num);
+  }
+
+  received = signal_safe.TakePendingSignals();
+  ASSERT_EQ_FMT(NSIG - 1, len(received), "%d");
+  ASSERT_EQ_FMT(SIGINT, received->at(0), "%d");
+  ASSERT_EQ_FMT(SIGHUP, received->at(1), "%d");
+  ASSERT_EQ_FMT(NSIG - 1, received->at(NSIG - 2), "%d");
+  ASSERT(!signal_safe.HasPendingSignals());
+  received->clear();
+  signal_safe.ReuseEmptyList(received);
+
+  // Taken signals are queued again, many times around the ring
+  for (int i = 0; i < 1000; ++i) {
+    signal_safe.UpdateFromSignalHandler(SIGUSR1);
+    signal_safe.UpdateFromSignalHandler(SIGUSR2);
+    signal_safe.UpdateFromSignalHandler(SIGUSR1);
+
+    received = signal_safe.TakePendingSignals();
+    ASSERT_EQ_FMT(2, len(received), "%d");
+    ASSERT_EQ_FMT(SIGUSR1, received->at(0), "%d");
+    ASSERT_EQ_FMT(SIGUSR2, received->at(1), "%d");
+    received->clear();
+    signal_safe.ReuseEmptyList(received);
+  }
+
+  PASS();
+}
+
+TEST pending_signal_for_wait_test() {
+  iolib::SignalSafe signal_safe;
+  ASSERT_EQ(0, signal_safe.PendingSignalForWait());
+
+  // Untrapped SIGINT and SIGWINCH don't interrupt 'wait'
+  signal_safe.UpdateFromSignalHandler(SIGINT);
+  signal_safe.UpdateFromSignalHandler(SIGWINCH);
+  ASSERT_EQ(0, signal_safe.PendingSignalForWait());
+
+  signal_safe.UpdateFromSignalHandler(SIGUSR1);
+  ASSERT_EQ(SIGUSR1, signal_safe.PendingSignalForWait());
+
+  // Running traps takes the signals
+  List<int>* q = signal_safe.TakePendingSignals();
+  ASSERT_EQ(3, len(q));
+  ASSERT_EQ(0, signal_safe.PendingSignalForWait());
+  q->clear();
+  signal_safe.ReuseEmptyList(q);
+
+  signal_safe.SetSigIntTrapped(true);
+  signal_safe.UpdateFromSignalHandler(SIGINT);
+  ASSERT_EQ(SIGINT, signal_safe.PendingSignalForWait());
+
+  PASS();
+}
+
+static bool IsReadable(int fd) {
+  struct pollfd pfd = {fd, POLLIN, 0};
+  int n;
+  do {
+    n = ::poll(&pfd, 1, 1000);  // wait at most 1 second
+  } while (n < 0 && errno == EINTR);
+  return n == 1;
+}
+
+TEST wakeup_fd_test() {
+  iolib::InitSignalSafe();
+  iolib::RegisterSignalInterest(SIGUSR1);
+
+  int fd = iolib::OpenWakeupFd();
+  ASSERT(fd >= 100);
+  ASSERT_EQ(fd, iolib::OpenWakeupFd());  // same pipe
+
+  char c;
+  ASSERT_EQ(-1, read(fd, &c, 1));  // empty, and doesn't block
+  ASSERT_EQ(EAGAIN, errno);
+
+  // Our signal handler writes a byte
+  kill(getpid(), SIGUSR1);
+  ASSERT(IsReadable(fd));
+  iolib::DrainWakeupFd(fd);
+  ASSERT_EQ(-1, read(fd, &c, 1));
+
+  // So does SIGCHLD
+  pid_t pid = fork();
+  if (pid == 0) {
+    // A child gets its own pipe
+    _exit(iolib::OpenWakeupFd() != fd ? 0 : 1);
+  }
+  ASSERT(IsReadable(fd));
+
+  int status;
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  ASSERT_EQ(0, WEXITSTATUS(status));
+  iolib::DrainWakeupFd(fd);
+
+  // trap CHLD, then trap - CHLD: SIGCHLD still writes a byte
+  iolib::RegisterSignalInterest(SIGCHLD);
+  iolib::sigaction(SIGCHLD, SIG_DFL);
+  struct sigaction act = {};
+  sigaction(SIGCHLD, nullptr, &act);
+  ASSERT(act.sa_handler != SIG_DFL);
+
+  pid = fork();
+  if (pid == 0) {
+    _exit(0);
+  }
+  ASSERT(IsReadable(fd));
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  iolib::DrainWakeupFd(fd);
+
+  signal(SIGCHLD, SIG_DFL);
+
+  PASS();
+}
+
+TEST signal_is_ignored_test() {
+  iolib::sigaction(SIGUSR2, SIG_DFL);
+  ASSERT(!iolib::SignalIsIgnored(SIGUSR2));
+
+  iolib::sigaction(SIGUSR2, SIG_IGN);
+  ASSERT(iolib::SignalIsIgnored(SIGUSR2));
 
   PASS();
 }
@@ -100,6 +225,9 @@ int main(int argc, char** argv) {
 
   RUN_TEST(signal_test);
   RUN_TEST(signal_safe_test);
+  RUN_TEST(pending_signal_for_wait_test);
+  RUN_TEST(wakeup_fd_test);
+  RUN_TEST(signal_is_ignored_test);
 
   gHeap.CleanProcessExit();
 
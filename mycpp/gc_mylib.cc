@@ -195,9 +195,12 @@ Writer* gStderr;
 //
 
 void CFile::write(BigStr* s) {
+  WriteBytes(s->data_, len(s));
+}
+
+void CFile::WriteBytes(const char* s, int n) {
   // Writes can be short!
-  int n = len(s);
-  int num_written = ::fwrite(s->data_, sizeof(char), n, f_);
+  int num_written = ::fwrite(s, sizeof(char), n, f_);
   // Similar to CPython fileobject.c
   if (num_written != n) {
     throw Alloc<IOError>(errno);
@@ -320,6 +323,18 @@ BigStr* BufWriter::getvalue() {
   }
 }
 
+void BufWriter::FlushTo(Writer* f) {
+  DCHECK(is_valid_);  // Can't FlushTo() after getvalue()
+
+  if (len_ == 0) {
+    return;
+  }
+  // Unlike getvalue(), the buffer isn't given away, so it doesn't regrow from
+  // scratch.  And the bytes aren't copied into a new BigStr.
+  f->WriteBytes(str_->data_, len_);
+  len_ = 0;
+}
+
 bool StatResult::isreg() {
   return S_ISREG(stat_result_.st_mode);
 }
@@ -135,6 +135,10 @@ class File {
   // Writer
   virtual void write(BigStr* s) = 0;
   virtual void flush() = 0;
+  // C++ only: write bytes that aren't in a BigStr.  The default copies them.
+  virtual void WriteBytes(const char* s, int n) {
+    write(::StrFromC(s, n));
+  }
 
   // Reader
   virtual BigStr* readline() = 0;
@@ -160,6 +164,7 @@ class CFile : public File {
   // Writer
   void write(BigStr* s) override;
   void flush() override;
+  void WriteBytes(const char* s, int n) override;
 
   // Reader
   BigStr* readline() override;
@@ -267,6 +272,9 @@ class BufWriter : public Writer {
   BufWriter() : Writer(), str_(nullptr), len_(0) {
   }
   void write(BigStr* s) override;
+  void WriteBytes(const char* s, int n) override {
+    WriteRaw(const_cast<char*>(s), n);
+  }
   void write_spaces(int n);
   void clear() {  // Reuse this instance
     str_ = nullptr;
@@ -281,6 +289,9 @@ class BufWriter : public Writer {
     return false;
   }
   BigStr* getvalue();  // part of cStringIO API
+  // Write the contents to f and rewind, keeping the buffer's capacity.
+  // Doesn't allocate if f is a CFile.
+  void FlushTo(Writer* f);
 
   //
   // Low Level API for C++ usage only
@@ -115,10 +115,11 @@ TEST writeln_test() {
 
 TEST BufWriter_test() {
   mylib::BufWriter* writer = nullptr;
+  mylib::BufWriter* out = nullptr;
   BigStr* s = nullptr;
   BigStr* foo = nullptr;
   BigStr* bar = nullptr;
-  StackRoots _roots({&writer, &s, &foo, &bar});
+  StackRoots _roots({&writer, &out, &s, &foo, &bar});
 
   foo = StrFromC("foo");
   bar = StrFromC("bar");
@@ -149,6 +150,39 @@ TEST BufWriter_test() {
   s = writer->getvalue();
   ASSERT(str_equals0("bar", s));
 
+  // FlushTo() writes in chunks, and doesn't invalidate the writer
+  out = Alloc<mylib::BufWriter>();
+  writer = Alloc<mylib::BufWriter>();
+  writer->FlushTo(out);  // nothing written yet
+  writer->write(foo);
+  writer->FlushTo(out);
+  ASSERT_EQ(0, writer->Length());
+  writer->write(bar);
+  writer->FlushTo(out);
+  writer->write(foo);
+  s = writer->getvalue();
+  ASSERT(str_equals0("foo", s));
+  s = out->getvalue();
+  ASSERT(str_equals0("foobar", s));
+
+  // To a CFile, the bytes are written without a BigStr copy
+  FILE* tmp = tmpfile();
+  // Like mylib::Stdout()
+  mylib::Writer* cf = reinterpret_cast<mylib::Writer*>(
+      Alloc<mylib::CFile>(tmp));
+  StackRoots _roots2({&cf});
+  writer = Alloc<mylib::BufWriter>();
+  writer->write(foo);
+  writer->FlushTo(cf);
+  writer->write(bar);
+  writer->FlushTo(cf);
+  cf->flush();
+  rewind(tmp);
+  char contents[16] = {0};
+  ASSERT_EQ(6, static_cast<int>(fread(contents, 1, sizeof(contents), tmp)));
+  ASSERT_EQ(0, strcmp("foobar", contents));
+  fclose(tmp);
+
   PASS();
 }
 
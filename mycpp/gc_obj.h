@@ -129,6 +129,16 @@ inline int ObjectId(void* obj) {
 // A RawObject* is like a void*. We use it to represent GC managed objects.
 struct RawObject;
 
+// The stack roots of one function call.  Frames are linked into a "shadow
+// stack", so entering and leaving a function is a pointer store, rather than
+// one PushRoot() and PopRoot() per local variable.  See StackRootFrame<N> in
+// gc_alloc.h.
+struct RootFrame {
+  RootFrame* prev_;
+  int n_;
+  RawObject*** roots_;  // n_ addresses of local variables
+};
+
 //
 // Compile-time computation of GC field masks.
 //
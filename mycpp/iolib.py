@@ -4,6 +4,9 @@ translated.
 """
 from __future__ import print_function
 
+import errno
+import fcntl
+import os
 import signal
 
 from typing import List, Any
@@ -32,7 +35,9 @@ class SignalSafe(object):
 
         This method is registered as a Python signal handler.
         """
-        self.pending_signals.append(sig_num)
+        # A signal that's already pending is coalesced, like the C++ ring
+        if sig_num not in self.pending_signals:
+            self.pending_signals.append(sig_num)
 
         if sig_num == signal.SIGINT:
             self.received_sigint = True
@@ -89,6 +94,32 @@ class SignalSafe(object):
         self.received_sigwinch = False
         return result
 
+    def HasPendingSignals(self):
+        # type: () -> bool
+        """Is a signal waiting for TakePendingSignals()?
+
+        Cheap enough to call in the inner loops of builtins.
+        """
+        return len(self.pending_signals) != 0
+
+    def PendingSignalForWait(self):
+        # type: () -> int
+        """Return a signal that should interrupt the 'wait' builtin, or 0.
+
+        The signal was received since the last TakePendingSignals(), e.g. after
+        the interpreter ran traps, but before 'wait' blocked in waitpid().
+        """
+        for sig_num in self.pending_signals:
+            if sig_num == signal.SIGINT and not self.sigint_trapped:
+                continue
+            if (sig_num == signal.SIGWINCH and
+                    self.sigwinch_code == UNTRAPPED_SIGWINCH):
+                continue
+            if sig_num == signal.SIGCHLD:  # like bash, the trap runs later
+                continue
+            return sig_num
+        return 0
+
     def TakePendingSignals(self):
         # type: () -> List[int]
         """Transfer ownership of queue of pending signals to caller."""
@@ -162,4 +193,96 @@ def sigaction(sig_num, handler):
     # SIGINT and SIGWINCH must be registered through SignalSafe
     assert sig_num != signal.SIGINT
     assert sig_num != signal.SIGWINCH
+
+    # e.g. 'trap - CHLD'.  If this process waits on the wakeup pipe, SIGCHLD
+    # must still write to it.  _OnSigChld() is otherwise like SIG_DFL, which
+    # ignores SIGCHLD.
+    if (sig_num == signal.SIGCHLD and handler == signal.SIG_DFL and
+            gWakeupPid == os.getpid()):
+        _InstallSigChld()
+        return
+
     signal.signal(sig_num, handler)
+
+
+def SignalIsIgnored(sig_num):
+    # type: (int) -> bool
+    """Is the signal ignored, e.g. because we were started with nohup?"""
+    return signal.getsignal(sig_num) == signal.SIG_IGN
+
+
+# Like _SHELL_MIN_FD in core/process.py
+_WAKEUP_MIN_FD = 100
+
+gWakeupReadFd = -1
+gWakeupPid = -1  # the process that opened the pipe
+
+
+def _OnSigChld(sig_num, unused_frame):
+    # type: (int, Any) -> None
+    pass  # signal.set_wakeup_fd() writes the byte
+
+
+def _InstallSigChld():
+    # type: () -> None
+    # Don't interrupt other system calls when a child exits
+    signal.signal(signal.SIGCHLD, _OnSigChld)
+    signal.siginterrupt(signal.SIGCHLD, False)
+
+
+def _MoveAboveUserFds(fd):
+    # type: (int) -> int
+    new_fd = fcntl.fcntl(fd, fcntl.F_DUPFD, _WAKEUP_MIN_FD)  # type: int
+    os.close(fd)
+    fcntl.fcntl(new_fd, fcntl.F_SETFD, fcntl.FD_CLOEXEC)
+    fcntl.fcntl(new_fd, fcntl.F_SETFL, os.O_NONBLOCK)
+    return new_fd
+
+
+def OpenWakeupFd():
+    # type: () -> int
+    """Return a descriptor that becomes readable when a signal arrives.
+
+    Our signal handlers write a byte to a pipe, and so does SIGCHLD, even when
+    it isn't trapped.  A loop can poll the read end, then call waitpid() with
+    WNOHANG, without missing a signal that arrives just before it blocks.
+
+    A forked child gets its own pipe the first time it calls this.
+    """
+    global gWakeupReadFd, gWakeupPid
+
+    pid = os.getpid()
+    if gWakeupPid == pid:
+        return gWakeupReadFd
+
+    r, w = os.pipe()
+    r = _MoveAboveUserFds(r)
+    w = _MoveAboveUserFds(w)
+
+    old_w = signal.set_wakeup_fd(w)
+    if gWakeupReadFd != -1:  # inherited from the parent
+        os.close(old_w)
+        os.close(gWakeupReadFd)
+    gWakeupReadFd = r
+    gWakeupPid = pid
+
+    # If CHLD is trapped, our handler already writes the byte, and the trap
+    # must still run
+    if (gSignalSafe is None or signal.getsignal(signal.SIGCHLD) !=
+            gSignalSafe.UpdateFromSignalHandler):
+        _InstallSigChld()
+
+    return r
+
+
+def DrainWakeupFd(fd):
+    # type: (int) -> None
+    """Read the bytes written by signals, so fd can be polled again."""
+    while True:
+        try:
+            if len(os.read(fd, 64)) == 0:
+                break
+        except OSError as e:
+            if e.errno == errno.EINTR:
+                continue
+            break  # EAGAIN: empty
@@ -253,10 +253,16 @@ int MarkSweepHeap::Collect() {
   int num_roots = roots_.size();
   int num_globals = global_roots_.size();
 
+  int num_frame_roots = 0;
+  for (RootFrame* f = frames_; f; f = f->prev_) {
+    num_frame_roots += f->n_;
+  }
+
   if (gc_verbose_) {
     log("");
     log("%2d. GC with %d roots (%d global) and %d live objects",
-        num_collections_, num_roots + num_globals, num_globals, num_live());
+        num_collections_, num_roots + num_frame_roots + num_globals,
+        num_globals, num_live());
   }
 
   // Resize it
@@ -275,6 +281,15 @@ int MarkSweepHeap::Collect() {
     }
   }
 
+  for (RootFrame* f = frames_; f; f = f->prev_) {
+    for (int i = 0; i < f->n_; ++i) {
+      RawObject* root = *(f->roots_[i]);
+      if (root) {
+        MaybeMarkAndPush(root);
+      }
+    }
+  }
+
   for (int i = 0; i < num_globals; ++i) {
     RawObject* root = global_roots_[i];
     if (root) {
@@ -412,6 +427,7 @@ void MarkSweepHeap::MaybePrintStats() {
 void MarkSweepHeap::FreeEverything() {
   roots_.clear();
   global_roots_.clear();
+  frames_ = nullptr;
 
   Collect();
 
@@ -263,6 +263,15 @@ class MarkSweepHeap {
     roots_.pop_back();
   }
 
+  void PushFrame(RootFrame* frame) {
+    frame->prev_ = frames_;
+    frames_ = frame;
+  }
+
+  void PopFrame(RootFrame* frame) {
+    frames_ = frame->prev_;
+  }
+
   void RootGlobalVar(void* root) {
     global_roots_.push_back(reinterpret_cast<RawObject*>(root));
   }
@@ -331,6 +340,7 @@ class MarkSweepHeap {
 
   std::vector<RawObject**> roots_;
   std::vector<RawObject*> global_roots_;
+  RootFrame* frames_ = nullptr;  // innermost function call
 
   // Allocate() appends live objects, and Sweep() compacts it
   std::vector<ObjHeader*> live_objs_;
@@ -82,6 +82,16 @@ def Options() -> optparse.OptionParser:
                  default=False,
                  help='Do NOT minimize the number of GC stack roots.')
 
+    p.add_option('--stack-roots-report',
+                 dest='stack_roots_report',
+                 default=None,
+                 help='Write a TSV file saying which variables are rooted')
+
+    p.add_option('--stack-alloc-report',
+                 dest='stack_alloc_report',
+                 default=None,
+                 help='Write a TSV file of list literals lowered to the stack')
+
     return p
 
 
@@ -280,7 +290,9 @@ def main(argv: List[str]) -> int:
                          preamble_path=opts.preamble_path,
                          stack_roots_warn=opts.stack_roots_warn,
                          minimize_stack_roots=minimize_stack_roots,
-                         facts_out_dir=opts.facts_out_dir)
+                         facts_out_dir=opts.facts_out_dir,
+                         stack_roots_report=opts.stack_roots_report,
+                         stack_alloc_report=opts.stack_alloc_report)
 
 
 if __name__ == '__main__':
@@ -208,10 +208,12 @@ class BufWriter(Writer):
     def __init__(self):
         # type: () -> None
         self.parts = []
+        self.length = 0
 
     def write(self, s):
         # type: (str) -> None
         self.parts.append(s)
+        self.length += len(s)
 
     def isatty(self):
         # type: () -> bool
@@ -221,14 +223,31 @@ class BufWriter(Writer):
         # type: (int) -> None
         """For JSON indenting.  Avoid intermediate allocations in C++."""
         self.parts.append(' ' * n)
+        self.length += n
 
     def getvalue(self):
         # type: () -> str
         return ''.join(self.parts)
 
+    def Length(self):
+        # type: () -> int
+        """Number of bytes written since the last clear()."""
+        return self.length
+
     def clear(self):
         # type: () -> None
         del self.parts[:]
+        self.length = 0
+
+    def FlushTo(self, f):
+        # type: (Writer) -> None
+        """Write what's been written to f, then clear().
+
+        Unlike getvalue() and clear(), the C++ buffer is kept for the next
+        writes.
+        """
+        f.write(''.join(self.parts))
+        self.clear()
 
     def close(self):
         # type: () -> None
@@ -149,6 +149,15 @@ class Virtual(object):
     def HasVTable(self, class_name: SymbolPath) -> bool:
         return class_name in self.has_vtable
 
+    def IsFinal(self, class_name: SymbolPath) -> bool:
+        """A class with a vtable, but no subclasses in the whole program.
+
+        Marking it 'final' lets the C++ compiler devirtualize calls through
+        pointers to it.
+        """
+        return (class_name in self.has_vtable and
+                not self.subclasses.get(class_name))
+
     def CanReorderFields(self, class_name: SymbolPath) -> bool:
         if class_name in self.can_reorder_fields:
             return self.can_reorder_fields[class_name]
@@ -539,6 +548,41 @@ class StackRoots(object):
         return (func, reference) in self.root_tuples
 
 
+class StackRootReport(object):
+    """
+    Which managed locals and loop variables got a stack root.
+    """
+
+    def __init__(self) -> None:
+        # (function, variable, rooted)
+        self.rows: List[Tuple[str, str, bool]] = []
+
+    def Add(self, func: str, var_name: str, rooted: bool) -> None:
+        self.rows.append((func, var_name, rooted))
+
+    def Summary(self) -> str:
+        num_rooted = sum(1 for _, _, rooted in self.rows if rooted)
+
+        funcs: Set[str] = set()
+        funcs_with_roots: Set[str] = set()
+        for func, _, rooted in self.rows:
+            funcs.add(func)
+            if rooted:
+                funcs_with_roots.add(func)
+
+        return ('rooted %d of %d managed variables (%d removed); '
+                '%d of %d functions have no roots' %
+                (num_rooted, len(self.rows), len(self.rows) - num_rooted,
+                 len(funcs) - len(funcs_with_roots), len(funcs)))
+
+    def Write(self, path: str) -> None:
+        with open(path, 'w') as f:
+            f.write('func\tvar\trooted\n')
+            for func, var_name, rooted in self.rows:
+                f.write('%s\t%s\t%s\n' %
+                        (func, var_name, 'T' if rooted else 'F'))
+
+
 def DumpControlFlowGraphs(cfgs: Dict[SymbolPath, ControlFlowGraph],
                           out_dir: str) -> None:
     """
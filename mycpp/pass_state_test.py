@@ -54,6 +54,10 @@ class VirtualTest(unittest.TestCase):
 
         self.assertEqual(False, v.HasVTable(('Klass', )))
 
+        self.assertEqual(False, v.IsFinal(('Base', )))
+        self.assertEqual(True, v.IsFinal(('Derived', )))
+        self.assertEqual(False, v.IsFinal(('Klass', )))
+
     def testNoInit(self):
         v = pass_state.Virtual()
         v.OnMethod(('Base', ), '__init__')
@@ -592,5 +596,18 @@ class ControlFlowGraphTest(unittest.TestCase):
         self.assertEqual(expected_edges, cfg.edges)
 
 
+class StackRootReportTest(unittest.TestCase):
+
+    def testSummary(self):
+        report = pass_state.StackRootReport()
+        report.Add('mod.f', 'x', True)
+        report.Add('mod.f', 'y', False)
+        report.Add('mod.g', 'z', False)
+
+        self.assertEqual(
+            'rooted 1 of 3 managed variables (2 removed); '
+            '1 of 2 functions have no roots', report.Summary())
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -16,11 +16,12 @@ from mycpp import const_pass
 from mycpp import cppgen_pass
 from mycpp import control_flow_pass
 from mycpp import conversion_pass
+from mycpp import escape_pass
 from mycpp import pass_state
 from mycpp.util import log
 from mycpp import visitor
 
-from typing import (Dict, List, Tuple, Any, TextIO, TYPE_CHECKING)
+from typing import (Dict, List, Optional, Tuple, Any, TextIO, TYPE_CHECKING)
 
 if TYPE_CHECKING:
     from mypy.nodes import FuncDef, MypyFile, Expression
@@ -69,6 +70,8 @@ def Run(
     stack_roots_warn: bool = False,
     minimize_stack_roots: bool = False,
     facts_out_dir: bool = None,
+    stack_roots_report: Optional[str] = None,
+    stack_alloc_report: Optional[str] = None,
 ) -> int:
 
     #_ = mtype
@@ -167,6 +170,22 @@ def Run(
         stack_roots = pass_state.ComputeMinimalStackRoots(
             cflow_graphs, souffle_dir)
 
+    # [PASS] Find list literals that can be C++ values
+    timer.Section('mycpp pass: ESCAPE')
+
+    stack_literals: escape_pass.StackLiterals = {}
+    escape_report: List[Tuple[str, int, str]] = []
+    for name, module in to_compile:
+        p_escape = escape_pass.Build(types, stack_literals, escape_report)
+        p_escape.visit_mypy_file(module)
+        MaybeExitWithErrors(p_escape)
+
+    if stack_alloc_report:
+        with open(stack_alloc_report, 'w') as report_f:
+            report_f.write('path\tline\tkind\n')
+            for path, line_num, kind in escape_report:
+                report_f.write('%s\t%d\t%s\n' % (path, line_num, kind))
+
     if facts_out_dir:
         timer.Section('mycpp: dumping control flow graph to %s' %
                       facts_out_dir)
@@ -197,6 +216,8 @@ def Run(
 
     timer.Section('mycpp pass: IMPL')
 
+    root_report = pass_state.StackRootReport()
+
     # [PASS] the definitions / implementations:
     # void Foo:method() { ... }
     # void Bar:method() { ... }
@@ -213,11 +234,19 @@ def Run(
             dot_exprs=dot_exprs[module.path],
             stack_roots=stack_roots,
             stack_roots_warn=stack_roots_warn,
+            root_report=root_report,
+            stack_literals=stack_literals,
         )
         p_impl.SetOutputFile(f)  # doesn't go to header
         p_impl.visit_mypy_file(module)
         MaybeExitWithErrors(p_impl)
 
+    timer.Section('mycpp stack roots: %s' % root_report.Summary())
+    timer.Section('mycpp stack allocation: %d list literals aren\'t allocated' %
+                  len(escape_report))
+    if stack_roots_report:
+        root_report.Write(stack_roots_report)
+
     timer.Section('mycpp DONE')
     return 0  # success
 
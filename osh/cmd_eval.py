@@ -1824,13 +1824,26 @@ class CommandEvaluator(object):
 
         We may run traps, check for Ctrl-C, or garbage collect.
         """
-        self.RunPendingTraps()
+        if self.signal_safe.HasPendingSignals():
+            self.RunPendingTraps()
         if self.signal_safe.PollUntrappedSigInt():
             raise KeyboardInterrupt()
 
         # Manual GC point before every statement
         mylib.MaybeCollect()
 
+    def PollSignals(self):
+        # type: () -> None
+        """Run traps, and check for Ctrl-C, if a signal is pending.
+
+        Builtins that loop without blocking, like 'read' on a big file, call
+        this, so traps aren't delayed until they return.
+        """
+        if self.signal_safe.HasPendingSignals():
+            self.RunPendingTraps()
+            if self.signal_safe.PollUntrappedSigInt():
+                raise KeyboardInterrupt()
+
     if 0:
 
         def _DispatchFast(self, node, cmd_st):
@@ -167,21 +167,19 @@ class Evaluator(object):
                 else:
                     prefix = val[1:]
 
-                out = None
-                for i in xrange(history_len, 1, -1):
-                    cmd = self.readline.get_history_item(i)
-                    if prefix is not None and cmd.startswith(prefix):
-                        out = cmd
-                    if len(substring) and substring in cmd:
-                        out = cmd
-                    if out is not None:
-                        # mycpp: rewrite of +=
-                        out = out + last_char  # restore required space
-                        break
-
-                if out is None:
+                # Readline searches without making a string per item
+                if prefix is not None:
+                    pos = self.readline.search_history(prefix, True)
+                else:
+                    pos = self.readline.search_history(substring, False)
+
+                if pos == -1:
                     raise util.HistoryError('%r found no results' % val)
 
+                # mycpp: rewrite of +=
+                out = self.readline.get_history_item(pos)
+                out = out + last_char  # restore required space
+
             else:
                 raise AssertionError(id_)
 
@@ -29,6 +29,13 @@ class _MockReadlineHistory(object):
         except IndexError:
             return None  # matches what readline does
 
+    def search_history(self, needle, prefix_only):
+        for i in xrange(len(self.items), 0, -1):
+            item = self.items[i - 1]
+            if item.startswith(needle) if prefix_only else needle in item:
+                return i
+        return -1
+
 
 def _MakeHistoryEvaluator(history_items):
     parse_ctx = test_lib.InitParseContext()
@@ -80,6 +87,10 @@ class HistoryEvaluatorTest(unittest.TestCase):
 
         self.assertEqual('echo /echo/', hist_ev.Eval('echo !$'))
 
+        # The oldest item is searched too
+        hist_ev = _MakeHistoryEvaluator(['cd /tmp', 'echo hi'])
+        self.assertEqual('cd /tmp ', hist_ev.Eval('!cd '))
+
     def testBug(self):
         hist_ev = _MakeHistoryEvaluator([
             'echo ${two:-}',
@@ -221,6 +221,31 @@ def FastStrEval(w):
             return None
 
 
+def LiteralArgStr(w):
+    # type: (CompoundWord) -> Optional[str]
+    """
+    Like FastStrEval(), but also for words made of several literal tokens,
+    like /usr/bin or a,b or 10.
+
+    Returns None if the word needs evaluation, e.g. globs, tildes, and brace
+    expansion.  Used to start pipeline parts with posix_spawn().
+    """
+    s = FastStrEval(w)
+    if s is not None:
+        return s
+
+    strs = []  # type: List[str]
+    for part in w.parts:
+        if part.tag() != word_part_e.Literal:
+            return None
+        tok = cast(Token, part)
+        if tok.id not in (Id.Lit_Chars, Id.Lit_Number, Id.Lit_Slash,
+                          Id.Lit_Comma, Id.Lit_Colon, Id.Lit_Other):
+            return None
+        strs.append(lexer.LazyStr(tok))
+    return ''.join(strs)
+
+
 def StaticEval(UP_w):
     # type: (word_t) -> Tuple[bool, str, bool]
     """Evaluate a Compound at PARSE TIME."""
@@ -171,6 +171,15 @@ class WordTest(unittest.TestCase):
         self.assertEqual('b', word_.FastStrEval(node.words[3]))
         self.assertEqual(']', word_.FastStrEval(node.words[4]))
 
+    def testLiteralArgStr(self):
+        node = assertParseSimpleCommand(
+            self, "sort -k 2,3 /usr/bin 'my dir' *.py ~/x {a,b} [ch] $x")
+
+        words = [word_.LiteralArgStr(w) for w in node.words]
+        self.assertEqual(
+            ['sort', '-k', '2,3', '/usr/bin', 'my dir', None, None, None,
+             None, None], words)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -11,8 +11,12 @@ from __future__ import print_function
 fanos_test.py: Tests for fanos.c
 """
 import errno
+import os
+import shutil
 import socket
+import stat
 import sys
+import tempfile
 import unittest
 
 from mycpp.mylib import log
@@ -197,6 +201,83 @@ class FanosTest(unittest.TestCase):
 
     right.close()
 
+  def testListenAccept(self):
+    print('\n___ fanos.listen ___')
+    tmp_dir = tempfile.mkdtemp()
+    path = os.path.join(tmp_dir, 'sock')
+
+    listen_fd = fanos.listen(path)
+
+    # Only our user can connect
+    self.assertEqual(0o600, stat.S_IMODE(os.stat(path).st_mode))
+
+    # Python 2's socket module connects, and our library accepts
+    client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    client.connect(path)
+    conn_fd = fanos.accept(listen_fd)
+
+    fanos.send(conn_fd, b'hi')
+    self.assertEqual('hi', netstring_recv(client))
+
+    client.send(netstring_encode('bye'))
+    self.assertEqual('bye', fanos.recv(conn_fd, []))
+
+    # Path already exists
+    try:
+      fanos.listen(path)
+    except IOError as e:
+      self.assertEqual(errno.EADDRINUSE, e.errno)
+    else:
+      self.fail('Expected IOError')
+
+    try:
+      fanos.listen('x' * 200)
+    except ValueError as e:
+      print(e)
+    else:
+      self.fail('Expected ValueError')
+
+    client.close()
+    os.close(conn_fd)
+    os.close(listen_fd)
+    shutil.rmtree(tmp_dir)
+
+  def testConnect(self):
+    print('\n___ fanos.connect ___')
+    tmp_dir = tempfile.mkdtemp()
+    path = os.path.join(tmp_dir, 'sock')
+
+    # Nothing is listening
+    try:
+      fanos.connect(path)
+    except IOError as e:
+      self.assertEqual(errno.ENOENT, e.errno)
+    else:
+      self.fail('Expected IOError')
+
+    listen_fd = fanos.listen(path)
+    sock_fd = fanos.connect(path)
+    conn_fd = fanos.accept(listen_fd)
+
+    # Pass our stdin, stdout, and stderr to the other end
+    fanos.send(sock_fd, b'hi', 0, 1, 2)
+    fd_out = []
+    self.assertEqual('hi', fanos.recv(conn_fd, fd_out))
+    self.assertEqual(3, len(fd_out))
+    for fd in fd_out:
+      self.assertNotEqual(-1, fd)
+
+    try:
+      fanos.connect('x' * 200)
+    except ValueError as e:
+      print(e)
+    else:
+      self.fail('Expected ValueError')
+
+    for fd in fd_out + [sock_fd, conn_fd, listen_fd]:
+      os.close(fd)
+    shutil.rmtree(tmp_dir)
+
 
 class InvalidMessageTests(unittest.TestCase):
   """COPIED from py_fanos_test.py."""
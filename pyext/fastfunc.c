@@ -67,17 +67,32 @@ func_PartIsUtf8(PyObject *self, PyObject *args) {
   assert(0 <= start);
   assert(end <= in.len);
 
-  Utf8Result_t result;
-  for (int i = start; i < end;) {
-    utf8_decode(in.data + i, &result);
-    if (result.error) {
-      return PyBool_FromLong(0);
-    }
-
-    i += result.bytes_read;
+  if (start >= end) {
+    return PyBool_FromLong(1);
   }
+  return PyBool_FromLong(utf8_is_valid(in.data + start, end - start));
+}
+
+static PyObject *
+func_FindPlainStrEnd(PyObject *self, PyObject *args) {
+  j8_buf_t in;
+  int start;
+  int double_quoted;
 
-  return PyBool_FromLong(1);
+  if (!PyArg_ParseTuple(args, "s#ii", &(in.data), &(in.len), &start,
+                        &double_quoted)) {
+    return NULL;
+  }
+  // Bounds check for safety
+  assert(0 <= start && start <= in.len);
+
+  unsigned char quote = double_quoted ? '"' : '\'';
+  unsigned char* in_end = in.data + in.len;
+  unsigned char* p = J8ScanPlainChars(in.data + start, in_end, quote);
+  if (p < in_end && *p == quote) {
+    return PyInt_FromLong(p - in.data);
+  }
+  return PyInt_FromLong(-1);
 }
 
 static PyObject *
@@ -122,6 +137,7 @@ static PyMethodDef methods[] = {
   {"J8EncodeString", func_J8EncodeString, METH_VARARGS, ""},
   {"ShellEncodeString", func_ShellEncodeString, METH_VARARGS, ""},
   {"PartIsUtf8", func_PartIsUtf8, METH_VARARGS, ""},
+  {"FindPlainStrEnd", func_FindPlainStrEnd, METH_VARARGS, ""},
   {"Utf8DecodeOne", func_Utf8DecodeOne, METH_VARARGS, ""},
   {"CanOmitQuotes", func_CanOmitQuotes, METH_VARARGS, ""},
 
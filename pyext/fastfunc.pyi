@@ -6,6 +6,8 @@ def ShellEncodeString(s: str, ysh_fallback: int) -> str: ...
 
 def PartIsUtf8(s: str, start: int, end: int) -> bool: ...
 
+def FindPlainStrEnd(s: str, start: int, double_quoted: bool) -> int: ...
+
 def Utf8DecodeOne(s: str, start: int) -> Tuple[int, int]: ...
 
 def CanOmitQuotes(s: str) -> bool: ...
@@ -39,6 +39,28 @@ class FastfuncTest(unittest.TestCase):
     self.assertEqual(True, fastfunc.PartIsUtf8(s, 0, 3))
     self.assertEqual(False, fastfunc.PartIsUtf8(s, 3, 4))
 
+  def testFindPlainStrEnd(self):
+    s = '"hello world"'
+    self.assertEqual(12, fastfunc.FindPlainStrEnd(s, 1, True))
+
+    # Long enough to exercise the word-at-a-time loop
+    s = '"%s"' % ('x' * 20)
+    self.assertEqual(21, fastfunc.FindPlainStrEnd(s, 1, True))
+
+    # UTF-8 is plain, but escapes, control chars, and invalid UTF-8 aren't
+    mu = u'\u03bc'.encode('utf-8')
+    self.assertEqual(9, fastfunc.FindPlainStrEnd('"' + mu + 'abcdef"', 1, True))
+    self.assertEqual(-1, fastfunc.FindPlainStrEnd(r'"a\nb"', 1, True))
+    self.assertEqual(-1, fastfunc.FindPlainStrEnd('"a\nb"', 1, True))
+    self.assertEqual(-1, fastfunc.FindPlainStrEnd('"a \xff"', 1, True))
+
+    # Unterminated
+    self.assertEqual(-1, fastfunc.FindPlainStrEnd('"abc', 1, True))
+
+    # b'' and u'' strings end with single quote, and can contain "
+    self.assertEqual(4, fastfunc.FindPlainStrEnd("b'\"x'", 2, False))
+    self.assertEqual(-1, fastfunc.FindPlainStrEnd("b'x", 2, False))
+
   def testUtf8Decode(self):
     # interface is:
     #  def Utf8DecodeOne(s: str, start: int) -> (codepoint_or_error: int, bytes_read: int)
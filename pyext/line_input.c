@@ -650,6 +650,49 @@ PyDoc_STRVAR(doc_get_history_item,
 return the current contents of history item at index.");
 
 
+/* Added for OSH.  Search history from the newest item to the oldest, without
+ * making a string for each item. */
+
+static PyObject *
+search_history(PyObject *self, PyObject *args)
+{
+    char *needle;
+    int prefix_only;
+    int length;
+    int i;
+    size_t n;
+    HIST_ENTRY *hist_ent;
+
+    if (!PyArg_ParseTuple(args, "si:search_history", &needle, &prefix_only))
+        return NULL;
+
+    length = _py_get_history_length();
+    n = strlen(needle);
+    for (i = length; i >= 1; --i) {
+        int idx = i;
+#ifdef  __APPLE__
+        if (using_libedit_emulation) {
+            idx = i - 1 + libedit_history_start;  /* like get_history_item() */
+        }
+#endif /* __APPLE__ */
+        hist_ent = history_get(idx);
+        if (hist_ent == NULL) {
+            continue;
+        }
+        if (prefix_only ? strncmp(hist_ent->line, needle, n) == 0
+                        : strstr(hist_ent->line, needle) != NULL) {
+            return PyInt_FromLong((long)i);
+        }
+    }
+    return PyInt_FromLong(-1L);
+}
+
+PyDoc_STRVAR(doc_search_history,
+"search_history(needle, prefix_only) -> int\n\
+return the index of the newest history item that starts with or contains\n\
+needle, or -1.");
+
+
 /* Exported function to get current length of history */
 
 static PyObject *
@@ -1281,6 +1324,8 @@ static struct PyMethodDef readline_methods[] = {
      METH_VARARGS, doc_write_history_file},
     {"get_history_item", get_history_item,
      METH_VARARGS, doc_get_history_item},
+    {"search_history", search_history,
+     METH_VARARGS, doc_search_history},
     {"get_current_history_length", (PyCFunction)get_current_history_length,
      METH_NOARGS, doc_get_current_history_length},
     {"set_history_length", set_history_length,
@@ -27,6 +27,8 @@ def clear_history() -> None: ...
 
 def get_history_item(pos: int) -> str: ...
 
+def search_history(needle: str, prefix_only: bool) -> int: ...
+
 def remove_history_item(pos: int) -> None: ...
 
 def get_current_history_length() -> int: ...
@@ -22,6 +22,19 @@ class LineInputTest(unittest.TestCase):
   def testMatchOshToken(self):
     print(dir(line_input))
 
+  def testSearchHistory(self):
+    line_input.clear_history()
+    for line in ['echo one', 'ls /tmp', 'echo two']:
+      line_input.add_history(line)
+
+    self.assertEqual(3, line_input.search_history('echo', True))
+    self.assertEqual(2, line_input.search_history('ls', True))
+    self.assertEqual(1, line_input.search_history('one', False))
+    self.assertEqual(-1, line_input.search_history('one', True))
+    self.assertEqual(-1, line_input.search_history('zzz', False))
+
+    line_input.clear_history()
+
 
 if __name__ == '__main__':
   unittest.main()
@@ -121,6 +121,10 @@ def fdatasync(fd: int) -> None: ...
 def fdopen(fd: int, mode: str = ..., bufsize: int = ...) -> IO[str]: ...
 def fork() -> int:
     raise OSError()
+def posix_spawn(path: str, argv: List[str], env: Dict[str, str],
+                fds: List[int], new_fds: List[int], pgid: int,
+                default_sigs: List[int]) -> int:
+    raise OSError()
 def forkpty() -> Tuple[int, int]:
     raise OSError()
 def fpathconf(fd: int, name: str) -> None: ...
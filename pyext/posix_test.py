@@ -28,6 +28,7 @@ Other notes:
 """
 from __future__ import print_function
 
+import errno
 import signal
 import subprocess
 import unittest
@@ -132,6 +133,26 @@ class PosixTest(unittest.TestCase):
       log('Hanging on waitpid in pid %d', posix_.getpid())
       posix_.waitpid(-1, 0)
 
+  def testPosixSpawn(self):
+    r, w = posix_.pipe()
+    # stdout to the pipe, then close both ends
+    pid = posix_.posix_spawn('/bin/sh', ['sh', '-c', 'echo $X'],
+                             {'X': 'hi'}, [w, r, w], [1, -1, -1], 0,
+                             [signal.SIGPIPE])
+    posix_.close(w)
+    self.assertEqual('hi\n', posix_.read(r, 100))
+    posix_.close(r)
+
+    self.assertEqual(pid, posix_.waitpid(pid, 0)[0])
+
+    # exec() errors are reported to the parent
+    try:
+      posix_.posix_spawn('/nonexistent', ['x'], {}, [], [], -1, [])
+    except OSError as e:
+      self.assertEqual(errno.ENOENT, e.errno)
+    else:
+      self.fail('Expected ENOENT')
+
   def testWrite(self):
     if posix_.environ.get('EINTR_TEST'):
 
@@ -176,9 +197,18 @@ class PosixTest(unittest.TestCase):
       log('2: done')
 
   def testFcntl(self):
+      import fcntl
       from posix_ import F_DUPFD_CLOEXEC
       print(F_DUPFD_CLOEXEC)
 
+      r, w = posix_.pipe()
+      fd = fcntl.fcntl(r, F_DUPFD_CLOEXEC, 10)
+      self.assert_(fd >= 10, fd)
+      self.assertEqual(fcntl.FD_CLOEXEC,
+                       fcntl.fcntl(fd, fcntl.F_GETFD) & fcntl.FD_CLOEXEC)
+      for fd in (r, w, fd):
+        posix_.close(fd)
+
 
 def _Handler(x, y):
   log('Got signal %s %s', x, y)
@@ -48,6 +48,8 @@ corresponding Unix manual entries for more information on calls.");
 #include <signal.h>
 #endif
 
+#include <spawn.h>  /* OILS patch: posix_spawn() */
+
 #ifdef HAVE_FCNTL_H
 #include <fcntl.h>
 #endif /* HAVE_FCNTL_H */
@@ -1264,6 +1266,166 @@ posix_execve(PyObject *self, PyObject *args)
 }
 #endif /* HAVE_EXECV */
 
+/* OILS patch: posix_spawn() starts a process without copying the page tables
+ * of the shell's heap, like vfork().
+ *
+ * posix_spawn(path, argv, env, fds, new_fds, pgid, default_sigs) -> pid
+ *
+ * Before exec, the child does dup2(fds[i], new_fds[i]), or close(fds[i]) if
+ * new_fds[i] is -1.  If pgid isn't -1, it calls setpgid(0, pgid).  And the
+ * signals in default_sigs get SIG_DFL.
+ */
+
+static int
+list_to_ints(PyObject *list, int **out, Py_ssize_t *n)
+{
+    Py_ssize_t i;
+    if (!PyList_Check(list)) {
+        PyErr_SetString(PyExc_TypeError, "posix_spawn() expected a list");
+        return 0;
+    }
+    *n = PyList_Size(list);
+    *out = PyMem_NEW(int, *n + 1);
+    if (*out == NULL) {
+        PyErr_NoMemory();
+        return 0;
+    }
+    for (i = 0; i < *n; i++) {
+        long v = PyInt_AsLong(PyList_GetItem(list, i));
+        if (v == -1 && PyErr_Occurred()) {
+            PyMem_DEL(*out);
+            return 0;
+        }
+        (*out)[i] = (int)v;
+    }
+    return 1;
+}
+
+static PyObject *
+posix_posix_spawn(PyObject *self, PyObject *args)
+{
+    char *path;
+    PyObject *argv, *env, *fds_list, *new_fds_list, *sigs_list;
+    int pgid;
+    char **argvlist = NULL;
+    char **envlist = NULL;
+    int *fds = NULL, *new_fds = NULL, *sigs = NULL;
+    Py_ssize_t argc = 0, envc = 0, nfds = 0, n_new_fds = 0, nsigs = 0;
+    Py_ssize_t i, pos;
+    PyObject *key, *val;
+    PyObject *result = NULL;
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    sigset_t default_set;
+    short flags = 0;
+    pid_t pid;
+    int ret;
+
+    if (!PyArg_ParseTuple(args, "sO!O!O!O!iO!:posix_spawn", &path,
+                          &PyList_Type, &argv, &PyDict_Type, &env,
+                          &PyList_Type, &fds_list, &PyList_Type, &new_fds_list,
+                          &pgid, &PyList_Type, &sigs_list))
+        return NULL;
+
+    if (!list_to_ints(fds_list, &fds, &nfds))
+        goto done;
+    if (!list_to_ints(new_fds_list, &new_fds, &n_new_fds))
+        goto done;
+    if (!list_to_ints(sigs_list, &sigs, &nsigs))
+        goto done;
+    if (nfds != n_new_fds) {
+        PyErr_SetString(PyExc_ValueError,
+                        "posix_spawn() fds and new_fds differ in length");
+        goto done;
+    }
+
+    argc = PyList_Size(argv);
+    argvlist = PyMem_NEW(char *, argc + 1);
+    if (argvlist == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    for (i = 0; i < argc; i++) {
+        argvlist[i] = PyString_AsString(PyList_GetItem(argv, i));
+        if (argvlist[i] == NULL)
+            goto done;
+    }
+    argvlist[argc] = NULL;
+
+    envlist = PyMem_NEW(char *, PyDict_Size(env) + 1);
+    if (envlist == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    pos = 0;
+    while (PyDict_Next(env, &pos, &key, &val)) {
+        char *k = PyString_AsString(key);
+        char *v = PyString_AsString(val);
+        size_t len;
+        if (k == NULL || v == NULL)
+            goto done;
+        len = PyString_Size(key) + PyString_Size(val) + 2;
+        envlist[envc] = PyMem_NEW(char, len);
+        if (envlist[envc] == NULL) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        PyOS_snprintf(envlist[envc], len, "%s=%s", k, v);
+        envc++;
+    }
+    envlist[envc] = NULL;
+
+    posix_spawn_file_actions_init(&actions);
+    for (i = 0; i < nfds; i++) {
+        if (new_fds[i] == -1) {
+            posix_spawn_file_actions_addclose(&actions, fds[i]);
+        } else {
+            posix_spawn_file_actions_adddup2(&actions, fds[i], new_fds[i]);
+        }
+    }
+
+    posix_spawnattr_init(&attr);
+    if (pgid != -1) {
+        flags |= POSIX_SPAWN_SETPGROUP;
+        posix_spawnattr_setpgroup(&attr, pgid);
+    }
+    sigemptyset(&default_set);
+    for (i = 0; i < nsigs; i++) {
+        sigaddset(&default_set, sigs[i]);
+    }
+    flags |= POSIX_SPAWN_SETSIGDEF;
+    posix_spawnattr_setsigdefault(&attr, &default_set);
+    posix_spawnattr_setflags(&attr, flags);
+
+    ret = posix_spawn(&pid, path, &actions, &attr, argvlist, envlist);
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (ret != 0) {
+        errno = ret;
+        posix_error();
+        goto done;
+    }
+    result = PyInt_FromLong(pid);
+
+  done:
+    if (envlist != NULL) {
+        while (--envc >= 0)
+            PyMem_DEL(envlist[envc]);
+        PyMem_DEL(envlist);
+    }
+    if (argvlist != NULL)
+        PyMem_DEL(argvlist);
+    if (fds != NULL)
+        PyMem_DEL(fds);
+    if (new_fds != NULL)
+        PyMem_DEL(new_fds);
+    if (sigs != NULL)
+        PyMem_DEL(sigs);
+    return result;
+}
+
 #ifdef HAVE_FORK
 PyDoc_STRVAR_remove(posix_fork__doc__,
 "fork() -> pid\n\n\
@@ -2567,6 +2729,7 @@ static PyMethodDef posix_methods[] = {
   {"execv", posix_execv, METH_VARARGS},
   {"execve", posix_execve, METH_VARARGS},
   {"fork", posix_fork, METH_NOARGS},
+  {"posix_spawn", posix_posix_spawn, METH_VARARGS},
   {"getegid", posix_getegid, METH_NOARGS},
   {"geteuid", posix_geteuid, METH_NOARGS},
   {"getpid", posix_getpid, METH_NOARGS},
@@ -2705,7 +2868,7 @@ all_ins(PyObject *d)
      * module.
      */
 #ifdef F_DUPFD_CLOEXEC
-    if (ins(d, "F_DUPFD_CLOEXEC", (long)W_OK)) return -1;
+    if (ins(d, "F_DUPFD_CLOEXEC", (long)F_DUPFD_CLOEXEC)) return -1;
 #endif
 
     return 0;
@@ -655,3 +655,36 @@ after=1
 
 ## N-I dash/mksh/ash STDOUT:
 ## END
+
+#### trap CHLD set before 'wait' runs once per child
+trap 'echo fired' CHLD
+
+sleep 0.1 &
+wait
+echo status=$?
+
+sleep 0.1 &
+wait
+echo status=$?
+
+## STDOUT:
+fired
+status=0
+fired
+status=0
+## END
+
+#### 'trap - CHLD' after 'wait' doesn't hang the next 'wait'
+sleep 0.1 &
+wait
+
+trap 'echo x' CHLD
+trap - CHLD
+
+sleep 0.1 &
+wait
+echo status=$?
+
+## STDOUT:
+status=0
+## END
@@ -275,3 +275,39 @@ status=1
 
 ## N-I dash STDOUT:
 ## END
+
+#### External commands with literal words in a pipeline
+cd $TMP
+printf 'echo no-shebang\n' > no-shebang.sh
+chmod +x no-shebang.sh
+
+seq 3 | sort -r -n | head -n 2
+echo "${PIPESTATUS[@]}"
+
+./no-shebang.sh | tr a-z A-Z
+nonexistent-command 2>/dev/null | cat
+echo "${PIPESTATUS[@]}"
+
+# functions shadow external commands
+sort() { echo func; }
+seq 3 | sort | cat
+unset -f sort
+
+# Pipeline parts don't add to the hash table
+hash -r
+env | true
+echo hashed=$(hash | grep -c env)
+## STDOUT:
+3
+2
+0 0 0
+NO-SHEBANG
+127 0
+func
+hashed=0
+## END
+## N-I dash status: 2
+## N-I dash STDOUT:
+3
+2
+## END
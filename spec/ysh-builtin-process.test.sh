@@ -83,3 +83,165 @@ hi
 status=42
 ok
 ## END
+
+#### fork --jobs runs the block for each item
+shopt --set ysh:upgrade
+shopt --unset errexit
+
+fork --jobs 2 (:|a b c d|) {
+  echo "item $1"
+} | sort
+echo status=$?
+
+# all jobs were waited for
+fork --jobs 1 (:|e f|) {
+  echo "item $1"
+}
+jobs
+wait -n
+echo wait=$?
+
+fork --jobs 3 ([1, 2, 3]) {
+  exit $1
+}
+echo status=$?
+
+## STDOUT:
+item a
+item b
+item c
+item d
+status=0
+item e
+item f
+wait=127
+status=1
+## END
+
+#### fork --jobs runs at most N jobs at once
+shopt --set ysh:upgrade
+
+# Each job logs + when it starts, and - before it exits
+rm -f jobs.log
+fork --jobs 2 (:|a b c d e f|) {
+  echo + >> jobs.log
+  sleep 0.1
+  echo - >> jobs.log
+}
+echo status=$?
+
+awk '/[+]/ { n++; if (n > max) max = n } /-/ { n-- }
+     END { print "lines=" NR " max=" max }' jobs.log
+
+## STDOUT:
+status=0
+lines=12 max=2
+## END
+
+#### fork --jobs collects statuses and stdout, in item order
+shopt --set ysh:upgrade
+shopt --unset errexit
+
+var results
+fork --jobs 2 --capture-stdout (:|3 1 2|, &results) {
+  sleep 0.0$1
+  echo "slept $1"
+  exit $1
+}
+echo status=$?
+json write (results)
+
+## STDOUT:
+status=1
+[
+  {
+    "status": 3,
+    "stdout": "slept 3\n"
+  },
+  {
+    "status": 1,
+    "stdout": "slept 1\n"
+  },
+  {
+    "status": 2,
+    "stdout": "slept 2\n"
+  }
+]
+## END
+
+#### fork --jobs is interrupted by a trap, even if a job closed its stdout
+shopt --set ysh:upgrade
+shopt --unset errexit
+
+trap 'echo usr1' USR1
+sh -c "sleep 0.2; kill -USR1 $$" &
+
+# The job is still running at EOF, so we don't block until it exits
+fork --jobs 2 --capture-stdout (:|a|, &results) {
+  exec >&- 2>&-
+  sleep 3
+}
+echo status=$?
+
+## STDOUT:
+usr1
+status=138
+## END
+
+#### fork --jobs cleans up other jobs that exit, like wait
+shopt --set ysh:upgrade
+
+sleep 0.01 &
+fork --jobs 1 (:|a|) {
+  sleep 0.3
+}
+echo status=$?
+
+jobs
+wait
+echo wait=$?
+
+## STDOUT:
+status=0
+wait=0
+## END
+
+#### fork --jobs usage errors
+shopt --set ysh:upgrade
+shopt --unset errexit
+
+fork --jobs 0 (:|a|) {
+  echo hi
+}
+echo status=$?
+
+# -1 isn't the same as not passing --jobs
+fork --jobs -1 (:|a|) {
+  echo hi
+}
+echo status=$?
+
+try {
+  fork --jobs 2 {
+    echo hi
+  }
+}
+echo status=$[_error.code]
+
+fork --capture-stdout {
+  echo hi
+}
+echo status=$?
+
+fork --jobs 2 --capture-stdout (:|a|) {
+  echo hi
+}
+echo status=$?
+
+## STDOUT:
+status=2
+status=2
+status=3
+status=2
+status=2
+## END
@@ -1,4 +1,5 @@
 ## oils_failures_allowed: 1
+## oils_cpp_failures_allowed: 2
 ## tags: dev-minimal
 
 #### usage errors
@@ -72,6 +73,28 @@ json write (mydict, space=4)
 }
 ## END
 
+#### json write --compact is like space=0, and streams big values
+shopt --set ysh:upgrade
+
+var mydict = {name: "bob", age: 30, ratio: 1.5, tags: ['a', 'b']}
+json write --compact (mydict)
+json8 write --compact (mydict)
+
+# big enough to be flushed in several chunks
+var big = []
+for i in (0 ..< 2000) {
+  call big->append({i: i, s: "item $i", f: i / 4})
+}
+var s1 = $(json write --compact (big))
+var s2 = $(json write (big, space=0))
+echo $[len(s1) > 10000] $[s1 === s2]
+
+## STDOUT:
+{"name":"bob","age":30,"ratio":1.5,"tags":["a","b"]}
+{"name":"bob","age":30,"ratio":1.5,"tags":["a","b"]}
+true true
+## END
+
 #### json write in command sub
 shopt -s oil:all  # for echo
 var mydict = {name: "bob", age: 30}
@@ -202,6 +225,152 @@ num bracket 1
 obj bracket 1
 ## END
 
+#### json read --stream runs block for each line
+shopt --set parse_brace
+
+printf '{"a": 1}\n\n[2, "x"]\n  "s"  \n' | json read --stream (&x) {
+  pp test_ (x)
+}
+echo status=$?
+
+printf '42\n[\n' | json read --stream (&x) {
+  echo $[x]
+}
+echo status=$?
+
+## STDOUT:
+(Dict)   {"a":1}
+(List)   [2,"x"]
+(Str)   "s"
+status=0
+42
+status=1
+## END
+
+#### json read --stream sets _reply by default
+shopt --set parse_brace
+
+printf '[1]\n{"b": 2}\n' | json read --stream {
+  pp test_ (_reply)
+}
+echo status=$?
+
+## STDOUT:
+(List)   [1]
+(Dict)   {"b":2}
+status=0
+## END
+
+#### json8 read --stream accepts J8 strings, and requires a block
+shopt --set parse_brace
+
+printf "b'\\yff'\nu'hi'\n" | json8 read --stream (&x) {
+  pp test_ (x)
+}
+
+json read --stream (&x)
+echo status=$?
+
+## STDOUT:
+(Str)   b'\yff'
+(Str)   "hi"
+status=2
+## END
+
+#### json read with path= selects one value
+shopt --set parse_proc
+
+var doc = '{"items": [{"name": "a"}, {"name": "b", "tags": [1, 2]}], "n": 3}'
+
+echo $doc | json read (&x, path=['items', 1, 'tags'])
+pp test_ (x)
+
+echo $doc | json read (&x, path=['n'])
+pp test_ (x)
+
+echo $doc | json read (&x, path=['items', 5])
+echo status=$?
+
+# the rest of the document is still validated
+echo '{"a": 1, "b": [}' | json read (&x, path=['a'])
+echo status=$?
+
+json read (&x, path=[1.5]) < /dev/null
+echo status=$?
+
+## STDOUT:
+(List)   [1,2]
+(Int)   3
+status=1
+status=1
+## END
+## status: 3
+
+#### json read with path= rejects negative indices, and big ones are out of range
+shopt --set parse_proc
+
+echo '[1, 2, 3]' | json read (&x, path=[0])
+pp test_ (x)
+
+# Out of range, not truncated to a negative int
+echo '[1, 2, 3]' | json read (&x, path=[1 << 32])
+echo status=$?
+
+# The input isn't buffered, so the end of the array isn't known in advance
+echo '[1, 2, 3]' | json read (&x, path=[-1])
+echo status=$?
+
+## STDOUT:
+(Int)   1
+status=1
+status=3
+## END
+
+#### json8 write --binary and read --binary round trip
+shopt --set parse_proc
+
+var d = {name: 'bob', age: 42, ratio: 0.1, ok: true, none: null,
+         bytes: b'\yff\y00', items: [1, [2, {}], []]}
+
+json8 write --binary (d) > bin.tmp
+json8 read --binary (&x) < bin.tmp
+json8 write (x, space=0)
+
+# no newline, and the tag bytes are printable
+json8 write --binary ('hi') | od -A n -c
+
+# bad input
+echo 'not binary' | json8 read --binary (&x)
+echo status=$?
+
+# only json8
+json write --binary (d)
+echo status=$?
+
+## STDOUT:
+{"name":"bob","age":42,"ratio":0.1,"ok":true,"none":null,"bytes":b'\yff\u{0}',"items":[1,[2,{}],[]]}
+   s 002   h   i
+status=1
+status=2
+## END
+
+#### json8 write --binary rejects an Int that doesn't fit in 8 bytes
+shopt --set parse_proc
+
+# Python ints don't overflow.  (In C++, 2 ** 70 wraps around first, so this
+# case is an allowed failure there.)
+json8 write --binary (2 ** 70) > big.tmp
+echo status=$?
+wc -c < big.tmp
+
+json8 write --binary (-(2 ** 63)) | wc -c
+
+## STDOUT:
+status=1
+0
+9
+## END
+
 #### json write expression
 json write ([1,2,3], space=0)
 echo status=$?
@@ -694,6 +863,80 @@ pp test_ (fromJson(m2))  # fails
 (List)   [42,1.5,null,true,"hi",""]
 ## END
 
+#### toTsv8() fromTsv8()
+shopt -s ysh:upgrade
+
+var d = {name: ['alice', 'a b', ''], age: [44, null, 2], ok: [true, false, true]}
+var s = toTsv8(d)
+write -- $s
+
+var t = fromTsv8(s)
+= t
+echo len=$[len(t)]
+pp test_ (t => columns())
+pp test_ (t => column('age'))
+assert [d === t => toDict()]
+assert [s === toTsv8(t)]
+
+# Without !type, every column is Str
+pp test_ (fromTsv8(b'!tsv8\tx\n\t1\n\tnull\n') => toDict())
+
+## STDOUT:
+!tsv8	name	age	ok
+!type	Str	Int	Bool
+	alice	44	true
+	"a b"	null	false
+	""	2	true
+
+(Table name:Str age:Int ok:Bool rows=3)
+len=3
+(List)   ["name","age","ok"]
+(List)   [44,null,2]
+(Dict)   {"x":["1",null]}
+## END
+
+#### Table filter() sortBy() groupCount()
+shopt -s ysh:upgrade
+
+var d = {name: ['bob', 'alice', 'bob', 'carol'], age: [30, 44, null, 25],
+         score: [1.5, null, 0.5, 2.0]}
+var t = fromTsv8(toTsv8(d))
+
+# Null cells don't match
+pp test_ (t => filter('age', '>', 26) => column('name'))
+pp test_ (t => filter('name', '==', 'bob') => column('age'))
+# An Int can be compared with a Float column
+pp test_ (t => filter('score', '>=', 1) => column('score'))
+
+# Stable, and nulls are last
+pp test_ (t => sortBy('age') => column('age'))
+pp test_ (t => sortBy('age', reverse=true) => column('age'))
+pp test_ (t => sortBy('name') => column('age'))
+
+pp test_ (t => groupCount('name') => toDict())
+
+# A Table with no rows is false, like an empty List
+var none = t => filter('age', '>', 100)
+if (none) { echo yes } else { echo no len=$[len(none)] }
+
+try { call t => filter('age', '>', 'x') }
+echo code=$[_error.code]
+try { call t => filter('age', '=~', 1) }
+echo code=$[_error.code]
+
+## STDOUT:
+(List)   ["bob","alice"]
+(List)   [30,null]
+(List)   [1.5,2.0]
+(List)   [25,30,44,null]
+(List)   [44,30,25,null]
+(List)   [44,30,null,25]
+(Dict)   {"name":["alice","bob","carol"],"count":[1,2,1]}
+no len=0
+code=3
+code=3
+## END
+
 #### User can handle errors - toJson() toJson8()
 shopt -s ysh:upgrade
 
@@ -758,6 +1001,37 @@ positions 1 - 2
 ## END
 
 
+#### User can handle errors - toTsv8() fromTsv8()
+shopt -s ysh:upgrade
+
+try {
+  call toTsv8({x: [1, 'a']})
+}
+echo status=$_status
+echo "$[_error.message]"
+
+try {
+  call fromTsv8(b'!tsv8\tx\n!type\tInt\n\tz\n')
+}
+echo status=$_status
+echo "$[_error.message]"
+echo $[_error.start_pos] $[_error.end_pos]
+
+var t = fromTsv8(b'!tsv8\tx\n\t1\n')
+try {
+  call t => column('y')
+}
+echo status=$_status
+
+## STDOUT:
+status=4
+Column 'x' has cells of type Int and Str
+status=4
+Invalid Int cell (line 3, offset 19-20: 'nt\n\tz\n')
+19 20
+status=3
+## END
+
 #### ASCII control chars can't appear literally in messages
 shopt -s ysh:upgrade
 
@@ -386,6 +386,10 @@ def ToBool(val):
             val = cast(value.Dict, UP_val)
             return len(val.d) > 0
 
+        elif case(value_e.Table):
+            val = cast(value.Table, UP_val)
+            return val.num_rows > 0  # like len(t)
+
         else:
             return True  # all other types are Truthy
 